@@ -1,5 +1,45 @@
+// Heatmap cell format, must match the RTSA fragment shader:
+// RTSA_PACKED - intensity and age as 16-bit normalized values packed in uint (unpackUnorm2x16),
+// otherwise float2.
+#ifdef RTSA_PACKED
+typedef uint HeatmapCell;
+#else
+typedef float2 HeatmapCell;
+#endif
+
+// Dummy defines for source editor (not used in runtime):
+#ifndef DIRTY_TILE_CELL_COUNT
+#define DIRTY_TILE_CELL_COUNT 1024
+#endif
+
+// Stores the cell if it has changed and marks its tile of DIRTY_TILE_CELL_COUNT cells as dirty,
+// so only the changed tiles are transferred to the destination.
+void storeCell(__global HeatmapCell* heatmap,
+               __global uchar* dirtyTiles,
+               uint cellIndex,
+               float intensity,
+               float age)
+{
+#ifdef RTSA_PACKED
+    const uint packedIntensity = (uint)rint(clamp(intensity, 0.0f, 1.0f) * 65535.0f);
+    const uint packedAge = (uint)rint(clamp(age, 0.0f, 1.0f) * 65535.0f);
+    const HeatmapCell cell = packedIntensity | (packedAge << 16);
+    const bool isChanged = cell != heatmap[cellIndex];
+#else
+    const HeatmapCell cell = (float2)(intensity, age);
+    const bool isChanged = any(cell != heatmap[cellIndex]);
+#endif
+
+    if (isChanged)
+    {
+        heatmap[cellIndex] = cell;
+        dirtyTiles[cellIndex / DIRTY_TILE_CELL_COUNT] = 1;
+    }
+}
+
 __kernel void convertToDBFS(
-	__global float* magnitudes,
+	__global const float* magnitudes,
+	__global float* dbfsValues,
 	float referenceValue
 	)
 {
@@ -10,11 +50,12 @@ __kernel void convertToDBFS(
     {
         dbfs = -10000.0f;
     }
-    magnitudes[globalId] = dbfs;
+    dbfsValues[globalId] = dbfs;
 }
 
 __kernel void updateDensityHeatmap(
-   __global float2* heatmap,
+   __global HeatmapCell* heatmap,
+   __global uchar* dirtyTiles,
    __global float* dbfsHistoryBuffer,
    uint heatmapWidth,
    uint heatmapHeight,
@@ -59,6 +100,315 @@ __kernel void updateDensityHeatmap(
     }
     
     uint heatmapCellIndex = frequencyIndex * heatmapHeight + magnitudeCellIndex;
-    heatmap[heatmapCellIndex].x = dbfsIntensity / (float)historyBufferCount;
-    heatmap[heatmapCellIndex].y = (dbfsAge / (float)historyBufferCount) / (float)historyBufferCount;
+    storeCell(heatmap,
+              dirtyTiles,
+              heatmapCellIndex,
+              dbfsIntensity / (float)historyBufferCount,
+              (dbfsAge / (float)historyBufferCount) / (float)historyBufferCount);
+}
+
+// Incremental mode: hit counts and sums of insertion timestamps of every heatmap cell are kept
+// between updates, so an update touches only the cells hit by the newest and the evicted frame.
+
+bool isCellHit(uint magnitudeCellIndex, float dbfsValue, float magnitudeIndexToDbfsCoeff)
+{
+    // must be the same predicate as in updateDensityHeatmap
+    const float cellDbfs = -((float)magnitudeCellIndex) * magnitudeIndexToDbfsCoeff;
+    return (cellDbfs * 0.95f > dbfsValue) && (cellDbfs * 1.05f < dbfsValue);
+}
+
+// Returns the range [first, last) of cells which may be hit by the dBFS value.
+uint2 getHitCellRange(float dbfsValue, uint heatmapHeight, float magnitudeIndexToDbfsCoeff)
+{
+    // cell c is hit if 0.95 * c * coeff < -dbfs < 1.05 * c * coeff; one cell margin on both
+    // sides covers the rounding, the exact check is done by isCellHit()
+    const float attenuation = -dbfsValue / magnitudeIndexToDbfsCoeff;
+    if (!(attenuation > 0.0f))
+    {
+        return (uint2)(0, 0);
+    }
+
+    const float first = floor(attenuation / 1.05f) - 1.0f;
+    const float last = ceil(attenuation / 0.95f) + 2.0f;
+    if (first >= (float)heatmapHeight)
+    {
+        return (uint2)(0, 0);
+    }
+
+    return (uint2)((uint)max(first, 0.0f), (uint)min(last, (float)heatmapHeight));
+}
+
+void addHits(__global uint* hitCounts,
+             __global uint* timestampSums,
+             uint cellOffset,
+             float dbfsValue,
+             uint heatmapHeight,
+             float magnitudeIndexToDbfsCoeff,
+             uint timestamp,
+             int sign)
+{
+    const uint2 range = getHitCellRange(dbfsValue, heatmapHeight, magnitudeIndexToDbfsCoeff);
+    for (uint magnitudeCellIndex = range.x; magnitudeCellIndex < range.y; ++magnitudeCellIndex)
+    {
+        if (isCellHit(magnitudeCellIndex, dbfsValue, magnitudeIndexToDbfsCoeff))
+        {
+            // unsigned wrap-around makes the subtraction exact
+            hitCounts[cellOffset + magnitudeCellIndex] += (uint)sign;
+            timestampSums[cellOffset + magnitudeCellIndex] += (uint)sign * timestamp;
+        }
+    }
+}
+
+// One work item per frequency, so the cells of a frequency are modified by a single work item.
+// Must be called before the new values are copied to the history buffer.
+__kernel void updateHitCounts(
+   __global uint* hitCounts,
+   __global uint* timestampSums,
+   __global const float* dbfsHistoryBuffer,
+   __global const float* newDbfsValues,
+   uint heatmapWidth,
+   uint heatmapHeight,
+   uint replacedBufferIndex,
+   uint timestamp,
+   uint historyBufferCount,
+   float magnitudeIndexToDbfsCoeff
+   )
+{
+    const uint frequencyIndex = get_global_id(0);
+    const uint cellOffset = frequencyIndex * heatmapHeight;
+
+    const uint evictedIndex = replacedBufferIndex * heatmapWidth + frequencyIndex;
+    const float evictedDbfs = dbfsHistoryBuffer[evictedIndex];
+    addHits(hitCounts,
+            timestampSums,
+            cellOffset,
+            evictedDbfs,
+            heatmapHeight,
+            magnitudeIndexToDbfsCoeff,
+            timestamp - historyBufferCount,
+            -1);
+
+    addHits(hitCounts,
+            timestampSums,
+            cellOffset,
+            newDbfsValues[frequencyIndex],
+            heatmapHeight,
+            magnitudeIndexToDbfsCoeff,
+            timestamp,
+            1);
+}
+
+// Recounts the hits of all history frames, e.g. after the level of detail has changed.
+// One work item per frequency, the cells must be zeroed before the launch. The frame in the
+// history with age a (0 - the most recent one) was inserted at newestTimestamp - a.
+__kernel void rebuildHitCounts(
+   __global uint* hitCounts,
+   __global uint* timestampSums,
+   __global const float* dbfsHistoryBuffer,
+   uint heatmapWidth,
+   uint heatmapHeight,
+   uint historyBufferCount,
+   uint mostRecentBufferIndex,
+   uint newestTimestamp,
+   float magnitudeIndexToDbfsCoeff
+   )
+{
+    const uint frequencyIndex = get_global_id(0);
+    const uint cellOffset = frequencyIndex * heatmapHeight;
+
+    for (uint historyBufferIndex = 0; historyBufferIndex < historyBufferCount; ++historyBufferIndex)
+    {
+        const uint bufferAge = mostRecentBufferIndex >= historyBufferIndex
+            ? mostRecentBufferIndex - historyBufferIndex
+            : historyBufferCount - (historyBufferIndex - mostRecentBufferIndex);
+
+        addHits(hitCounts,
+                timestampSums,
+                cellOffset,
+                dbfsHistoryBuffer[historyBufferIndex * heatmapWidth + frequencyIndex],
+                heatmapHeight,
+                magnitudeIndexToDbfsCoeff,
+                newestTimestamp - bufferAge,
+                1);
+    }
+}
+
+// Stores the heatmap values of updateDensityHeatmap: hit ratio and mean age.
+void storeHeatmapCell(__global HeatmapCell* heatmap,
+                      __global uchar* dirtyTiles,
+                      uint cellIndex,
+                      uint hitCount,
+                      uint ageSum,
+                      uint historyBufferCount)
+{
+    storeCell(heatmap,
+              dirtyTiles,
+              cellIndex,
+              (float)hitCount / (float)historyBufferCount,
+              ((float)ageSum / (float)historyBufferCount) / (float)historyBufferCount);
+}
+
+__kernel void resolveHitCounts(
+   __global HeatmapCell* heatmap,
+   __global uchar* dirtyTiles,
+   __global const uint* hitCounts,
+   __global const uint* timestampSums,
+   uint timestamp,
+   uint historyBufferCount
+   )
+{
+    const uint cellIndex = get_global_id(0);
+    const uint hitCount = hitCounts[cellIndex];
+
+    // sum of the ages is hitCount * timestamp - sum of the insertion timestamps
+    const uint ageSum = hitCount * timestamp - timestampSums[cellIndex];
+
+    storeHeatmapCell(heatmap, dirtyTiles, cellIndex, hitCount, ageSum, historyBufferCount);
+}
+
+// Exponential decay mode: the persistence state is kept instead of the history. For the decay
+// factor d the state holds .x = (1 - d) * sum of d^age over the hits and
+// .y = (1 - d)^2 / 2 * sum of age * d^age over the hits (exponentially weighted age), so a cell
+// hit by every frame converges to the gather mode values: 1 and about 0.5. Without RTSA_PACKED
+// the state and the heatmap are the same buffer, written by storeCell(); packed cells are too
+// coarse for the state.
+__kernel void decayDensityHeatmap(
+   __global float2* state,
+   __global HeatmapCell* heatmap,
+   __global uchar* dirtyTiles,
+   __global const float* dbfsValues,
+   uint heatmapHeight,
+   float decayFactor,
+   float magnitudeIndexToDbfsCoeff
+   )
+{
+    const uint frequencyIndex = get_global_id(0);
+    const uint magnitudeCellIndex = get_global_id(1);
+    const uint heatmapCellIndex = frequencyIndex * heatmapHeight + magnitudeCellIndex;
+
+    const bool isHit =
+        isCellHit(magnitudeCellIndex, dbfsValues[frequencyIndex], magnitudeIndexToDbfsCoeff);
+    const float hit = isHit ? 1.0f : 0.0f;
+    const float newFrameWeight = 1.0f - decayFactor;
+
+    const float2 value = state[heatmapCellIndex];
+    const float2 newValue = (float2)(
+        decayFactor * value.x + newFrameWeight * hit,
+        decayFactor * (value.y + 0.5f * newFrameWeight * value.x));
+#ifdef RTSA_PACKED
+    state[heatmapCellIndex] = newValue;
+#endif
+    storeCell(heatmap, dirtyTiles, heatmapCellIndex, newValue.x, newValue.y);
+}
+
+// Resamples the decay state to another level of detail: a coarser cell takes the covered cell
+// with the highest intensity, so thin lines don't fade, a finer cell copies its covering cell.
+// The history is not kept in this mode, so the state is approximated until it decays.
+__kernel void resampleDecayState(
+   __global const float2* sourceState,
+   __global float2* state,
+   uint sourceHeight,
+   uint heatmapHeight
+   )
+{
+    const uint frequencyIndex = get_global_id(0);
+    const uint magnitudeCellIndex = get_global_id(1);
+
+    const uint sourceOffset = frequencyIndex * sourceHeight;
+    const uint first = magnitudeCellIndex * sourceHeight / heatmapHeight;
+    const uint last = max((magnitudeCellIndex + 1) * sourceHeight / heatmapHeight, first + 1);
+
+    float2 value = sourceState[sourceOffset + first];
+    for (uint sourceCellIndex = first + 1; sourceCellIndex < last; ++sourceCellIndex)
+    {
+        const float2 sourceValue = sourceState[sourceOffset + sourceCellIndex];
+        if (sourceValue.x > value.x)
+        {
+            value = sourceValue;
+        }
+    }
+
+    state[frequencyIndex * heatmapHeight + magnitudeCellIndex] = value;
+}
+
+// Scatter mode: one work item per (frequency, history frame) adds its hits to a histogram.
+// A work group owns get_local_size(0) frequencies and accumulates the hits of its frames in
+// a private local memory histogram, then adds the non-zero cells to the global one, so most
+// atomics stay in the local memory. The global histograms must be zeroed before the launch.
+__kernel void scatterDensityHits(
+   __global uint* hitCounts,
+   __global uint* ageSums,
+   __global const float* dbfsHistoryBuffer,
+   __local uint* localHitCounts,
+   __local uint* localAgeSums,
+   uint heatmapWidth,
+   uint heatmapHeight,
+   uint historyBufferCount,
+   uint mostRecentBufferIndex,
+   float magnitudeIndexToDbfsCoeff
+   )
+{
+    const uint localItemCount = get_local_size(0) * get_local_size(1);
+    const uint localItemIndex = get_local_id(1) * get_local_size(0) + get_local_id(0);
+    const uint localCellCount = get_local_size(0) * heatmapHeight;
+
+    for (uint i = localItemIndex; i < localCellCount; i += localItemCount)
+    {
+        localHitCounts[i] = 0;
+        localAgeSums[i] = 0;
+    }
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    // the global size is rounded up to the work group size
+    const uint frequencyIndex = get_global_id(0);
+    const uint historyBufferIndex = get_global_id(1);
+    if (frequencyIndex < heatmapWidth && historyBufferIndex < historyBufferCount)
+    {
+        const uint historyElementIndex = historyBufferIndex * heatmapWidth + frequencyIndex;
+        const float dbfsValue = dbfsHistoryBuffer[historyElementIndex];
+        const uint bufferAge = mostRecentBufferIndex >= historyBufferIndex
+            ? mostRecentBufferIndex - historyBufferIndex
+            : historyBufferCount - (historyBufferIndex - mostRecentBufferIndex);
+
+        const uint localCellOffset = get_local_id(0) * heatmapHeight;
+        const uint2 range = getHitCellRange(dbfsValue, heatmapHeight, magnitudeIndexToDbfsCoeff);
+        for (uint magnitudeCellIndex = range.x; magnitudeCellIndex < range.y; ++magnitudeCellIndex)
+        {
+            if (isCellHit(magnitudeCellIndex, dbfsValue, magnitudeIndexToDbfsCoeff))
+            {
+                atomic_inc(&localHitCounts[localCellOffset + magnitudeCellIndex]);
+                atomic_add(&localAgeSums[localCellOffset + magnitudeCellIndex], bufferAge);
+            }
+        }
+    }
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    const uint globalCellOffset = get_group_id(0) * localCellCount;
+    const uint globalCellCount = heatmapWidth * heatmapHeight;
+    for (uint i = localItemIndex; i < localCellCount; i += localItemCount)
+    {
+        const uint hitCount = localHitCounts[i];
+        if (hitCount != 0 && globalCellOffset + i < globalCellCount)
+        {
+            atomic_add(&hitCounts[globalCellOffset + i], hitCount);
+            atomic_add(&ageSums[globalCellOffset + i], localAgeSums[i]);
+        }
+    }
+}
+
+__kernel void resolveScatteredHits(
+   __global HeatmapCell* heatmap,
+   __global uchar* dirtyTiles,
+   __global const uint* hitCounts,
+   __global const uint* ageSums,
+   uint historyBufferCount
+   )
+{
+    const uint cellIndex = get_global_id(0);
+    storeHeatmapCell(heatmap,
+                     dirtyTiles,
+                     cellIndex,
+                     hitCounts[cellIndex],
+                     ageSums[cellIndex],
+                     historyBufferCount);
 }
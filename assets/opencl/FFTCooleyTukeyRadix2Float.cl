@@ -2,6 +2,9 @@
 #ifndef BIT_REVERSE_SHIFT_VALUE
 #define BIT_REVERSE_SHIFT_VALUE 26
 #endif
+#ifndef MIN_DBFS
+#define MIN_DBFS -10000.0f
+#endif
 
 uint bitReverse(uint v) // TODO compare performance with lookup table
 {
@@ -72,7 +75,31 @@ __kernel void calculate_magnitudes(
    )
 {
    const uint i = get_global_id(0);
-   magnitudes[i] = 2 * sqrt((float)(pow(fft[i].x, 2) + pow(fft[i].y, 2)));
+   magnitudes[i] = 2.0f * sqrt(dot(fft[i], fft[i]));
+}
+
+// Fused magnitude and dBFS calculation, one global memory pass over the FFT values.
+// dBFS = 20 * log10(2 * |X| / reference) = 10 * log10(re^2 + im^2) + dbfsOffset,
+// where dbfsOffset = 20 * log10(2 / reference), so no square root is taken for dBFS.
+// Linear magnitudes are written only if writeMagnitudes is set, e.g. for the waterfall.
+__kernel void calculate_spectrum(
+   __global const float2* fft,
+   __global float* dbfs,
+   __global float* magnitudes,
+   uint writeMagnitudes,
+   float dbfsOffset
+   )
+{
+   const uint i = get_global_id(0);
+   const float power = dot(fft[i], fft[i]);
+
+   // log10(0) = -inf is clamped as well
+   dbfs[i] = fmax(10.0f * log10(power) + dbfsOffset, MIN_DBFS);
+
+   if (writeMagnitudes)
+   {
+      magnitudes[i] = 2.0f * sqrt(power);
+   }
 }
 
 __kernel void find_max(
@@ -96,9 +123,10 @@ __kernel void find_max(
          {
             temp[localId] = temp[localId + i];
          }
-
-         barrier(CLK_LOCAL_MEM_FENCE);
       }
+
+      // barrier must be reached by all work items of the group
+      barrier(CLK_LOCAL_MEM_FENCE);
    }
 
    if (localId == 0)
@@ -0,0 +1,146 @@
+// Kernels of the four-step FFT. The transform of size N = N1 * N2 is calculated as N1 FFTs of
+// size N2 over strided columns, twiddle multiplication, N2 FFTs of size N1 and a transpose.
+// Every FFT kernel processes a batch of transforms; element i of transform b is located at
+// index i * elementStride + b * batchStride.
+
+// Dummy defines for source editor (not used in runtime):
+#ifndef TRANSPOSE_TILE_SIZE
+#define TRANSPOSE_TILE_SIZE 16
+#endif
+
+uint bitReverse(uint v, uint bitCount)
+{
+   // swap odd and even bits
+   v = ((v >> 1) & 0x55555555) | ((v & 0x55555555) << 1);
+   // swap consecutive pairs
+   v = ((v >> 2) & 0x33333333) | ((v & 0x33333333) << 2);
+   // swap nibbles
+   v = ((v >> 4) & 0x0F0F0F0F) | ((v & 0x0F0F0F0F) << 4);
+   // swap bytes
+   v = ((v >> 8) & 0x00FF00FF) | ((v & 0x00FF00FF) << 8);
+   // swap 2-byte long pairs
+   v = ( v >> 16             ) | ( v               << 16);
+
+   return bitCount == 0 ? 0 : v >> (32 - bitCount);
+}
+
+float2 complexMultiply(float2 a, float2 b)
+{
+   return (float2)(a.x*b.x - a.y*b.y, a.x*b.y + a.y*b.x);
+}
+
+__kernel void bit_reverse_real(
+   __global const float* input,
+   __global float2* output,
+   uint bitCount,
+   uint elementStride,
+   uint batchStride
+   )
+{
+   const uint element = get_global_id(0);
+   const uint batch = get_global_id(1);
+   const uint reversedElement = bitReverse(element, bitCount);
+   const float value = input[element * elementStride + batch * batchStride];
+   output[reversedElement * elementStride + batch * batchStride] = (float2)(value, 0.0f);
+}
+
+__kernel void bit_reverse_complex(
+   __global const float2* input,
+   __global float2* output,
+   uint bitCount,
+   uint elementStride,
+   uint batchStride
+   )
+{
+   const uint element = get_global_id(0);
+   const uint batch = get_global_id(1);
+   const uint reversedElement = bitReverse(element, bitCount);
+   output[reversedElement * elementStride + batch * batchStride] =
+      input[element * elementStride + batch * batchStride];
+}
+
+// In-place radix-2 butterfly stage, one work item per butterfly.
+// omegaValues[k * omegaStride] must be exp(-2 * pi * i * k / subFftSize).
+__kernel void fft_stage(
+   __global float2* values,
+   __global const float2* omegaValues,
+   uint subFftSize,
+   uint omegaStride,
+   uint elementStride,
+   uint batchStride
+   )
+{
+   const uint butterflyIndex = get_global_id(0);
+   const uint batch = get_global_id(1);
+   const uint subFftHalfSize = subFftSize / 2;
+
+   const uint subFftIndex = butterflyIndex / subFftHalfSize;
+   const uint subFftElementIndex = butterflyIndex % subFftHalfSize;
+
+   const uint element1 = subFftIndex * subFftSize + subFftElementIndex;
+   const uint element2 = element1 + subFftHalfSize;
+   const uint index1 = element1 * elementStride + batch * batchStride;
+   const uint index2 = element2 * elementStride + batch * batchStride;
+
+   const float2 input1 = values[index1];
+   const float2 omegaInput2 = complexMultiply(omegaValues[subFftElementIndex * omegaStride],
+                                              values[index2]);
+
+   values[index1] = input1 + omegaInput2;
+   values[index2] = input1 - omegaInput2;
+}
+
+// Multiplies element (row, column) of a block of columns by exp(-2 * pi * i * n1 * k2 / N),
+// where n1 = columnOffset + column is the global column and k2 = row.
+__kernel void apply_twiddles(
+   __global float2* values,
+   uint columnOffset,
+   uint columnCount,
+   uint fftSizePower
+   )
+{
+   const uint column = get_global_id(0);
+   const uint row = get_global_id(1);
+
+   // the exponent is taken modulo N, so the angle stays in [-2 * pi, 0]
+   const ulong fftSizeMask = (1ul << fftSizePower) - 1;
+   const ulong exponent = ((ulong)(columnOffset + column) * row) & fftSizeMask;
+   const float angle = -2.0f * M_PI_F * ((float)exponent / (float)(1ul << fftSizePower));
+
+   float cosValue;
+   const float sinValue = sincos(angle, &cosValue);
+
+   const uint index = row * columnCount + column;
+   values[index] = complexMultiply(values[index], (float2)(cosValue, sinValue));
+}
+
+// Transposes a row-major matrix rowCount x columnCount through a local memory tile.
+// Work group size must be TRANSPOSE_TILE_SIZE x TRANSPOSE_TILE_SIZE.
+__kernel void transpose(
+   __global const float2* input,
+   __global float2* output,
+   uint rowCount,
+   uint columnCount
+   )
+{
+   __local float2 tile[TRANSPOSE_TILE_SIZE][TRANSPOSE_TILE_SIZE + 1];
+
+   const uint localColumn = get_local_id(0);
+   const uint localRow = get_local_id(1);
+
+   const uint column = get_global_id(0);
+   const uint row = get_global_id(1);
+   if (row < rowCount && column < columnCount)
+   {
+      tile[localRow][localColumn] = input[row * columnCount + column];
+   }
+
+   barrier(CLK_LOCAL_MEM_FENCE);
+
+   const uint outputColumn = get_group_id(1) * TRANSPOSE_TILE_SIZE + localColumn;
+   const uint outputRow = get_group_id(0) * TRANSPOSE_TILE_SIZE + localRow;
+   if (outputRow < columnCount && outputColumn < rowCount)
+   {
+      output[outputRow * rowCount + outputColumn] = tile[localColumn][localRow];
+   }
+}
@@ -0,0 +1,38 @@
+// Spectral occupancy, one work item per frequency bin. The statistics are updated in place by
+// every frame, so the history is never rescanned. Must match calc_cpu::SpectralOccupancyCalculator.
+
+// Dummy defines for source editor (not used in runtime):
+#ifndef NEVER_SEEN
+#define NEVER_SEEN 0xFFFFFFFFu
+#endif
+
+__kernel void updateOccupancy(
+   __global uint* occupiedFrameCounts,
+   __global float* dutyCycles,
+   __global uint* framesSinceLastSeen,
+   __global const float* dbfsValues,
+   float thresholdDbfs,
+   float dutyCycleWeight
+   )
+{
+    const uint i = get_global_id(0);
+    const bool isOccupied = dbfsValues[i] > thresholdDbfs;
+
+    if (isOccupied)
+    {
+        occupiedFrameCounts[i] += 1;
+    }
+
+    const float dutyCycle = dutyCycles[i];
+    dutyCycles[i] = dutyCycle + ((isOccupied ? 1.0f : 0.0f) - dutyCycle) * dutyCycleWeight;
+
+    const uint frames = framesSinceLastSeen[i];
+    if (isOccupied)
+    {
+        framesSinceLastSeen[i] = 0;
+    }
+    else if (frames < NEVER_SEEN - 1)
+    {
+        framesSinceLastSeen[i] = frames + 1;
+    }
+}
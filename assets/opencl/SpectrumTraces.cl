@@ -0,0 +1,60 @@
+// Spectrum traces, one work item per frequency bin. The traces are stored one after another in
+// a single buffer, traceOffset is the index of the first value of the trace.
+// Must match calc_cpu::SpectrumTraceCalculator.
+
+// Dummy defines for source editor (not used in runtime):
+#ifndef MIN_DBFS
+#define MIN_DBFS -10000.0f
+#endif
+
+__kernel void updateLiveTrace(
+   __global float* traces,
+   __global const float* dbfsValues,
+   uint traceOffset
+   )
+{
+    const uint i = get_global_id(0);
+    traces[traceOffset + i] = dbfsValues[i];
+}
+
+__kernel void updateMaxHoldTrace(
+   __global float* traces,
+   __global const float* dbfsValues,
+   uint traceOffset,
+   uint isFirstFrame
+   )
+{
+    const uint i = get_global_id(0);
+    const float dbfs = dbfsValues[i];
+    traces[traceOffset + i] = isFirstFrame ? dbfs : fmax(traces[traceOffset + i], dbfs);
+}
+
+__kernel void updateMinHoldTrace(
+   __global float* traces,
+   __global const float* dbfsValues,
+   uint traceOffset,
+   uint isFirstFrame
+   )
+{
+    const uint i = get_global_id(0);
+    const float dbfs = dbfsValues[i];
+    traces[traceOffset + i] = isFirstFrame ? dbfs : fmin(traces[traceOffset + i], dbfs);
+}
+
+// averageState keeps the linear average: of the power if dbfsScale is 10, of the magnitude
+// if it is 20.
+__kernel void updateAverageTrace(
+   __global float* traces,
+   __global float* averageState,
+   __global const float* dbfsValues,
+   uint traceOffset,
+   float weight,
+   float dbfsScale
+   )
+{
+    const uint i = get_global_id(0);
+    const float value = pow(10.0f, dbfsValues[i] / dbfsScale);
+    const float average = averageState[i] + (value - averageState[i]) * weight;
+    averageState[i] = average;
+    traces[traceOffset + i] = fmax(dbfsScale * log10(average), MIN_DBFS);
+}
@@ -7,9 +7,22 @@ uniform float dbfsToMagnitudeCellCoeff;
 
 layout(std430, binding = 1) readonly buffer RtsaBuffer
 {
+#ifdef RTSA_PACKED
+    uint values[]; // intensity in the low 16 bits, age in the high 16 bits
+#else
     vec2 values[];
+#endif
 } rtsaBuffer;
 
+vec2 getCellValue(uint bufferElementIndex)
+{
+#ifdef RTSA_PACKED
+    return unpackUnorm2x16(rtsaBuffer.values[bufferElementIndex]);
+#else
+    return rtsaBuffer.values[bufferElementIndex];
+#endif
+}
+
 void main()
 {
     uint columnIndex = uint(heatmapPosition.x);
@@ -18,10 +31,12 @@ void main()
 
     //float value = rtsaBuffer.values[bufferElementIndex];
 
-    float valueIntensity = rtsaBuffer.values[bufferElementIndex].x;
+    vec2 cellValue = getCellValue(bufferElementIndex);
+
+    float valueIntensity = cellValue.x;
     valueIntensity = clamp(valueIntensity, 0.0, 1.0);
 
-    float valueAge = rtsaBuffer.values[bufferElementIndex].y;
+    float valueAge = cellValue.y;
     valueAge = clamp(valueAge, 0.0, 1.0);
 
     vec4 valueIntensityColor = getScaleColor(valueIntensity);
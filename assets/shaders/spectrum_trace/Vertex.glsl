@@ -0,0 +1,25 @@
+#version 430 core
+
+// One vertex per frequency bin, the trace values are read from the buffer by the vertex index.
+
+uniform mat3 worldToClip;
+uniform uint traceOffset;
+uniform float binWidth; // Hz
+uniform float minDbfs;
+
+layout(std430, binding = 2) readonly buffer SpectrumTraceBuffer
+{
+    float values[];
+} traceBuffer;
+
+void main()
+{
+    float dbfs = traceBuffer.values[traceOffset + uint(gl_VertexID)];
+    dbfs = clamp(dbfs, minDbfs, 0.0);
+
+    // the bin is drawn in the center of its RTSA column
+    vec2 worldPosition = vec2((float(gl_VertexID) + 0.5) * binWidth, dbfs);
+
+    vec3 clipSpacePosition = worldToClip * vec3(worldPosition, 1.0);
+    gl_Position = vec4(clipSpacePosition.xy, 0.0, 1.0);
+}
@@ -6,21 +6,53 @@ uniform vec2 lowerLeft; // TODO move to vertex?
 uniform float columnWidthUnits;
 uniform float valueHeightUnits; // TODO elementHeight
 uniform uint columnHeightValues; // TODO elementCountInColumn
+uniform uint filledColumnCount; // columns of the buffer which have data
 uniform float minValue;
 uniform float maxValue;
 
+uniform float minDecibels; // quantization range of the decibel storage formats
+uniform float maxDecibels;
+
+#if defined(HEATMAP_DECIBEL16)
+#define HEATMAP_CODE_BITS 16u
+#elif defined(HEATMAP_DECIBEL8)
+#define HEATMAP_CODE_BITS 8u
+#endif
+
 layout(std430, binding = 1) readonly buffer HeatmapBuffer
 {
+#ifdef HEATMAP_CODE_BITS
+    uint values[]; // decibel codes, the first one in the low bits
+#else
     float values[];
+#endif
 } heatmapBuffer;
 
+float getValue(uint valueIndex)
+{
+#ifdef HEATMAP_CODE_BITS
+    const uint codesInValue = 32u / HEATMAP_CODE_BITS;
+    const uint maxCode = (1u << HEATMAP_CODE_BITS) - 1u;
+    uint packedCodes = heatmapBuffer.values[valueIndex / codesInValue];
+    uint code = (packedCodes >> (valueIndex % codesInValue * HEATMAP_CODE_BITS)) & maxCode;
+    float decibels = mix(minDecibels, maxDecibels, float(code) / float(maxCode));
+    return pow(10.0, decibels / 20.0);
+#else
+    return heatmapBuffer.values[valueIndex];
+#endif
+}
+
 void main()
 {
     vec2 bufferRelativePos = heatmapPosition - lowerLeft;
     uint valueIndexY = getElementIndexY(bufferRelativePos.y, valueHeightUnits, columnHeightValues);
     uint valueIndexX = uint(bufferRelativePos.x / columnWidthUnits);
+    if (valueIndexX >= filledColumnCount)
+    {
+        discard;
+    }
     uint valueIndex = valueIndexX * columnHeightValues + valueIndexY;
-    float value = heatmapBuffer.values[valueIndex];
+    float value = getValue(valueIndex);
 
     float magnitudeValueRatio = getMagnitudeValueRatio(value, minValue, maxValue);
     magnitudeValueRatio = clamp(magnitudeValueRatio, 0.0, 1.0);
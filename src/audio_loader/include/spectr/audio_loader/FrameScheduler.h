@@ -0,0 +1,115 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <optional>
+
+namespace spectr::audio_loader
+{
+/**
+ * @brief What to do with the frames which are due but don't fit into the backlog limit.
+ */
+enum class FrameOverloadPolicy
+{
+    DropOldest,  // skip the oldest due frames, only the latest ones are produced
+    Decimate,    // produce every other due frame, skip the oldest ones above twice the limit
+    BlockSource, // never skip frames, the source is not read until the backlog is produced
+};
+
+struct ScheduledFrame
+{
+    size_t index = 0;         // index of the frame on the time axis, skipped frames leave gaps
+    size_t startPosition = 0; // stream position of the first sample of the frame
+};
+
+struct FrameSchedulerStatistics
+{
+    size_t producedFrameCount = 0;
+    size_t droppedFrameCount = 0; // skipped by the overload policy
+    size_t lateFrameCount = 0;    // produced when a newer frame was already due
+    size_t backlogFrameCount = 0; // due frames not produced yet, at the last check
+};
+
+/**
+ * @brief Decides which frames of a sample stream are produced and when.
+ * @details Frames start every hop samples and are due as soon as all their samples have arrived,
+ * so the frame rate follows the sample clock of the source instead of a wall clock. A producer
+ * which falls behind catches up by producing all due frames at once, while the backlog of due
+ * frames exceeds the limit the overload policy applies. The statistics may be read from any
+ * thread, everything else must be called from the producer thread.
+ */
+class FrameScheduler
+{
+public:
+    /**
+     * @param frameSize Count of samples in a frame.
+     * @param maxBacklogFrameCount Count of due frames the producer may lag behind before the
+     * overload policy applies.
+     */
+    FrameScheduler(size_t frameSize, size_t maxBacklogFrameCount, FrameOverloadPolicy policy);
+
+    /**
+     * @brief Sets count of samples between the starts of the following frames, the next frame
+     * start doesn't change.
+     */
+    void setHop(size_t hop);
+
+    size_t getHop() const;
+
+    /**
+     * @brief Returns count of samples which have to be buffered to produce the whole backlog
+     * allowed by the policy.
+     */
+    size_t getSampleCapacity() const;
+
+    /**
+     * @brief Returns the next frame to produce, frames skipped by the overload policy are
+     * counted as dropped.
+     * @param arrivedEndPosition Position after the last sample received from the source, whether
+     * it's already buffered or not.
+     * @param queuedFrameCount Count of the produced frames still queued to the consumers, they
+     * take part of the backlog limit, the latest due frame is produced anyway.
+     * @return Nothing if not all samples of the next frame have arrived.
+     */
+    std::optional<ScheduledFrame> getNextFrame(size_t arrivedEndPosition,
+                                               size_t queuedFrameCount = 0);
+
+    /**
+     * @brief Marks the frame returned by the last getNextFrame() call as produced.
+     */
+    void onFrameProduced();
+
+    /**
+     * @brief Returns stream position of the next frame, samples before it aren't needed.
+     */
+    size_t getNextFrameStart() const;
+
+    FrameOverloadPolicy getPolicy() const;
+
+    size_t getMaxBacklogFrameCount() const;
+
+    FrameSchedulerStatistics getStatistics() const;
+
+private:
+    /**
+     * @brief Returns count of the due and queued frames which are never skipped.
+     */
+    size_t getBacklogLimit() const;
+
+    void skipFrames(size_t count);
+
+private:
+    const size_t m_frameSize;
+    const size_t m_maxBacklogFrameCount;
+    const FrameOverloadPolicy m_policy;
+    size_t m_hop = 0;
+    size_t m_nextFrameIndex = 0;
+    size_t m_nextFrameStart = 0;
+    size_t m_step = 1; // frames to advance after the next frame is produced
+    bool m_isNextFrameLate = false;
+    std::atomic<size_t> m_producedFrameCount = 0;
+    std::atomic<size_t> m_droppedFrameCount = 0;
+    std::atomic<size_t> m_lateFrameCount = 0;
+    std::atomic<size_t> m_backlogFrameCount = 0;
+};
+}
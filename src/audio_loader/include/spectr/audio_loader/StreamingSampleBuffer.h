@@ -0,0 +1,83 @@
+#pragma once
+
+#include <spectr/audio_loader/SignalData.h>
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace spectr::audio_loader
+{
+/**
+ * @brief Fixed capacity ring of the latest samples of one channel of a signal stream.
+ * @details Samples are addressed by their absolute position in the stream. New samples are
+ * appended only while there is free space, consumed samples must be discarded by the reader, so
+ * the memory doesn't grow however long the stream is. Every sample is stored twice, at its ring
+ * index and one capacity later, so any stored range is contiguous in memory: overlapping frames
+ * are views of the same samples, cutting a frame doesn't copy them.
+ */
+class StreamingSampleBuffer
+{
+public:
+    explicit StreamingSampleBuffer(size_t capacity);
+
+    /**
+     * @brief Appends as many samples as fit into the free space.
+     * @return Count of the appended samples.
+     */
+    size_t append(const float* samples, size_t count);
+
+    /**
+     * @brief Appends as many samples converted to float as fit into the free space.
+     * @param offset Index of the first sample to append.
+     * @return Count of the appended samples.
+     */
+    size_t append(const SampleDataVariant& samples, size_t offset);
+
+    /**
+     * @brief Skips samples of the stream without storing them, as many as fit into the free
+     * space. The skipped positions occupy the space until they are discarded.
+     * @return Count of the skipped samples.
+     */
+    size_t skip(size_t count);
+
+    /**
+     * @brief Returns view of the stored samples [position, position + count), it's valid until
+     * the samples are discarded.
+     */
+    std::span<const float> getView(size_t position, size_t count) const;
+
+    /**
+     * @brief Frees the space of all samples before the position.
+     */
+    void discardBefore(size_t position);
+
+    /**
+     * @brief Discards all samples, the next appended sample gets the position.
+     */
+    void reset(size_t position = 0);
+
+    /**
+     * @brief Returns position of the oldest stored sample.
+     */
+    size_t getBeginPosition() const;
+
+    /**
+     * @brief Returns position of the next appended sample.
+     */
+    size_t getEndPosition() const;
+
+    size_t getCapacity() const;
+
+    size_t getFreeCount() const;
+
+private:
+    void write(size_t position, float sample);
+
+private:
+    const size_t m_capacity;
+    std::vector<float> m_samples; // two copies of the ring
+    size_t m_beginPosition = 0;
+    size_t m_endPosition = 0;
+};
+}
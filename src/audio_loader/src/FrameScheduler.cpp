@@ -0,0 +1,128 @@
+#include <spectr/audio_loader/FrameScheduler.h>
+
+#include <spectr/utils/Assert.h>
+
+#include <algorithm>
+
+namespace spectr::audio_loader
+{
+namespace
+{
+constexpr size_t DecimationFactor = 2; // of the due frames above the backlog limit
+}
+
+FrameScheduler::FrameScheduler(size_t frameSize,
+                               size_t maxBacklogFrameCount,
+                               FrameOverloadPolicy policy)
+  : m_frameSize{ frameSize }
+  , m_maxBacklogFrameCount{ maxBacklogFrameCount }
+  , m_policy{ policy }
+{
+    ASSERT(m_frameSize > 0);
+    ASSERT(m_maxBacklogFrameCount > 0);
+}
+
+void FrameScheduler::setHop(size_t hop)
+{
+    ASSERT(hop > 0);
+    m_hop = hop;
+}
+
+size_t FrameScheduler::getHop() const
+{
+    return m_hop;
+}
+
+size_t FrameScheduler::getSampleCapacity() const
+{
+    return m_frameSize + m_hop * getBacklogLimit();
+}
+
+std::optional<ScheduledFrame> FrameScheduler::getNextFrame(size_t arrivedEndPosition,
+                                                           size_t queuedFrameCount)
+{
+    ASSERT(m_hop > 0);
+
+    m_step = 1;
+    if (arrivedEndPosition < m_nextFrameStart + m_frameSize)
+    {
+        m_backlogFrameCount = 0;
+        return std::nullopt;
+    }
+
+    // the queued frames are produced already, only the due ones can be skipped
+    const auto dueFrameLimit =
+      getBacklogLimit() - std::min(queuedFrameCount, getBacklogLimit() - 1);
+    auto backlog = (arrivedEndPosition - m_frameSize - m_nextFrameStart) / m_hop + 1;
+    if (m_policy != FrameOverloadPolicy::BlockSource && backlog > dueFrameLimit)
+    {
+        skipFrames(backlog - dueFrameLimit);
+        backlog = dueFrameLimit;
+    }
+
+    if (m_policy == FrameOverloadPolicy::Decimate &&
+        backlog + queuedFrameCount > m_maxBacklogFrameCount)
+    {
+        m_step = DecimationFactor;
+    }
+
+    m_isNextFrameLate = backlog > 1;
+    m_backlogFrameCount = backlog;
+
+    return ScheduledFrame{ .index = m_nextFrameIndex, .startPosition = m_nextFrameStart };
+}
+
+void FrameScheduler::onFrameProduced()
+{
+    ++m_producedFrameCount;
+    if (m_isNextFrameLate)
+    {
+        ++m_lateFrameCount;
+    }
+
+    m_nextFrameIndex += 1;
+    m_nextFrameStart += m_hop;
+    skipFrames(m_step - 1);
+
+    m_step = 1;
+    m_isNextFrameLate = false;
+}
+
+size_t FrameScheduler::getNextFrameStart() const
+{
+    return m_nextFrameStart;
+}
+
+FrameOverloadPolicy FrameScheduler::getPolicy() const
+{
+    return m_policy;
+}
+
+size_t FrameScheduler::getMaxBacklogFrameCount() const
+{
+    return m_maxBacklogFrameCount;
+}
+
+FrameSchedulerStatistics FrameScheduler::getStatistics() const
+{
+    return FrameSchedulerStatistics{
+        .producedFrameCount = m_producedFrameCount,
+        .droppedFrameCount = m_droppedFrameCount,
+        .lateFrameCount = m_lateFrameCount,
+        .backlogFrameCount = m_backlogFrameCount,
+    };
+}
+
+size_t FrameScheduler::getBacklogLimit() const
+{
+    return m_policy == FrameOverloadPolicy::Decimate ? m_maxBacklogFrameCount * DecimationFactor
+                                                     : m_maxBacklogFrameCount;
+}
+
+void FrameScheduler::skipFrames(size_t count)
+{
+    m_nextFrameIndex += count;
+    m_nextFrameStart += count * m_hop;
+    m_droppedFrameCount += count;
+}
+}
@@ -0,0 +1,108 @@
+#include <spectr/audio_loader/StreamingSampleBuffer.h>
+
+#include <spectr/utils/Assert.h>
+#include <spectr/utils/Exception.h>
+
+#include <algorithm>
+#include <variant>
+
+namespace spectr::audio_loader
+{
+StreamingSampleBuffer::StreamingSampleBuffer(size_t capacity)
+  : m_capacity{ capacity }
+  , m_samples(capacity * 2)
+{
+    ASSERT(capacity > 0);
+}
+
+size_t StreamingSampleBuffer::append(const float* samples, size_t count)
+{
+    const auto appendCount = std::min(count, getFreeCount());
+    for (size_t i = 0; i < appendCount; ++i)
+    {
+        write(m_endPosition + i, samples[i]);
+    }
+    m_endPosition += appendCount;
+
+    return appendCount;
+}
+
+size_t StreamingSampleBuffer::append(const SampleDataVariant& samples, size_t offset)
+{
+    return std::visit(
+      [this, offset](const auto& values) -> size_t
+      {
+          const auto count = values.size() > offset ? values.size() - offset : 0;
+          const auto appendCount = std::min(count, getFreeCount());
+          for (size_t i = 0; i < appendCount; ++i)
+          {
+              write(m_endPosition + i, static_cast<float>(values[offset + i]));
+          }
+          m_endPosition += appendCount;
+
+          return appendCount;
+      },
+      samples);
+}
+
+size_t StreamingSampleBuffer::skip(size_t count)
+{
+    const auto skipCount = std::min(count, getFreeCount());
+    m_endPosition += skipCount;
+
+    return skipCount;
+}
+
+std::span<const float> StreamingSampleBuffer::getView(size_t position, size_t count) const
+{
+    if (position < m_beginPosition || position + count > m_endPosition)
+    {
+        throw utils::Exception("Samples [{}, {}) are not stored, stored range: [{}, {})",
+                               position,
+                               position + count,
+                               m_beginPosition,
+                               m_endPosition);
+    }
+
+    // the range never exceeds the capacity, so it fits into the second copy of the ring
+    return std::span<const float>{ m_samples.data() + position % m_capacity, count };
+}
+
+void StreamingSampleBuffer::discardBefore(size_t position)
+{
+    m_beginPosition = std::clamp(position, m_beginPosition, m_endPosition);
+}
+
+void StreamingSampleBuffer::reset(size_t position)
+{
+    m_beginPosition = position;
+    m_endPosition = position;
+}
+
+size_t StreamingSampleBuffer::getBeginPosition() const
+{
+    return m_beginPosition;
+}
+
+size_t StreamingSampleBuffer::getEndPosition() const
+{
+    return m_endPosition;
+}
+
+size_t StreamingSampleBuffer::getCapacity() const
+{
+    return m_capacity;
+}
+
+size_t StreamingSampleBuffer::getFreeCount() const
+{
+    return m_capacity - (m_endPosition - m_beginPosition);
+}
+
+void StreamingSampleBuffer::write(size_t position, float sample)
+{
+    const auto index = position % m_capacity;
+    m_samples[index] = sample;
+    m_samples[index + m_capacity] = sample;
+}
+}
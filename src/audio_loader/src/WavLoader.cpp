@@ -172,7 +172,16 @@ SignalData WavLoader::load(std::istream& reader)
         {
             SampleData16 samples;
             samples.resize(samplesCount);
-            reader.read(reinterpret_cast<char*>(samples.data()), samplesCount);
+
+            // the size is in bytes, not in samples
+            const auto channelDataSize = static_cast<std::streamsize>(samplesCount * sampleSize);
+            reader.read(reinterpret_cast<char*>(samples.data()), channelDataSize);
+            if (reader.gcount() != channelDataSize)
+            {
+                throw utils::Exception("WAVE data chunk is truncated: read {} of {} bytes.",
+                                       reader.gcount(),
+                                       channelDataSize);
+            }
             channelsData.push_back(std::move(samples));
         }
     }
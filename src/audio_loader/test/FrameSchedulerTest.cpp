@@ -0,0 +1,132 @@
+#include <spectr/audio_loader/FrameScheduler.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace spectr::audio_loader::test
+{
+namespace
+{
+/**
+ * @brief Returns indices of the frames produced from the arrived samples.
+ */
+std::vector<size_t> produceAll(FrameScheduler& scheduler, size_t arrivedEndPosition)
+{
+    std::vector<size_t> indices;
+    while (const auto frame = scheduler.getNextFrame(arrivedEndPosition))
+    {
+        EXPECT_EQ(frame->startPosition, frame->index * scheduler.getHop());
+        indices.push_back(frame->index);
+        scheduler.onFrameProduced();
+    }
+    return indices;
+}
+
+/**
+ * @brief Same as produceAll, but none of the produced frames is consumed, they stay queued after
+ * the given ones.
+ */
+std::vector<size_t> produceQueued(FrameScheduler& scheduler,
+                                  size_t arrivedEndPosition,
+                                  size_t queuedFrameCount)
+{
+    std::vector<size_t> indices;
+    while (const auto frame =
+             scheduler.getNextFrame(arrivedEndPosition, queuedFrameCount + indices.size()))
+    {
+        indices.push_back(frame->index);
+        scheduler.onFrameProduced();
+    }
+    return indices;
+}
+}
+
+TEST(FrameScheduler, FollowsSampleClock)
+{
+    FrameScheduler scheduler{ 8, 4, FrameOverloadPolicy::DropOldest };
+    scheduler.setHop(4);
+    EXPECT_EQ(scheduler.getSampleCapacity(), 8 + 4 * 4);
+
+    EXPECT_FALSE(scheduler.getNextFrame(7));
+    EXPECT_EQ(produceAll(scheduler, 8), std::vector<size_t>({ 0 }));
+    EXPECT_EQ(produceAll(scheduler, 11), std::vector<size_t>{});
+    EXPECT_EQ(produceAll(scheduler, 12), std::vector<size_t>({ 1 }));
+    EXPECT_EQ(scheduler.getNextFrameStart(), 8);
+
+    // the frames are produced on time
+    const auto statistics = scheduler.getStatistics();
+    EXPECT_EQ(statistics.producedFrameCount, 2);
+    EXPECT_EQ(statistics.droppedFrameCount, 0);
+    EXPECT_EQ(statistics.lateFrameCount, 0);
+}
+
+TEST(FrameScheduler, CatchesUpWithinBacklogLimit)
+{
+    FrameScheduler scheduler{ 8, 4, FrameOverloadPolicy::DropOldest };
+    scheduler.setHop(4);
+
+    // 4 frames are due, all of them are produced, all but the last one late
+    EXPECT_EQ(produceAll(scheduler, 20), std::vector<size_t>({ 0, 1, 2, 3 }));
+    const auto statistics = scheduler.getStatistics();
+    EXPECT_EQ(statistics.producedFrameCount, 4);
+    EXPECT_EQ(statistics.droppedFrameCount, 0);
+    EXPECT_EQ(statistics.lateFrameCount, 3);
+}
+
+TEST(FrameScheduler, DropsOldestFrames)
+{
+    FrameScheduler scheduler{ 8, 2, FrameOverloadPolicy::DropOldest };
+    scheduler.setHop(4);
+
+    // frames 0..5 are due, only the latest 2 are produced
+    EXPECT_EQ(produceAll(scheduler, 28), std::vector<size_t>({ 4, 5 }));
+    const auto statistics = scheduler.getStatistics();
+    EXPECT_EQ(statistics.producedFrameCount, 2);
+    EXPECT_EQ(statistics.droppedFrameCount, 4);
+    EXPECT_EQ(statistics.lateFrameCount, 1);
+    EXPECT_EQ(statistics.backlogFrameCount, 0);
+}
+
+TEST(FrameScheduler, CountsQueuedFramesInBacklog)
+{
+    FrameScheduler scheduler{ 8, 4, FrameOverloadPolicy::DropOldest };
+    scheduler.setHop(4);
+
+    // frames 0..5 are due and 2 earlier frames are queued, only the latest 2 fit the limit
+    EXPECT_EQ(produceQueued(scheduler, 28, 2), std::vector<size_t>({ 4, 5 }));
+    EXPECT_EQ(scheduler.getStatistics().droppedFrameCount, 4);
+
+    // the latest frame is produced even if the queue alone exceeds the limit
+    EXPECT_EQ(produceQueued(scheduler, 44, 10), std::vector<size_t>({ 9 }));
+    EXPECT_EQ(scheduler.getStatistics().droppedFrameCount, 7);
+}
+
+TEST(FrameScheduler, DecimatesFramesAboveLimit)
+{
+    FrameScheduler scheduler{ 8, 2, FrameOverloadPolicy::Decimate };
+    scheduler.setHop(4);
+
+    // frames 0..5 are due: 2 dropped above twice the limit, then every other frame while the
+    // backlog is above the limit
+    EXPECT_EQ(produceAll(scheduler, 28), std::vector<size_t>({ 2, 4, 5 }));
+    const auto statistics = scheduler.getStatistics();
+    EXPECT_EQ(statistics.producedFrameCount, 3);
+    EXPECT_EQ(statistics.droppedFrameCount, 3);
+}
+
+TEST(FrameScheduler, BlockSourceNeverDrops)
+{
+    FrameScheduler scheduler{ 8, 2, FrameOverloadPolicy::BlockSource };
+    scheduler.setHop(4);
+
+    const auto frame = scheduler.getNextFrame(28);
+    ASSERT_TRUE(frame);
+    EXPECT_EQ(frame->index, 0);
+    EXPECT_EQ(scheduler.getStatistics().backlogFrameCount, 6);
+
+    EXPECT_EQ(produceAll(scheduler, 28), std::vector<size_t>({ 0, 1, 2, 3, 4, 5 }));
+    EXPECT_EQ(scheduler.getStatistics().droppedFrameCount, 0);
+    EXPECT_EQ(scheduler.getStatistics().lateFrameCount, 5);
+}
+}
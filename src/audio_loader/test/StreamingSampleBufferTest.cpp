@@ -0,0 +1,84 @@
+#include <spectr/audio_loader/StreamingSampleBuffer.h>
+
+#include <spectr/utils/Exception.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace spectr::audio_loader::test
+{
+TEST(StreamingSampleBuffer, KeepsPositionsAcrossWrapAround)
+{
+    StreamingSampleBuffer buffer{ 4 };
+
+    const SampleDataVariant samples = SampleData16{ 0, 1, 2, 3, 4, 5 };
+    EXPECT_EQ(buffer.append(samples, 0), 4); // only the free space is filled
+    EXPECT_EQ(buffer.getFreeCount(), 0);
+    EXPECT_THROW(buffer.getView(3, 2), utils::Exception);
+
+    buffer.discardBefore(3);
+    EXPECT_EQ(buffer.getBeginPosition(), 3);
+    EXPECT_EQ(buffer.append(samples, 4), 2);
+    EXPECT_EQ(buffer.getEndPosition(), 6);
+    EXPECT_THROW(buffer.getView(2, 1), utils::Exception);
+
+    // the range wraps around the end of the ring, but the view is contiguous
+    const auto view = buffer.getView(3, 3);
+    EXPECT_EQ(std::vector<float>(view.begin(), view.end()),
+              (std::vector<float>{ 3.0f, 4.0f, 5.0f }));
+}
+
+TEST(StreamingSampleBuffer, SkipsSamplesWithoutStoringThem)
+{
+    StreamingSampleBuffer buffer{ 4 };
+
+    const SampleDataVariant samples = SampleData16{ 0, 1, 2, 3, 4, 5 };
+    EXPECT_EQ(buffer.skip(3), 3);
+    EXPECT_EQ(buffer.getFreeCount(), 1);
+    EXPECT_EQ(buffer.skip(3), 1);
+
+    buffer.discardBefore(4);
+    EXPECT_EQ(buffer.append(samples, 4), 2);
+    const auto view = buffer.getView(4, 2);
+    EXPECT_EQ(std::vector<float>(view.begin(), view.end()), (std::vector<float>{ 4.0f, 5.0f }));
+}
+
+TEST(StreamingSampleBuffer, MemoryStaysBoundedForLongStreams)
+{
+    constexpr size_t FrameSize = 8;
+    constexpr size_t Hop = 3;
+    StreamingSampleBuffer buffer{ FrameSize + Hop };
+
+    std::vector<float> chunk(5);
+    size_t chunkOffset = chunk.size();
+    size_t nextSample = 0;
+    size_t frameStart = 0;
+    for (size_t iteration = 0; iteration < 1000; ++iteration)
+    {
+        if (chunkOffset == chunk.size())
+        {
+            for (auto& value : chunk)
+            {
+                value = static_cast<float>(nextSample++);
+            }
+            chunkOffset = 0;
+        }
+        chunkOffset += buffer.append(chunk.data() + chunkOffset, chunk.size() - chunkOffset);
+
+        if (buffer.getEndPosition() >= frameStart + FrameSize)
+        {
+            const auto frame = buffer.getView(frameStart, FrameSize);
+            for (size_t i = 0; i < FrameSize; ++i)
+            {
+                ASSERT_EQ(frame[i], static_cast<float>(frameStart + i));
+            }
+            frameStart += Hop;
+            buffer.discardBefore(frameStart);
+        }
+    }
+
+    EXPECT_GT(frameStart, 100 * Hop);
+    EXPECT_EQ(buffer.getCapacity(), FrameSize + Hop);
+}
+}
@@ -1,13 +1,54 @@
 #include <spectr/audio_loader/WavLoader.h>
 
 #include <spectr/utils/Asset.h>
+#include <spectr/utils/Exception.h>
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cstdint>
 #include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
 
 namespace spectr::audio_loader::test
 {
+namespace
+{
+template<typename T>
+void appendValue(std::string& bytes, T value)
+{
+    bytes.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+/**
+ * @brief Returns a mono 16-bit PCM WAVE file, its data chunk may declare more samples than given.
+ */
+std::string createWav(const std::vector<int16_t>& samples, size_t declaredSampleCount)
+{
+    const auto dataSize = static_cast<uint32_t>(declaredSampleCount * sizeof(int16_t));
+
+    std::string bytes = "RIFF";
+    appendValue<uint32_t>(bytes, 36 + dataSize);
+    bytes += "WAVEfmt ";
+    appendValue<uint32_t>(bytes, 16);
+    appendValue<uint16_t>(bytes, 1); // PCM
+    appendValue<uint16_t>(bytes, 1); // channels
+    appendValue<uint32_t>(bytes, 8000);
+    appendValue<uint32_t>(bytes, 8000 * sizeof(int16_t));
+    appendValue<uint16_t>(bytes, sizeof(int16_t));
+    appendValue<uint16_t>(bytes, 16);
+    bytes += "data";
+    appendValue<uint32_t>(bytes, dataSize);
+    for (const auto sample : samples)
+    {
+        appendValue(bytes, sample);
+    }
+    return bytes;
+}
+}
+
 TEST(WavLoader, Load_sample_440Hz)
 {
     std::ifstream file(utils::Asset::getPath("samples/440Hz_44100Hz_16bit_05sec.wav"));
@@ -19,7 +60,28 @@ TEST(WavLoader, Load_sample_440Hz)
     EXPECT_NEAR(audio.getDuration(), 5.0f, 0.1f);
 
     EXPECT_NO_THROW(audio.getSampleData16(0));
+
+    // the whole data chunk is read, not only its first half
+    const auto& samples = audio.getSampleData16(0);
+    EXPECT_TRUE(
+      std::any_of(samples.end() - 100, samples.end(), [](auto value) { return value != 0; }));
     EXPECT_THROW(audio.getSampleData32(0), std::bad_variant_access);
     EXPECT_THROW(audio.getSampleData64(0), std::bad_variant_access);
 }
+
+TEST(WavLoader, ReadsWholeDataChunk)
+{
+    const std::vector<int16_t> samples{ 1, -2, 3, -4, 5 };
+    std::istringstream stream{ createWav(samples, samples.size()) };
+
+    const auto audio = WavLoader::load(stream);
+    const auto& loaded = audio.getSampleData16(0);
+    EXPECT_EQ(std::vector<int16_t>(loaded.begin(), loaded.end()), samples);
+}
+
+TEST(WavLoader, RejectsTruncatedDataChunk)
+{
+    std::istringstream stream{ createWav({ 1, -2, 3 }, 5) };
+    EXPECT_THROW(WavLoader::load(stream), utils::Exception);
+}
 }
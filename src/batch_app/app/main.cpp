@@ -0,0 +1,6 @@
+#include <spectr/batch_app/SpectrBatchApp.h>
+
+int main(int argc, const char* argv[])
+{
+    return ::spectr::batch_app::SpectrBatchApp::main(argc, argv);
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <spectr/storage/SpectrogramStorageFormat.h>
+
+#include <filesystem>
+#include <string>
+
+namespace spectr::batch_app
+{
+enum class Command
+{
+    PrintHelp,
+    PrintVersion,
+    Execute,
+};
+
+struct BatchAppSettings
+{
+    Command command = Command::PrintHelp;
+    std::string helpDescription;
+    std::filesystem::path inputPath;  // WAV file or directory of WAV files
+    std::filesystem::path outputPath; // empty - next to the input files
+    size_t fftSize = 0;
+    size_t hop = 0;             // samples between the starts of the following frames
+    size_t threadCount = 0;     // zero - count of hardware threads
+    size_t batchFrameCount = 0; // frames calculated by a thread at once
+    storage::ValueFormat valueFormat = storage::ValueFormat::Float32;
+    float minDecibels = 0.0f; // quantization range of the decibel formats
+    float maxDecibels = 200.0f;
+};
+}
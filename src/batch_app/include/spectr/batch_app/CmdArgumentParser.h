@@ -0,0 +1,12 @@
+#pragma once
+
+#include <spectr/batch_app/BatchAppSettings.h>
+
+namespace spectr::batch_app
+{
+class CmdArgumentParser
+{
+public:
+    static BatchAppSettings parse(int argc, const char* argv[]);
+};
+}
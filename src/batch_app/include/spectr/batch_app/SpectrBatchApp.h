@@ -0,0 +1,31 @@
+#pragma once
+
+#include <spectr/batch_app/BatchAppSettings.h>
+#include <spectr/batch_app/SpectrogramBatchProcessor.h>
+
+#include <vector>
+
+namespace spectr::batch_app
+{
+/**
+ * @brief Main entry point for Spectr headless batch application.
+ * @details This class parses command line arguments, collects the input audio files, calculates
+ * their spectrograms on all CPU cores and writes them to spectrogram files, reporting the progress
+ * and the throughput. It doesn't use any graphics API.
+ */
+class SpectrBatchApp
+{
+public:
+    static int main(int argc, const char* argv[]);
+
+private:
+    static int mainImpl(int argc, const char* argv[]);
+
+    /**
+     * @brief Returns the input files with their output paths, a directory gives all its WAV files.
+     */
+    static std::vector<SpectrogramJob> collectJobs(const BatchAppSettings& settings);
+
+    static void printProgress(const BatchProgress& progress, bool isFinal);
+};
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <spectr/storage/SpectrogramStorageWriter.h>
+#include <spectr/utils/Timer.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace spectr::batch_app
+{
+struct SpectrogramJob
+{
+    std::filesystem::path inputPath;
+    std::filesystem::path outputPath;
+};
+
+struct BatchProgress
+{
+    size_t fileIndex = 0;
+    size_t fileCount = 0;
+    size_t fileFrameCount = 0;           // frames of the current file
+    size_t processedFileFrameCount = 0;  // frames of the current file written to the output
+    size_t processedFrameCount = 0;      // frames of all files written to the output
+    size_t processedSampleByteCount = 0; // float32 input samples of the written frames
+    size_t writtenByteCount = 0;
+    float elapsedTime = 0.0f; // seconds
+};
+
+/**
+ * @brief Calculates spectrograms of audio files as fast as the CPU allows.
+ * @details The frames of a file are split into batches, the threads claim the batches one by
+ * one and calculate them with their own FFT plans, the calculated batches are written to the
+ * output in order. The next file is loaded in the background while the current one is
+ * calculated.
+ */
+class SpectrogramBatchProcessor
+{
+public:
+    struct Settings
+    {
+        size_t fftSize = 0;
+        size_t hop = 0;
+        size_t threadCount = 0; // zero - count of hardware threads
+        size_t batchFrameCount = 0;
+        storage::ValueFormat valueFormat = storage::ValueFormat::Float32;
+        float minDecibels = 0.0f;
+        float maxDecibels = 0.0f;
+    };
+
+    using ProgressCallback = std::function<void(const BatchProgress&)>;
+
+    /**
+     * @param progressCallback Called periodically and after every file, from one of the
+     * calculation threads.
+     */
+    SpectrogramBatchProcessor(Settings settings, ProgressCallback progressCallback);
+
+    /**
+     * @brief Calculates spectrograms of the files, blocking call.
+     * @return Progress after the last file.
+     */
+    BatchProgress process(const std::vector<SpectrogramJob>& jobs);
+
+private:
+    size_t getFrameCount(size_t sampleCount) const;
+
+    /**
+     * @brief Calculates the frames of one file and writes them, blocking call.
+     */
+    void processFile(const std::vector<float>& samples, storage::SpectrogramStorageWriter& writer);
+
+    /**
+     * @brief Claims and calculates batches until none is left, runs in every calculation thread.
+     */
+    void calculateBatches(const std::vector<float>& samples,
+                          storage::SpectrogramStorageWriter& writer);
+
+    /**
+     * @brief Calls the progress callback if the report interval has passed, under the mutex.
+     */
+    void reportProgress(bool force);
+
+private:
+    Settings m_settings;
+    ProgressCallback m_progressCallback;
+    BatchProgress m_progress;
+    utils::Timer m_timer;
+    float m_lastReportTime = 0.0f;
+
+    std::atomic<size_t> m_nextBatchIndex = 0; // the next batch to calculate
+    std::atomic<bool> m_isFailed = false;
+    std::mutex m_mutex; // guards the writer, the progress and the members below
+    std::condition_variable m_batchWritten;
+    size_t m_writtenBatchCount = 0; // batches are written in order
+    std::exception_ptr m_error;     // the first error of the calculation threads
+};
+}
@@ -0,0 +1,120 @@
+#include <spectr/batch_app/CmdArgumentParser.h>
+
+#include <spectr/utils/Exception.h>
+
+#include <algorithm>
+#include <string>
+
+#include <stdarg.hpp>
+
+constexpr const char* help_options[]        = { "--help",           "-h" };
+constexpr const char* version_options[]     = { "--version",        "-v" };
+constexpr const char* input_path_options[]  = { "--input",          "-i" };
+constexpr const char* output_path_options[] = { "--output",         "-o" };
+constexpr const char* fft_power_options[]   = { "--fft-size-power", "-p" };
+constexpr const char* hop_options[]         = { "--hop",            "-s" };
+constexpr const char* overlap_options[]     = { "--overlap",        "-e" };
+constexpr const char* threads_options[]     = { "--threads",        "-t" };
+constexpr const char* batch_options[]       = { "--batch",          "-b" };
+constexpr const char* format_options[]      = { "--format",         "-f" };
+constexpr const char* min_db_options[]      = { "--min-db",         "-n" };
+constexpr const char* max_db_options[]      = { "--max-db",         "-x" };
+
+namespace spectr::batch_app
+{
+namespace
+{
+constexpr float DefaultOverlap = 0.5f;
+constexpr size_t DefaultBatchFrameCount = 64;
+
+storage::ValueFormat parseValueFormat(const std::string& str)
+{
+    if (str == "float")
+    {
+        return storage::ValueFormat::Float32;
+    }
+    if (str == "db8")
+    {
+        return storage::ValueFormat::Decibel8;
+    }
+    if (str == "db16")
+    {
+        return storage::ValueFormat::Decibel16;
+    }
+    throw utils::Exception("Unknown value format: {}, expected float, db8 or db16.", str);
+}
+}
+
+BatchAppSettings CmdArgumentParser::parse(int argc, const char* argv[])
+{
+    BatchAppSettings settings;
+
+    size_t fftSizePowerOfTwo = 12;
+    float overlap = -1.0f;
+    settings.batchFrameCount = DefaultBatchFrameCount;
+
+    stdarg::arg_parser parser({ (size_t)argc, argv }, "Spectr tool for offline spectrogram calculation");
+
+    std::string inputPath;
+    std::string outputPath;
+    std::string valueFormat;
+
+    parser << stdarg::option<void()>({        help_options[0],        help_options[1]        }, "show help message", [parser]() { stdarg::arg_parser::help(parser); })
+           << stdarg::option<void()>({        version_options[0],     version_options[1]     }, "show tool version", [&]() { settings.command = Command::PrintVersion; })
+           << stdarg::argument<std::string>({ input_path_options[0],  input_path_options[1]  }, "path of input WAV audio file or directory of them", "path", inputPath)
+           << stdarg::argument<std::string>({ output_path_options[0], output_path_options[1] }, "path of output spectrogram file, directory if the input is a directory", "path", outputPath)
+           << stdarg::argument<size_t>({      fft_power_options[0],   fft_power_options[1]   }, "power P of 2 of the FFT size - 2^P.", "P", fftSizePowerOfTwo)
+           << stdarg::argument<size_t>({      hop_options[0],         hop_options[1]         }, "samples between the starts of the following frames, sets the overlap", "samples", settings.hop)
+           << stdarg::argument<float>({       overlap_options[0],     overlap_options[1]     }, "share of a frame overlapped by the next one, in [0, 1), 0.5 by default", "overlap", overlap)
+           << stdarg::argument<size_t>({      threads_options[0],     threads_options[1]     }, "count of calculation threads, all hardware threads by default", "N", settings.threadCount)
+           << stdarg::argument<size_t>({      batch_options[0],       batch_options[1]       }, "count of frames calculated by a thread at once", "N", settings.batchFrameCount)
+           << stdarg::argument<std::string>({ format_options[0],      format_options[1]      }, "stored magnitude format (float/db8/db16)", "format", valueFormat)
+           << stdarg::argument<float>({       min_db_options[0],      min_db_options[1]      }, "lower bound of the decibel formats, quieter magnitudes are clamped", "dB", settings.minDecibels)
+           << stdarg::argument<float>({       max_db_options[0],      max_db_options[1]      }, "upper bound of the decibel formats, louder magnitudes are clamped", "dB", settings.maxDecibels);
+
+    parser();
+
+    settings.helpDescription = parser.getDescription();
+
+    if (settings.command == Command::PrintVersion) return settings;
+
+    if (inputPath.empty())
+    {
+        return settings;
+    }
+
+    settings.command = Command::Execute;
+    settings.inputPath = inputPath;
+    settings.outputPath = outputPath;
+    if (valueFormat != "") settings.valueFormat = parseValueFormat(valueFormat);
+
+    if (fftSizePowerOfTwo < 1 || fftSizePowerOfTwo > 30)
+    {
+        throw utils::Exception("Power of 2 of the FFT size must be in [1, 30], got {}.", fftSizePowerOfTwo);
+    }
+    settings.fftSize = size_t{ 1 } << fftSizePowerOfTwo;
+
+    if (settings.hop != 0 && overlap >= 0.0f)
+    {
+        throw utils::Exception("Only one of the hop and the overlap can be specified.");
+    }
+
+    if (overlap >= 1.0f)
+    {
+        throw utils::Exception("Frame overlap must be less than 1, got {}.", overlap);
+    }
+
+    if (settings.hop == 0)
+    {
+        const auto frameShare = 1.0f - (overlap >= 0.0f ? overlap : DefaultOverlap);
+        settings.hop = std::max<size_t>(1, static_cast<size_t>(settings.fftSize * frameShare));
+    }
+
+    if (settings.batchFrameCount == 0)
+    {
+        throw utils::Exception("Count of frames in a batch can't be zero.");
+    }
+
+    return settings;
+}
+}
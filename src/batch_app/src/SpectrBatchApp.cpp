@@ -0,0 +1,165 @@
+#include <spectr/batch_app/SpectrBatchApp.h>
+
+#include <spectr/batch_app/CmdArgumentParser.h>
+#include <spectr/utils/Exception.h>
+#include <spectr/utils/Version.h>
+
+#include <algorithm>
+#include <cctype>
+#include <format>
+#include <iostream>
+
+namespace spectr::batch_app
+{
+namespace
+{
+constexpr const char* SpectrogramFileExtension = ".spectr";
+constexpr double BytesInMegabyte = 1024.0 * 1024.0;
+
+bool isWavFile(const std::filesystem::path& path)
+{
+    auto extension = path.extension().string();
+    std::transform(extension.begin(),
+                   extension.end(),
+                   extension.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+    return extension == ".wav";
+}
+}
+
+int SpectrBatchApp::main(int argc, const char* argv[])
+{
+    try
+    {
+        return mainImpl(argc, argv);
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << "Uncaught exception: " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    catch (...)
+    {
+        std::cerr << "Uncaught non-exception throw." << std::endl;
+        return EXIT_FAILURE;
+    }
+}
+
+int SpectrBatchApp::mainImpl(int argc, const char* argv[])
+{
+    const auto settings = CmdArgumentParser::parse(argc, argv);
+
+    if (settings.command == Command::PrintHelp)
+    {
+        std::cout << settings.helpDescription;
+        return EXIT_SUCCESS;
+    }
+
+    if (settings.command == Command::PrintVersion)
+    {
+        utils::Version::print(std::cout, "Spectr batch spectrogram calculation");
+        return EXIT_SUCCESS;
+    }
+
+    const auto jobs = collectJobs(settings);
+    std::cout << std::format("Files: {}, FFT size: {}, hop: {}\n",
+                             jobs.size(),
+                             settings.fftSize,
+                             settings.hop);
+
+    SpectrogramBatchProcessor processor{
+        SpectrogramBatchProcessor::Settings{
+          .fftSize = settings.fftSize,
+          .hop = settings.hop,
+          .threadCount = settings.threadCount,
+          .batchFrameCount = settings.batchFrameCount,
+          .valueFormat = settings.valueFormat,
+          .minDecibels = settings.minDecibels,
+          .maxDecibels = settings.maxDecibels,
+        },
+        [](const BatchProgress& progress) { printProgress(progress, false); },
+    };
+
+    const auto progress = processor.process(jobs);
+    printProgress(progress, true);
+
+    return EXIT_SUCCESS;
+}
+
+std::vector<SpectrogramJob> SpectrBatchApp::collectJobs(const BatchAppSettings& settings)
+{
+    if (!std::filesystem::is_directory(settings.inputPath))
+    {
+        auto outputPath = settings.outputPath;
+        if (outputPath.empty())
+        {
+            outputPath = settings.inputPath;
+            outputPath.replace_extension(SpectrogramFileExtension);
+        }
+        return { SpectrogramJob{ .inputPath = settings.inputPath, .outputPath = outputPath } };
+    }
+
+    const auto outputDirectory =
+      settings.outputPath.empty() ? settings.inputPath : settings.outputPath;
+    std::filesystem::create_directories(outputDirectory);
+
+    std::vector<SpectrogramJob> jobs;
+    for (const auto& entry : std::filesystem::directory_iterator{ settings.inputPath })
+    {
+        if (!entry.is_regular_file() || !isWavFile(entry.path()))
+        {
+            continue;
+        }
+
+        auto outputPath = outputDirectory / entry.path().filename();
+        outputPath.replace_extension(SpectrogramFileExtension);
+        jobs.push_back(SpectrogramJob{ .inputPath = entry.path(), .outputPath = outputPath });
+    }
+
+    if (jobs.empty())
+    {
+        throw utils::Exception("No WAV files in the input directory: {}",
+                               settings.inputPath.string());
+    }
+
+    std::sort(jobs.begin(),
+              jobs.end(),
+              [](const auto& a, const auto& b) { return a.inputPath < b.inputPath; });
+
+    return jobs;
+}
+
+void SpectrBatchApp::printProgress(const BatchProgress& progress, bool isFinal)
+{
+    const auto time = std::max(progress.elapsedTime, 1e-6f);
+    const auto framesPerSecond = progress.processedFrameCount / time;
+    const auto inputMegabytesPerSecond = progress.processedSampleByteCount / BytesInMegabyte / time;
+    const auto outputMegabytesPerSecond = progress.writtenByteCount / BytesInMegabyte / time;
+
+    if (isFinal)
+    {
+        std::cout << std::format("\nDone in {:.2f} s: {} frames, {:.0f} frames/s, input {:.1f} "
+                                 "MB/s, output {:.1f} MB/s\n",
+                                 progress.elapsedTime,
+                                 progress.processedFrameCount,
+                                 framesPerSecond,
+                                 inputMegabytesPerSecond,
+                                 outputMegabytesPerSecond);
+        return;
+    }
+
+    const auto filePercent =
+      progress.fileFrameCount > 0
+        ? 100.0f * progress.processedFileFrameCount / progress.fileFrameCount
+        : 100.0f;
+    std::cout << std::format("\rFile {}/{}: {:5.1f}%, {:.0f} frames/s, input {:.1f} MB/s, "
+                             "output {:.1f} MB/s",
+                             progress.fileIndex + 1,
+                             progress.fileCount,
+                             filePercent,
+                             framesPerSecond,
+                             inputMegabytesPerSecond,
+                             outputMegabytesPerSecond)
+              << std::flush;
+}
+}
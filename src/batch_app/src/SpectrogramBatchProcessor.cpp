@@ -0,0 +1,226 @@
+#include <spectr/batch_app/SpectrogramBatchProcessor.h>
+
+#include <spectr/audio_loader/AudioLoader.h>
+#include <spectr/calc_cpu/FftCooleyTukeyRadix2Plan.h>
+#include <spectr/utils/Assert.h>
+
+#include <algorithm>
+#include <future>
+#include <thread>
+#include <variant>
+
+namespace spectr::batch_app
+{
+namespace
+{
+constexpr float ProgressReportInterval = 0.5f; // seconds
+
+struct LoadedFile
+{
+    std::vector<float> samples; // channel 0
+    size_t sampleRate = 0;
+};
+
+LoadedFile loadFile(const std::filesystem::path& path)
+{
+    const auto signal = audio_loader::AudioLoader::load(path);
+
+    LoadedFile file;
+    file.sampleRate = signal.getSampleRate();
+    std::visit(
+      [&file](const auto& values)
+      {
+          file.samples.resize(values.size());
+          std::transform(values.begin(),
+                         values.end(),
+                         file.samples.begin(),
+                         [](auto value) { return static_cast<float>(value); });
+      },
+      signal.getChannelSampleData(0));
+
+    return file;
+}
+}
+
+SpectrogramBatchProcessor::SpectrogramBatchProcessor(Settings settings,
+                                                     ProgressCallback progressCallback)
+  : m_settings{ settings }
+  , m_progressCallback{ std::move(progressCallback) }
+{
+    ASSERT(m_settings.fftSize > 0);
+    ASSERT(m_settings.hop > 0);
+    ASSERT(m_settings.batchFrameCount > 0);
+
+    if (m_settings.threadCount == 0)
+    {
+        m_settings.threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+BatchProgress SpectrogramBatchProcessor::process(const std::vector<SpectrogramJob>& jobs)
+{
+    m_progress = BatchProgress{};
+    m_progress.fileCount = jobs.size();
+    m_timer.restart();
+    m_lastReportTime = 0.0f;
+
+    if (jobs.empty())
+    {
+        return m_progress;
+    }
+
+    // the next file is loaded while the current one is calculated
+    auto nextFile = std::async(std::launch::async, loadFile, jobs.front().inputPath);
+    for (size_t i = 0; i < jobs.size(); ++i)
+    {
+        const auto file = nextFile.get();
+        if (i + 1 < jobs.size())
+        {
+            nextFile = std::async(std::launch::async, loadFile, jobs[i + 1].inputPath);
+        }
+
+        storage::SpectrogramStorageWriter writer{
+            jobs[i].outputPath,
+            storage::SpectrogramStorageSettings{
+              .binCount = m_settings.fftSize / 2,
+              .fftSize = m_settings.fftSize,
+              .hop = m_settings.hop,
+              .sampleRate = file.sampleRate,
+              .valueFormat = m_settings.valueFormat,
+              .minDecibels = m_settings.minDecibels,
+              .maxDecibels = m_settings.maxDecibels,
+            },
+        };
+
+        m_progress.fileIndex = i;
+        m_progress.fileFrameCount = getFrameCount(file.samples.size());
+        m_progress.processedFileFrameCount = 0;
+        m_progress.writtenByteCount += writer.getWrittenByteCount();
+
+        processFile(file.samples, writer);
+
+        const auto writtenByteCount = writer.getWrittenByteCount();
+        writer.close();
+        m_progress.writtenByteCount += writer.getWrittenByteCount() - writtenByteCount;
+
+        reportProgress(true);
+    }
+
+    return m_progress;
+}
+
+size_t SpectrogramBatchProcessor::getFrameCount(size_t sampleCount) const
+{
+    if (sampleCount < m_settings.fftSize)
+    {
+        return 0;
+    }
+    return (sampleCount - m_settings.fftSize) / m_settings.hop + 1;
+}
+
+void SpectrogramBatchProcessor::processFile(const std::vector<float>& samples,
+                                            storage::SpectrogramStorageWriter& writer)
+{
+    const auto batchCount =
+      (getFrameCount(samples.size()) + m_settings.batchFrameCount - 1) / m_settings.batchFrameCount;
+
+    m_nextBatchIndex = 0;
+    m_writtenBatchCount = 0;
+    m_isFailed = false;
+    m_error = nullptr;
+
+    {
+        const auto threadCount = std::min(m_settings.threadCount, batchCount);
+        std::vector<std::jthread> threads;
+        threads.reserve(threadCount);
+        for (size_t i = 0; i < threadCount; ++i)
+        {
+            threads.emplace_back([this, &samples, &writer]()
+                                 { calculateBatches(samples, writer); });
+        }
+    }
+
+    if (m_error)
+    {
+        std::rethrow_exception(m_error);
+    }
+}
+
+void SpectrogramBatchProcessor::calculateBatches(const std::vector<float>& samples,
+                                                 storage::SpectrogramStorageWriter& writer)
+{
+    try
+    {
+        const auto frameCount = getFrameCount(samples.size());
+        const auto binCount = writer.getBinCount();
+
+        calc_cpu::FftCooleyTukeyRadix2Plan plan{ m_settings.fftSize };
+        std::vector<float> magnitudes(m_settings.batchFrameCount * binCount);
+
+        while (!m_isFailed)
+        {
+            const auto batchIndex = m_nextBatchIndex++;
+            const auto firstFrameIndex = batchIndex * m_settings.batchFrameCount;
+            if (firstFrameIndex >= frameCount)
+            {
+                return;
+            }
+
+            const auto batchFrameCount =
+              std::min(m_settings.batchFrameCount, frameCount - firstFrameIndex);
+            for (size_t i = 0; i < batchFrameCount; ++i)
+            {
+                const auto* frame = samples.data() + (firstFrameIndex + i) * m_settings.hop;
+                plan.calculateMagnitudes(frame, magnitudes.data() + i * binCount);
+            }
+
+            // the batches finished out of order wait for the previous ones to be written
+            std::unique_lock lock{ m_mutex };
+            m_batchWritten.wait(lock,
+                                [&]() { return m_isFailed || m_writtenBatchCount == batchIndex; });
+            if (m_isFailed)
+            {
+                return;
+            }
+
+            const auto writtenByteCount = writer.getWrittenByteCount();
+            writer.appendColumns(magnitudes.data(), batchFrameCount);
+            ++m_writtenBatchCount;
+
+            m_progress.processedFileFrameCount += batchFrameCount;
+            m_progress.processedFrameCount += batchFrameCount;
+            m_progress.processedSampleByteCount += batchFrameCount * m_settings.hop * sizeof(float);
+            m_progress.writtenByteCount += writer.getWrittenByteCount() - writtenByteCount;
+            reportProgress(false);
+
+            m_batchWritten.notify_all();
+        }
+    }
+    catch (...)
+    {
+        std::lock_guard lock{ m_mutex };
+        if (!m_error)
+        {
+            m_error = std::current_exception();
+        }
+        m_isFailed = true;
+        m_batchWritten.notify_all();
+    }
+}
+
+void SpectrogramBatchProcessor::reportProgress(bool force)
+{
+    const auto time = m_timer.getTime();
+    if (!force && time - m_lastReportTime < ProgressReportInterval)
+    {
+        return;
+    }
+
+    m_lastReportTime = time;
+    m_progress.elapsedTime = time;
+    if (m_progressCallback)
+    {
+        m_progressCallback(m_progress);
+    }
+}
+}
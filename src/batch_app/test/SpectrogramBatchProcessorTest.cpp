@@ -0,0 +1,118 @@
+#include <spectr/batch_app/SpectrogramBatchProcessor.h>
+
+#include <spectr/calc_cpu/FftCooleyTukeyRadix2Plan.h>
+#include <spectr/storage/SpectrogramStorageReader.h>
+#include <spectr/utils/Math.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace spectr::batch_app::test
+{
+namespace
+{
+constexpr size_t FftSize = 256;
+constexpr size_t Hop = 200;
+constexpr size_t BatchFrameCount = 7; // the last batch is partial
+constexpr size_t SampleCount = 40000;
+constexpr uint32_t SampleRate = 8000;
+
+template<typename T>
+void writeValue(std::ofstream& file, T value)
+{
+    file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+/**
+ * @brief Writes a mono 16-bit WAVE file of a chirp, so every column of it is different.
+ */
+std::vector<int16_t> writeChirp(const std::filesystem::path& path)
+{
+    std::vector<int16_t> samples(SampleCount);
+    for (size_t i = 0; i < samples.size(); ++i)
+    {
+        const auto time = static_cast<double>(i) / SampleRate;
+        const auto phase = utils::Math::PI * 800.0 * time * time; // 0 to 4 kHz in 5 seconds
+        samples[i] = static_cast<int16_t>(16000.0 * std::sin(phase));
+    }
+
+    const auto dataSize = static_cast<uint32_t>(samples.size() * sizeof(int16_t));
+    std::ofstream file{ path, std::ios_base::binary };
+    file.write("RIFF", 4);
+    writeValue<uint32_t>(file, 36 + dataSize);
+    file.write("WAVEfmt ", 8);
+    writeValue<uint32_t>(file, 16);
+    writeValue<uint16_t>(file, 1); // PCM
+    writeValue<uint16_t>(file, 1); // channels
+    writeValue<uint32_t>(file, SampleRate);
+    writeValue<uint32_t>(file, SampleRate * sizeof(int16_t));
+    writeValue<uint16_t>(file, sizeof(int16_t));
+    writeValue<uint16_t>(file, 16);
+    file.write("data", 4);
+    writeValue<uint32_t>(file, dataSize);
+    file.write(reinterpret_cast<const char*>(samples.data()), dataSize);
+
+    return samples;
+}
+
+/**
+ * @brief Returns magnitudes of all frames of the samples calculated one after another.
+ */
+std::vector<float> calculateReference(const std::vector<int16_t>& values, size_t& frameCount)
+{
+    const std::vector<float> samples(values.begin(), values.end());
+
+    frameCount = (samples.size() - FftSize) / Hop + 1;
+    constexpr size_t BinCount = FftSize / 2;
+    std::vector<float> magnitudes(frameCount * BinCount);
+
+    calc_cpu::FftCooleyTukeyRadix2Plan plan{ FftSize };
+    for (size_t i = 0; i < frameCount; ++i)
+    {
+        plan.calculateMagnitudes(samples.data() + i * Hop, magnitudes.data() + i * BinCount);
+    }
+    return magnitudes;
+}
+}
+
+TEST(SpectrogramBatchProcessor, WritesColumnsInOrderFromManyThreads)
+{
+    const auto tempDir = std::filesystem::temp_directory_path();
+    const auto inputPath = tempDir / "spectr_batch_processor_test.wav";
+    const auto outputPath = tempDir / "spectr_batch_processor_test.spectr";
+    const auto samples = writeChirp(inputPath);
+
+    SpectrogramBatchProcessor processor{
+        SpectrogramBatchProcessor::Settings{
+          .fftSize = FftSize,
+          .hop = Hop,
+          .threadCount = 4,
+          .batchFrameCount = BatchFrameCount,
+        },
+        nullptr,
+    };
+    const auto progress = processor.process({ { inputPath, outputPath } });
+
+    size_t frameCount = 0;
+    const auto expected = calculateReference(samples, frameCount);
+    EXPECT_EQ(progress.processedFrameCount, frameCount);
+
+    {
+        storage::SpectrogramStorageReader reader{ outputPath };
+        ASSERT_EQ(reader.getColumnCount(0), frameCount);
+        ASSERT_EQ(reader.getBinCount(0), FftSize / 2);
+
+        std::vector<float> actual(expected.size());
+        reader.readColumns(0, storage::TilePlane::Max, 0, frameCount, actual.data());
+        EXPECT_EQ(actual, expected);
+    }
+
+    std::filesystem::remove(inputPath);
+    std::filesystem::remove(outputPath);
+}
+}
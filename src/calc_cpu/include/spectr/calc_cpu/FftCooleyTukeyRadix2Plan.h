@@ -0,0 +1,46 @@
+#pragma once
+
+#include <complex>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace spectr::calc_cpu
+{
+/**
+ * @brief Radix-2 FFT of a fixed size for calculating many transforms in a row.
+ * @details The bit reversal permutation and the twiddle factors are calculated once in the
+ * constructor and the work buffer is reused, so a transform doesn't allocate. Not thread-safe,
+ * every thread needs its own plan.
+ */
+class FftCooleyTukeyRadix2Plan
+{
+public:
+    /**
+     * @param fftSize Count of the input values, power of 2.
+     */
+    explicit FftCooleyTukeyRadix2Plan(size_t fftSize);
+
+    size_t getFftSize() const;
+
+    /**
+     * @brief Calculates FFT of the real values.
+     * @param realValues FFT size values.
+     * @return FFT size complex values, valid until the next call.
+     */
+    std::span<const std::complex<float>> execute(const float* realValues);
+
+    /**
+     * @brief Calculates FFT of the real values and magnitudes of the first half of frequencies,
+     * the same as FftCooleyTukeyRadix2::getMagnitudesFromFFT().
+     * @param magnitudes Destination of FFT size / 2 values.
+     */
+    void calculateMagnitudes(const float* realValues, float* magnitudes);
+
+private:
+    const size_t m_fftSize;
+    std::vector<uint32_t> m_bitReversedIndices;
+    std::vector<std::complex<float>> m_omegas; // exp(-2 * pi * i * k / FFT size), k < size / 2
+    std::vector<std::complex<float>> m_values;
+};
+}
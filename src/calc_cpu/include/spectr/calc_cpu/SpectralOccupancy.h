@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <vector>
+
+namespace spectr::calc_cpu
+{
+/**
+ * @brief Value of SpectralOccupancyBin::framesSinceLastSeen of a bin never above the threshold.
+ */
+constexpr uint32_t SpectralOccupancyNeverSeen = std::numeric_limits<uint32_t>::max();
+
+/**
+ * @brief Occupancy statistics of a frequency bin, a bin is occupied in a frame if its dBFS value
+ * is above the threshold.
+ */
+struct SpectralOccupancyBin
+{
+    float occupancy = 0.0f; // fraction of the frames since the reset with the bin occupied
+    float dutyCycle = 0.0f; // fraction of the recent frames with the bin occupied, see below
+    uint32_t framesSinceLastSeen = SpectralOccupancyNeverSeen; // 0 - occupied in the last frame
+};
+
+/**
+ * @brief CPU reference implementation of the spectral occupancy, updated from the dBFS values of
+ * frames without keeping them.
+ * @details The duty cycle of frame k is dc + (occupied - dc) / min(k, duty cycle frame count):
+ * the exact fraction until the count of frames reaches the duty cycle frame count, then the
+ * exponential average, so it follows the recent activity while the occupancy is the fraction
+ * over the whole time since the reset.
+ */
+class SpectralOccupancyCalculator
+{
+public:
+    SpectralOccupancyCalculator(size_t frequencyCount,
+                                float thresholdDbfs,
+                                size_t dutyCycleFrameCount);
+
+    void update(const std::vector<float>& dbfsValues);
+
+    void reset();
+
+    std::vector<SpectralOccupancyBin> getBins() const;
+
+    size_t getFrameCount() const;
+
+    /**
+     * @brief Returns weight of the new frame in the duty cycle.
+     * @param frameIndex Index of the new frame since the reset.
+     */
+    static float getDutyCycleWeight(size_t frameIndex, size_t dutyCycleFrameCount);
+
+private:
+    const float m_thresholdDbfs;
+    const size_t m_dutyCycleFrameCount;
+    std::vector<uint32_t> m_occupiedFrameCounts;
+    std::vector<float> m_dutyCycles;
+    std::vector<uint32_t> m_framesSinceLastSeen;
+    size_t m_frameCount = 0;
+};
+
+/**
+ * @brief Writes the statistics as CSV with a header line: frequency in Hz, occupancy and duty
+ * cycle in percents, time since the bin was last seen in seconds (empty if never).
+ * @param firstBinFrequency Frequency of the first bin in Hz.
+ * @param binWidth Frequency step between the bins in Hz.
+ * @param frameDuration Time between the frames in seconds.
+ */
+void writeSpectralOccupancyCsv(std::ostream& stream,
+                               const std::vector<SpectralOccupancyBin>& bins,
+                               float firstBinFrequency,
+                               float binWidth,
+                               float frameDuration);
+}
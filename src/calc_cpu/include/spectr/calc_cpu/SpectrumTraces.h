@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <string_view>
+#include <vector>
+
+namespace spectr::calc_cpu
+{
+/**
+ * @brief Classic spectrum analyzer traces, the value is the index of the trace.
+ */
+enum class SpectrumTraceType
+{
+    Live,    // the latest frame
+    MaxHold, // max of every bin since the reset
+    MinHold, // min of every bin since the reset
+    Average, // running average over the last frames, see SpectrumAverageMode
+};
+
+constexpr size_t SpectrumTraceCount = 4;
+
+/**
+ * @brief Domain the Average trace is calculated in.
+ */
+enum class SpectrumAverageMode
+{
+    Rms,    // average of the power, 10^(dBFS / 10)
+    Linear, // average of the magnitude, 10^(dBFS / 20)
+};
+
+std::string_view getSpectrumTraceName(SpectrumTraceType type);
+
+/**
+ * @brief CPU reference implementation of the spectrum traces, calculated from the dBFS values of
+ * frames.
+ * @details The average of frame k is avg + (value - avg) / min(k, average frame count): the exact
+ * mean until the count of frames reaches the average frame count, then the exponential average.
+ */
+class SpectrumTraceCalculator
+{
+public:
+    SpectrumTraceCalculator(size_t frequencyCount,
+                            size_t averageFrameCount,
+                            SpectrumAverageMode averageMode);
+
+    void update(const std::vector<float>& dbfsValues);
+
+    /**
+     * @brief Restarts the hold and the average traces from the next frame.
+     */
+    void reset();
+
+    /**
+     * @brief Returns dBFS values of the trace.
+     */
+    const std::vector<float>& getTrace(SpectrumTraceType type) const;
+
+    size_t getFrameCount() const;
+
+    /**
+     * @brief Returns weight of the new frame in the average.
+     * @param frameIndex Index of the new frame since the reset.
+     */
+    static float getAverageWeight(size_t frameIndex, size_t averageFrameCount);
+
+    /**
+     * @brief Lowest dBFS value of the traces, the same as of the dBFS conversion of the zero
+     * magnitude.
+     */
+    static constexpr float MinDbfs = -10000.0f;
+
+private:
+    const size_t m_averageFrameCount;
+    const SpectrumAverageMode m_averageMode;
+    std::array<std::vector<float>, SpectrumTraceCount> m_traces;
+    std::vector<float> m_averageState; // linear average of the power or the magnitude
+    size_t m_frameCount = 0;
+};
+}
@@ -0,0 +1,81 @@
+#include <spectr/calc_cpu/FftCooleyTukeyRadix2Plan.h>
+
+#include <spectr/utils/Exception.h>
+#include <spectr/utils/Math.h>
+
+#include <cmath>
+
+namespace spectr::calc_cpu
+{
+FftCooleyTukeyRadix2Plan::FftCooleyTukeyRadix2Plan(size_t fftSize)
+  : m_fftSize{ fftSize }
+  , m_bitReversedIndices(fftSize)
+  , m_omegas(fftSize / 2)
+  , m_values(fftSize)
+{
+    size_t powerOfTwo = 0;
+    if (fftSize < 2 || !utils::Math::isPowerOfTwo(fftSize, powerOfTwo))
+    {
+        throw utils::Exception("FFT size must be power of 2 and at least 2. Size: {}", fftSize);
+    }
+
+    for (size_t i = 0; i < fftSize; ++i)
+    {
+        uint32_t reversed = 0;
+        for (size_t bit = 0; bit < powerOfTwo; ++bit)
+        {
+            reversed |= ((i >> bit) & 1) << (powerOfTwo - 1 - bit);
+        }
+        m_bitReversedIndices[i] = reversed;
+    }
+
+    // in double precision, so the error doesn't accumulate like in the repeated multiplication
+    for (size_t k = 0; k < m_omegas.size(); ++k)
+    {
+        const auto angle = -2.0 * utils::Math::PI * static_cast<double>(k) / fftSize;
+        m_omegas[k] = { static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle)) };
+    }
+}
+
+size_t FftCooleyTukeyRadix2Plan::getFftSize() const
+{
+    return m_fftSize;
+}
+
+std::span<const std::complex<float>> FftCooleyTukeyRadix2Plan::execute(const float* realValues)
+{
+    for (size_t i = 0; i < m_fftSize; ++i)
+    {
+        m_values[m_bitReversedIndices[i]] = realValues[i];
+    }
+
+    for (size_t subFftSize = 2; subFftSize <= m_fftSize; subFftSize *= 2)
+    {
+        const auto subFftHalfSize = subFftSize / 2;
+        const auto omegaStride = m_fftSize / subFftSize;
+
+        for (size_t subFftStart = 0; subFftStart < m_fftSize; subFftStart += subFftSize)
+        {
+            auto* values1 = m_values.data() + subFftStart;
+            auto* values2 = values1 + subFftHalfSize;
+            for (size_t k = 0; k < subFftHalfSize; ++k)
+            {
+                const auto omegaX2 = m_omegas[k * omegaStride] * values2[k];
+                values2[k] = values1[k] - omegaX2;
+                values1[k] += omegaX2;
+            }
+        }
+    }
+
+    return m_values;
+}
+
+void FftCooleyTukeyRadix2Plan::calculateMagnitudes(const float* realValues, float* magnitudes)
+{
+    const auto fft = execute(realValues);
+    for (size_t i = 0; i < m_fftSize / 2; ++i)
+    {
+        magnitudes[i] = 2.0f * std::abs(fft[i]);
+    }
+}
+}
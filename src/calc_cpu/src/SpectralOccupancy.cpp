@@ -0,0 +1,101 @@
+#include <spectr/calc_cpu/SpectralOccupancy.h>
+
+#include <spectr/utils/Assert.h>
+
+#include <algorithm>
+
+namespace spectr::calc_cpu
+{
+SpectralOccupancyCalculator::SpectralOccupancyCalculator(size_t frequencyCount,
+                                                         float thresholdDbfs,
+                                                         size_t dutyCycleFrameCount)
+  : m_thresholdDbfs{ thresholdDbfs }
+  , m_dutyCycleFrameCount{ dutyCycleFrameCount }
+  , m_occupiedFrameCounts(frequencyCount, 0)
+  , m_dutyCycles(frequencyCount, 0.0f)
+  , m_framesSinceLastSeen(frequencyCount, SpectralOccupancyNeverSeen)
+{
+    ASSERT(m_dutyCycleFrameCount > 0);
+}
+
+void SpectralOccupancyCalculator::update(const std::vector<float>& dbfsValues)
+{
+    ASSERT(dbfsValues.size() == m_dutyCycles.size());
+
+    const auto weight = getDutyCycleWeight(m_frameCount, m_dutyCycleFrameCount);
+    for (size_t i = 0; i < dbfsValues.size(); ++i)
+    {
+        const auto isOccupied = dbfsValues[i] > m_thresholdDbfs;
+        const auto occupied = isOccupied ? 1.0f : 0.0f;
+
+        m_occupiedFrameCounts[i] += isOccupied ? 1 : 0;
+        m_dutyCycles[i] += (occupied - m_dutyCycles[i]) * weight;
+
+        auto& framesSinceLastSeen = m_framesSinceLastSeen[i];
+        if (isOccupied)
+        {
+            framesSinceLastSeen = 0;
+        }
+        else if (framesSinceLastSeen < SpectralOccupancyNeverSeen - 1)
+        {
+            ++framesSinceLastSeen;
+        }
+    }
+
+    ++m_frameCount;
+}
+
+void SpectralOccupancyCalculator::reset()
+{
+    std::fill(m_occupiedFrameCounts.begin(), m_occupiedFrameCounts.end(), 0);
+    std::fill(m_dutyCycles.begin(), m_dutyCycles.end(), 0.0f);
+    std::fill(
+      m_framesSinceLastSeen.begin(), m_framesSinceLastSeen.end(), SpectralOccupancyNeverSeen);
+    m_frameCount = 0;
+}
+
+std::vector<SpectralOccupancyBin> SpectralOccupancyCalculator::getBins() const
+{
+    std::vector<SpectralOccupancyBin> bins(m_dutyCycles.size());
+    for (size_t i = 0; i < bins.size(); ++i)
+    {
+        bins[i].occupancy = m_frameCount == 0 ? 0.0f
+                                              : static_cast<float>(m_occupiedFrameCounts[i]) /
+                                                  static_cast<float>(m_frameCount);
+        bins[i].dutyCycle = m_dutyCycles[i];
+        bins[i].framesSinceLastSeen = m_framesSinceLastSeen[i];
+    }
+    return bins;
+}
+
+size_t SpectralOccupancyCalculator::getFrameCount() const
+{
+    return m_frameCount;
+}
+
+float SpectralOccupancyCalculator::getDutyCycleWeight(size_t frameIndex,
+                                                      size_t dutyCycleFrameCount)
+{
+    return 1.0f / static_cast<float>(std::min(frameIndex + 1, dutyCycleFrameCount));
+}
+
+void writeSpectralOccupancyCsv(std::ostream& stream,
+                               const std::vector<SpectralOccupancyBin>& bins,
+                               float firstBinFrequency,
+                               float binWidth,
+                               float frameDuration)
+{
+    stream << "frequency_hz,occupancy_percent,duty_cycle_percent,last_seen_s\n";
+    for (size_t i = 0; i < bins.size(); ++i)
+    {
+        const auto& bin = bins[i];
+        stream << firstBinFrequency + static_cast<float>(i) * binWidth << ',' << bin.occupancy * 100.0f << ','
+               << bin.dutyCycle * 100.0f << ',';
+        if (bin.framesSinceLastSeen != SpectralOccupancyNeverSeen)
+        {
+            stream << static_cast<float>(bin.framesSinceLastSeen) * frameDuration;
+        }
+        stream << '\n';
+    }
+}
+}
@@ -0,0 +1,87 @@
+#include <spectr/calc_cpu/SpectrumTraces.h>
+
+#include <spectr/utils/Assert.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace spectr::calc_cpu
+{
+std::string_view getSpectrumTraceName(SpectrumTraceType type)
+{
+    switch (type)
+    {
+    case SpectrumTraceType::Live:
+        return "Live";
+    case SpectrumTraceType::MaxHold:
+        return "Max hold";
+    case SpectrumTraceType::MinHold:
+        return "Min hold";
+    case SpectrumTraceType::Average:
+        return "Average";
+    }
+    return "Unknown";
+}
+
+SpectrumTraceCalculator::SpectrumTraceCalculator(size_t frequencyCount,
+                                                 size_t averageFrameCount,
+                                                 SpectrumAverageMode averageMode)
+  : m_averageFrameCount{ averageFrameCount }
+  , m_averageMode{ averageMode }
+  , m_averageState(frequencyCount, 0.0f)
+{
+    ASSERT(m_averageFrameCount > 0);
+    for (auto& trace : m_traces)
+    {
+        trace.resize(frequencyCount, MinDbfs);
+    }
+}
+
+void SpectrumTraceCalculator::update(const std::vector<float>& dbfsValues)
+{
+    ASSERT(dbfsValues.size() == m_averageState.size());
+
+    auto& live = m_traces[static_cast<size_t>(SpectrumTraceType::Live)];
+    auto& maxHold = m_traces[static_cast<size_t>(SpectrumTraceType::MaxHold)];
+    auto& minHold = m_traces[static_cast<size_t>(SpectrumTraceType::MinHold)];
+    auto& average = m_traces[static_cast<size_t>(SpectrumTraceType::Average)];
+
+    const auto dbfsScale = m_averageMode == SpectrumAverageMode::Rms ? 10.0f : 20.0f;
+    const auto weight = getAverageWeight(m_frameCount, m_averageFrameCount);
+    const auto isFirstFrame = m_frameCount == 0;
+
+    for (size_t i = 0; i < dbfsValues.size(); ++i)
+    {
+        const auto dbfs = dbfsValues[i];
+        live[i] = dbfs;
+        maxHold[i] = isFirstFrame ? dbfs : std::max(maxHold[i], dbfs);
+        minHold[i] = isFirstFrame ? dbfs : std::min(minHold[i], dbfs);
+
+        const auto value = std::pow(10.0f, dbfs / dbfsScale);
+        m_averageState[i] += (value - m_averageState[i]) * weight;
+        average[i] = std::max(dbfsScale * std::log10(m_averageState[i]), MinDbfs);
+    }
+
+    ++m_frameCount;
+}
+
+void SpectrumTraceCalculator::reset()
+{
+    m_frameCount = 0;
+}
+
+const std::vector<float>& SpectrumTraceCalculator::getTrace(SpectrumTraceType type) const
+{
+    return m_traces[static_cast<size_t>(type)];
+}
+
+size_t SpectrumTraceCalculator::getFrameCount() const
+{
+    return m_frameCount;
+}
+
+float SpectrumTraceCalculator::getAverageWeight(size_t frameIndex, size_t averageFrameCount)
+{
+    return 1.0f / static_cast<float>(std::min(frameIndex + 1, averageFrameCount));
+}
+}
@@ -0,0 +1,51 @@
+#include <spectr/calc_cpu/FftCooleyTukeyRadix2.h>
+#include <spectr/calc_cpu/FftCooleyTukeyRadix2Plan.h>
+
+#include <spectr/utils/Exception.h>
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+namespace spectr::calc_cpu::test
+{
+TEST(FftCooleyTukeyRadix2PlanTest, MatchesFft)
+{
+    constexpr size_t FftSize = 1024;
+
+    std::mt19937 generator{ 7 };
+    std::uniform_real_distribution<float> distribution{ -1.0f, 1.0f };
+    std::vector<float> values(FftSize);
+    for (auto& value : values)
+    {
+        value = distribution(generator);
+    }
+
+    FftCooleyTukeyRadix2Plan plan{ FftSize };
+    const auto expected = FftCooleyTukeyRadix2::getFFT(values);
+
+    // the plan is reused, the second transform must not depend on the first one
+    plan.execute(values.data());
+    const auto fft = plan.execute(values.data());
+    ASSERT_EQ(fft.size(), FftSize);
+    for (size_t i = 0; i < FftSize; ++i)
+    {
+        EXPECT_NEAR(fft[i].real(), expected[i].real(), 1e-3f);
+        EXPECT_NEAR(fft[i].imag(), expected[i].imag(), 1e-3f);
+    }
+
+    std::vector<float> magnitudes(FftSize / 2);
+    plan.calculateMagnitudes(values.data(), magnitudes.data());
+    const auto expectedMagnitudes = FftCooleyTukeyRadix2::getMagnitudesFromFFT(expected);
+    for (size_t i = 0; i < FftSize / 2; ++i)
+    {
+        EXPECT_NEAR(magnitudes[i], expectedMagnitudes[i], 2e-3f);
+    }
+}
+
+TEST(FftCooleyTukeyRadix2PlanTest, RejectsNonPowerOfTwoSize)
+{
+    EXPECT_THROW(FftCooleyTukeyRadix2Plan{ 12 }, utils::Exception);
+    EXPECT_THROW(FftCooleyTukeyRadix2Plan{ 1 }, utils::Exception);
+}
+}
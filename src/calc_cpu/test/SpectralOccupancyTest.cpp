@@ -0,0 +1,54 @@
+#include <spectr/calc_cpu/SpectralOccupancy.h>
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+namespace spectr::calc_cpu::test
+{
+namespace
+{
+constexpr float Eps = 1e-5f;
+constexpr float ThresholdDbfs = -60.0f;
+}
+
+TEST(SpectralOccupancyCalculatorTest, CountsOccupiedFrames)
+{
+    SpectralOccupancyCalculator calculator{ 3, ThresholdDbfs, 2 };
+    calculator.update({ -10.0f, -80.0f, -80.0f });
+    calculator.update({ -10.0f, -20.0f, -80.0f });
+    calculator.update({ -80.0f, -80.0f, -80.0f });
+    calculator.update({ -10.0f, -80.0f, -80.0f });
+
+    const auto bins = calculator.getBins();
+    EXPECT_NEAR(bins[0].occupancy, 0.75f, Eps);
+    EXPECT_NEAR(bins[1].occupancy, 0.25f, Eps);
+    EXPECT_NEAR(bins[2].occupancy, 0.0f, Eps);
+
+    // duty cycle of 2 frames: 1, 1, 0.5, 0.75
+    EXPECT_NEAR(bins[0].dutyCycle, 0.75f, Eps);
+    // 0, 0.5, 0.25, 0.125
+    EXPECT_NEAR(bins[1].dutyCycle, 0.125f, Eps);
+
+    EXPECT_EQ(bins[0].framesSinceLastSeen, 0);
+    EXPECT_EQ(bins[1].framesSinceLastSeen, 2);
+    EXPECT_EQ(bins[2].framesSinceLastSeen, SpectralOccupancyNeverSeen);
+
+    calculator.reset();
+    EXPECT_EQ(calculator.getFrameCount(), 0);
+    EXPECT_EQ(calculator.getBins()[0].framesSinceLastSeen, SpectralOccupancyNeverSeen);
+}
+
+TEST(SpectralOccupancyCalculatorTest, WritesCsv)
+{
+    std::vector<SpectralOccupancyBin> bins(2);
+    bins[0] = { .occupancy = 0.5f, .dutyCycle = 0.25f, .framesSinceLastSeen = 4 };
+
+    std::stringstream stream;
+    writeSpectralOccupancyCsv(stream, bins, -10.0f, 10.0f, 0.5f);
+    EXPECT_EQ(stream.str(),
+              "frequency_hz,occupancy_percent,duty_cycle_percent,last_seen_s\n"
+              "-10,50,25,2\n"
+              "0,0,0,\n");
+}
+}
@@ -0,0 +1,62 @@
+#include <spectr/calc_cpu/SpectrumTraces.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+namespace spectr::calc_cpu::test
+{
+namespace
+{
+constexpr float Eps = 1e-4f;
+}
+
+TEST(SpectrumTraceCalculatorTest, HoldTraces)
+{
+    SpectrumTraceCalculator calculator{ 2, 4, SpectrumAverageMode::Rms };
+    calculator.update({ -10.0f, -50.0f });
+    calculator.update({ -30.0f, -20.0f });
+    calculator.update({ -20.0f, -40.0f });
+
+    EXPECT_EQ(calculator.getTrace(SpectrumTraceType::Live), (std::vector<float>{ -20.0f, -40.0f }));
+    EXPECT_EQ(calculator.getTrace(SpectrumTraceType::MaxHold),
+              (std::vector<float>{ -10.0f, -20.0f }));
+    EXPECT_EQ(calculator.getTrace(SpectrumTraceType::MinHold),
+              (std::vector<float>{ -30.0f, -50.0f }));
+
+    // the hold traces restart from the next frame
+    calculator.reset();
+    calculator.update({ -25.0f, -35.0f });
+    EXPECT_EQ(calculator.getTrace(SpectrumTraceType::MaxHold),
+              (std::vector<float>{ -25.0f, -35.0f }));
+    EXPECT_EQ(calculator.getTrace(SpectrumTraceType::MinHold),
+              (std::vector<float>{ -25.0f, -35.0f }));
+}
+
+TEST(SpectrumTraceCalculatorTest, AverageModes)
+{
+    SpectrumTraceCalculator rmsCalculator{ 1, 8, SpectrumAverageMode::Rms };
+    SpectrumTraceCalculator linearCalculator{ 1, 8, SpectrumAverageMode::Linear };
+    for (const auto dbfs : { -20.0f, -40.0f })
+    {
+        rmsCalculator.update({ dbfs });
+        linearCalculator.update({ dbfs });
+    }
+
+    // mean of the power 0.01 and 0.0001, mean of the magnitude 0.1 and 0.01
+    EXPECT_NEAR(rmsCalculator.getTrace(SpectrumTraceType::Average)[0],
+                10.0f * std::log10(0.00505f),
+                Eps);
+    EXPECT_NEAR(linearCalculator.getTrace(SpectrumTraceType::Average)[0],
+                20.0f * std::log10(0.055f),
+                Eps);
+}
+
+TEST(SpectrumTraceCalculatorTest, AverageBecomesExponential)
+{
+    EXPECT_FLOAT_EQ(SpectrumTraceCalculator::getAverageWeight(0, 4), 1.0f);
+    EXPECT_FLOAT_EQ(SpectrumTraceCalculator::getAverageWeight(2, 4), 1.0f / 3.0f);
+    EXPECT_FLOAT_EQ(SpectrumTraceCalculator::getAverageWeight(3, 4), 0.25f);
+    EXPECT_FLOAT_EQ(SpectrumTraceCalculator::getAverageWeight(100, 4), 0.25f);
+}
+}
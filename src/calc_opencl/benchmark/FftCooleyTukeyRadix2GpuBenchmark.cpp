@@ -30,10 +30,7 @@ void FftCooleyTukeyRadix2OpenclBenchmark(::benchmark::State& state)
 
     for (auto _ : state)
     {
-        float* duplicatedValues = new float[fftSize];
-        std::copy(values.begin(), values.end(), duplicatedValues);
-
-        fftCalculator.execute(duplicatedValues);
+        fftCalculator.execute(values);
     }
 }
 }
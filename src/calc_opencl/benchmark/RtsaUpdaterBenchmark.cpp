@@ -0,0 +1,100 @@
+#include <spectr/calc_opencl/RtsaUpdater.h>
+
+#include <spectr/calc_opencl/OpenclManager.h>
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace spectr::calc_opencl::benchmark
+{
+namespace
+{
+constexpr size_t FrequencyCount = 1 << 12;
+constexpr size_t MagnitudeResolution = 1024;
+constexpr float MagnitudeDbfsRange = 96.0f;
+constexpr float ReferenceValue = 32768.0f;
+
+/**
+ * @brief Magnitudes of a sparse spectrum: a few strong tones over a low noise floor.
+ */
+std::vector<float> createMagnitudes(std::mt19937& generator)
+{
+    std::uniform_real_distribution<float> noiseDistribution{ 80.0f, 90.0f };
+    std::vector<float> magnitudes(FrequencyCount);
+    for (size_t i = 0; i < FrequencyCount; ++i)
+    {
+        const auto attenuation = (i % 256 == 0) ? 10.0f : noiseDistribution(generator);
+        magnitudes[i] = ReferenceValue * std::pow(10.0f, -attenuation / 20.0f);
+    }
+    return magnitudes;
+}
+}
+
+void RtsaUpdaterBenchmark(::benchmark::State& state, RtsaUpdateMode mode)
+{
+    OpenclManager openclManager;
+    auto context = openclManager.getContext();
+
+    const auto historyBufferCount = static_cast<size_t>(state.range(0));
+    RtsaUpdater updater{ context,
+                         FrequencyCount,
+                         MagnitudeResolution,
+                         historyBufferCount,
+                         MagnitudeDbfsRange,
+                         FrequencyCount * MagnitudeResolution * sizeof(float) * 2,
+                         mode };
+
+    std::mt19937 generator{ 42 };
+    cl::CommandQueue queue{ context };
+    cl::Buffer magnitudesBuffer{ context, CL_MEM_READ_WRITE, FrequencyCount * sizeof(float) };
+
+    // fill the history, so every iteration evicts a frame
+    for (size_t i = 0; i < historyBufferCount; ++i)
+    {
+        const auto magnitudes = createMagnitudes(generator);
+        cl::copy(queue, magnitudes.begin(), magnitudes.end(), magnitudesBuffer);
+        updater.process(magnitudesBuffer, ReferenceValue);
+    }
+
+    const auto magnitudes = createMagnitudes(generator);
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        cl::copy(queue, magnitudes.begin(), magnitudes.end(), magnitudesBuffer);
+        state.ResumeTiming();
+
+        updater.process(magnitudesBuffer, ReferenceValue);
+    }
+}
+
+BENCHMARK_CAPTURE(RtsaUpdaterBenchmark, Gather, RtsaUpdateMode::Gather)
+  ->Unit(::benchmark::kMillisecond)
+  ->Arg(16)
+  ->Arg(64)
+  ->Arg(112)
+  ->Arg(256);
+
+BENCHMARK_CAPTURE(RtsaUpdaterBenchmark, Scatter, RtsaUpdateMode::Scatter)
+  ->Unit(::benchmark::kMillisecond)
+  ->Arg(16)
+  ->Arg(64)
+  ->Arg(112)
+  ->Arg(256);
+
+BENCHMARK_CAPTURE(RtsaUpdaterBenchmark, Incremental, RtsaUpdateMode::Incremental)
+  ->Unit(::benchmark::kMillisecond)
+  ->Arg(16)
+  ->Arg(64)
+  ->Arg(112)
+  ->Arg(256);
+
+BENCHMARK_CAPTURE(RtsaUpdaterBenchmark, ExponentialDecay, RtsaUpdateMode::ExponentialDecay)
+  ->Unit(::benchmark::kMillisecond)
+  ->Arg(16)
+  ->Arg(64)
+  ->Arg(112)
+  ->Arg(256);
+}
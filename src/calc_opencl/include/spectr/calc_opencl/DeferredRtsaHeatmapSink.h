@@ -0,0 +1,65 @@
+#pragma once
+
+#include <spectr/calc_opencl/OpenclApi.h>
+#include <spectr/calc_opencl/OpenclProfiler.h>
+#include <spectr/calc_opencl/RtsaHeatmapSink.h>
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace spectr::calc_opencl
+{
+/**
+ * @brief Hands the heatmap over from the calculating thread to the thread owning the target
+ * sink, e.g. the OpenGL thread.
+ * @details write() copies the changed ranges to a snapshot buffer on the device, flush()
+ * transfers the snapshot to the target sink. Ranges written but not flushed yet are merged, so
+ * the target gets every change however the threads are paced. The snapshot is guarded by a
+ * mutex: a write waits for the running flush and the other way around, both are device copies of
+ * the changed ranges only.
+ */
+class DeferredRtsaHeatmapSink : public RtsaHeatmapSink
+{
+public:
+    /**
+     * @param context Context of the updaters writing to the sink.
+     */
+    DeferredRtsaHeatmapSink(cl::Context context,
+                            std::shared_ptr<RtsaHeatmapSink> target,
+                            std::shared_ptr<OpenclProfiler> profiler = nullptr);
+
+    void write(cl::CommandQueue& queue,
+               const cl::Buffer& heatmapBuffer,
+               const std::vector<RtsaDirtyRange>& dirtyRanges,
+               OpenclProfilingEvents& profilingEvents) override;
+
+    size_t getSize() const override;
+
+    /**
+     * @brief Sets the tag of the following writes, e.g. level of detail of the heatmap, it's
+     * returned by flush() with the snapshot. Must be called from the writing thread.
+     */
+    void setTag(size_t tag);
+
+    /**
+     * @brief Transfers the changes written since the previous flush to the target sink.
+     * @return Tag of the last write, or nothing if there were no writes.
+     */
+    std::optional<size_t> flush();
+
+private:
+    std::shared_ptr<RtsaHeatmapSink> m_target;
+    std::shared_ptr<OpenclProfiler> m_profiler;
+    OpenclProfilingEvents m_profilingEvents;
+    cl::CommandQueue m_queue; // used by flush()
+    cl::Buffer m_snapshotBuffer;
+    size_t m_tag = 0;
+
+    std::mutex m_mutex;
+    bool m_isWritten = false; // since the previous flush
+    std::vector<RtsaDirtyRange> m_pendingRanges;
+    size_t m_pendingTag = 0;
+};
+}
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <spectr/calc_opencl/OpenclApi.h>
+#include <spectr/calc_opencl/OpenclProfiler.h>
 
 #include <complex>
+#include <memory>
 #include <vector>
 
 namespace spectr::calc_opencl
@@ -10,14 +12,30 @@ namespace spectr::calc_opencl
 class FftCooleyTukeyRadix2
 {
 public:
-    FftCooleyTukeyRadix2(cl::Context context, size_t fftSize);
+    /**
+     * @param context OpenCL context with a single device.
+     * @param fftSize FFT size, power of two.
+     * @param profiler Optional profiler, if set the command queue is created with profiling
+     * enabled and durations of all commands are recorded.
+     */
+    FftCooleyTukeyRadix2(cl::Context context,
+                         size_t fftSize,
+                         std::shared_ptr<OpenclProfiler> profiler = nullptr);
+
+    ~FftCooleyTukeyRadix2();
+
+    FftCooleyTukeyRadix2(const FftCooleyTukeyRadix2&) = delete;
+    FftCooleyTukeyRadix2& operator=(const FftCooleyTukeyRadix2&) = delete;
 
     cl::Context getContext() const;
 
-    void execute(std::vector<float> realValues);
+    size_t getFftSize() const;
+
+    void execute(const std::vector<float>& realValues);
     /**
      * @brief Executes FFT on GPU, then returns.
-     * @param realValues Array of real values of function f(x).
+     * @param realValues Array of real values of function f(x), the caller keeps the ownership.
+     * It's copied to the device before the return, so it can be reused right after.
      */
     void execute(const float* functionValues);
 
@@ -36,7 +54,30 @@ public:
     void calculateMagnitudes();
 
     /**
-     * @brief Copies magnitude values of FFT frequencies to OpenGL buffer.
+     * @brief Calculates dBFS values of FFT frequencies (FFT size / 2 values) in one pass over the
+     * FFT values, see getDbfsBuffer(). Must be called after execute(), blocking call.
+     * @param referenceValue Magnitude of 0 dBFS.
+     * @param isMagnitudesNeeded Whether linear magnitudes are written to the magnitudes buffer
+     * as well, as calculateMagnitudes() does.
+     */
+    void calculateSpectrum(float referenceValue, bool isMagnitudesNeeded);
+
+    /**
+     * @brief Finds the maximum of magnitude values. Must be called after calculateMagnitudes().
+     * @return Max magnitude value.
+     */
+    float findMaxMagnitude();
+
+    /**
+     * @brief Copies magnitude values (FFT size / 2 values) to the host memory, blocking call.
+     * Must be called after calculateMagnitudes().
+     * @param destination Destination array of at least FFT size / 2 elements.
+     */
+    void readMagnitudes(float* destination);
+
+    /**
+     * @brief Copies magnitude values of FFT frequencies to OpenGL buffer through the pinned
+     * staging memory.
      * @param openglBuffer Destination OpenGL buffer.
      * @param elementOffset Buffer offset in elements (element = real number).
      */
@@ -46,16 +87,26 @@ public:
 
     cl::Buffer getMagnitudesBuffer();
 
+    /**
+     * @brief Returns buffer with dBFS values calculated by calculateSpectrum().
+     */
+    cl::Buffer getDbfsBuffer();
+
 private:
     const size_t m_fftSize;
     const size_t m_stageCount;
     cl::Context m_context;
     cl::Device m_device;
     cl::Program m_program;
+    std::shared_ptr<OpenclProfiler> m_profiler;
+    OpenclProfilingEvents m_profilingEvents;
     cl::CommandQueue m_queue;
     cl::Buffer m_workBuffers[2];
     cl::Buffer m_magnitudesBuffer;
+    cl::Buffer m_dbfsBuffer;
     cl::Buffer m_maxValueBuffer;
     std::vector<cl::Buffer> m_omegaBuffers;
+    cl::Buffer m_magnitudesStagingBuffer; // host-allocated, mapped for the whole lifetime
+    float* m_magnitudesStagingMemory = nullptr;
 };
 }
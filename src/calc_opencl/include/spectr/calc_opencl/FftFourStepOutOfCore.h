@@ -0,0 +1,109 @@
+#pragma once
+
+#include <spectr/calc_opencl/OpenclApi.h>
+#include <spectr/calc_opencl/OpenclUtils.h>
+
+#include <array>
+#include <vector>
+
+namespace spectr::calc_opencl
+{
+/**
+ * @brief FFT for transforms that don't fit in the device memory.
+ * @details Four-step decomposition of the size N = N1 * N2: the signal is viewed as a row-major
+ * matrix of N2 rows and N1 columns. The first pass streams blocks of columns to the device,
+ * calculates FFTs of size N2 over every column and multiplies them by the twiddle factors. The
+ * second pass streams blocks of rows, calculates FFTs of size N1 over every row and transposes
+ * the block before streaming it back. Between the passes the intermediate matrix stays in the
+ * host memory. Every pass uses two sets of device buffers, so the transfers of one block overlap
+ * with the calculations of the other block.
+ */
+class FftFourStepOutOfCore
+{
+public:
+    /**
+     * @param context OpenCL context with a single device.
+     * @param fftSize FFT size, power of two, at least 4.
+     * @param deviceMemoryBudget Max device memory used by the buffers, in bytes. Zero - half of
+     * the device global memory.
+     */
+    FftFourStepOutOfCore(cl::Context context, size_t fftSize, size_t deviceMemoryBudget = 0);
+
+    /**
+     * @brief Calculates FFT of the real values, blocking call.
+     * @param realValues FFT size real values.
+     * @param output Destination array of FFT size complex values.
+     */
+    void execute(const float* realValues, Complex* output);
+
+    std::vector<Complex> execute(const std::vector<float>& realValues);
+
+    size_t getFftSize() const;
+
+    /**
+     * @brief Returns count of the matrix rows N2, it is the FFT size of the first pass.
+     */
+    size_t getRowCount() const;
+
+    /**
+     * @brief Returns count of the matrix columns N1, it is the FFT size of the second pass.
+     */
+    size_t getColumnCount() const;
+
+    /**
+     * @brief Returns count of the columns transferred to the device at once in the first pass.
+     */
+    size_t getColumnsPerBlock() const;
+
+    /**
+     * @brief Returns count of the rows transferred to the device at once in the second pass.
+     */
+    size_t getRowsPerBlock() const;
+
+    /**
+     * @brief Returns size of the allocated device buffers in bytes.
+     */
+    size_t getDeviceMemoryUsage() const;
+
+private:
+    /**
+     * @brief Device buffers of one block in flight.
+     */
+    struct BlockSlot
+    {
+        cl::Buffer transferBuffer; // block uploaded from or downloaded to the host
+        cl::Buffer workBuffer;     // block being transformed
+    };
+
+    void executeColumnPass(const float* realValues);
+
+    void executeRowPass(Complex* output);
+
+    /**
+     * @brief Enqueues in-place butterfly stages of a batch of bit-reversed transforms.
+     */
+    void enqueueFftStages(const cl::Buffer& buffer,
+                          size_t fftSize,
+                          size_t batchCount,
+                          size_t elementStride,
+                          size_t batchStride);
+
+private:
+    const size_t m_fftSize;
+    const size_t m_fftSizePower;
+    const size_t m_columnCount;
+    const size_t m_rowCount;
+    size_t m_columnsPerBlock = 0;
+    size_t m_rowsPerBlock = 0;
+    size_t m_deviceMemoryUsage = 0;
+    size_t m_transposeTileSize = 0;
+    cl::Context m_context;
+    cl::Device m_device;
+    cl::Program m_program;
+    cl::CommandQueue m_transferQueue;
+    cl::CommandQueue m_computeQueue;
+    cl::Buffer m_omegaBuffer;
+    std::array<BlockSlot, 2> m_slots;
+    std::vector<Complex> m_intermediateValues; // N2 x N1 matrix between the passes
+};
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <spectr/calc_opencl/FftCooleyTukeyRadix2CL.h>
+#include <spectr/calc_opencl/OpenclApi.h>
+#include <spectr/calc_opencl/OpenclDeviceSelector.h>
+#include <spectr/calc_opencl/OpenclProfiler.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace spectr::calc_opencl
+{
+struct FftFrame
+{
+    size_t columnIndex;
+    const float* samples; // FFT size values
+};
+
+struct FftColumnResult
+{
+    size_t columnIndex;
+    std::vector<float> magnitudes; // FFT size / 2 values
+    float maxMagnitude;
+};
+
+/**
+ * @brief Splits batches of FFT frames between several OpenCL devices.
+ * @details Every device owns its own context and FFT calculator. A batch is split into contiguous
+ * chunks proportional to the device throughput, chunks are processed in parallel and the results
+ * are returned in column order. Throughput starts from the calibration value and is refined with
+ * the time measured for every processed chunk.
+ */
+class MultiDeviceFftScheduler
+{
+public:
+    /**
+     * @param devices Devices to use, usually OpenclManager::getRankedDevices().
+     * @param fftSize FFT size, power of two.
+     * @param profiler Optional, measures the FFT stages of all devices together.
+     */
+    MultiDeviceFftScheduler(const std::vector<OpenclDeviceCandidate>& devices,
+                            size_t fftSize,
+                            std::shared_ptr<OpenclProfiler> profiler = nullptr);
+
+    /**
+     * @brief Calculates FFT magnitudes of the frames. Blocks until all devices finish.
+     * @param frames Frames to process.
+     * @return Results sorted by column index.
+     */
+    std::vector<FftColumnResult> process(const std::vector<FftFrame>& frames);
+
+    size_t getDeviceCount() const;
+
+    size_t getFftSize() const;
+
+    /**
+     * @brief Returns how many frames of a batch of the given size each device receives.
+     */
+    std::vector<size_t> getFrameDistribution(size_t frameCount) const;
+
+    std::vector<std::string> getDeviceNames() const;
+
+    /**
+     * @brief Returns the current throughput estimation of every device, FFT calculations per second.
+     */
+    std::vector<double> getDeviceThroughputs() const;
+
+private:
+    struct DeviceWorker
+    {
+        std::string name;
+        std::unique_ptr<FftCooleyTukeyRadix2> fftCalculator;
+        double fftsPerSecond;
+    };
+
+    void processChunk(DeviceWorker& worker,
+                      const FftFrame* frames,
+                      size_t frameCount,
+                      FftColumnResult* results);
+
+private:
+    const size_t m_fftSize;
+    std::vector<DeviceWorker> m_workers;
+};
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <spectr/calc_opencl/OpenclApi.h>
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace spectr::calc_opencl
+{
+struct OpenclDeviceSelectionSettings
+{
+    /**
+     * @brief FFT size used by the calibration run, should match the FFT size of the application.
+     */
+    size_t calibrationFftSize = 1 << 16;
+
+    /**
+     * @brief Count of measured FFT executions per device (after one warm-up execution).
+     */
+    size_t calibrationIterationCount = 8;
+
+    /**
+     * @brief Explicit device choice. Empty string means automatic selection. Supported values:
+     * "<platform index>:<device index>", a device type ("gpu", "cpu", "accelerator") or a
+     * case-insensitive part of the "<platform name> / <device name>" string. If it's empty, the
+     * SPECTR_OPENCL_DEVICE environment variable is used instead.
+     */
+    std::string deviceOverride;
+};
+
+struct OpenclDeviceCandidate
+{
+    cl::Platform platform;
+    cl::Device device;
+    size_t platformIndex = 0;
+    size_t deviceIndex = 0;
+    std::string name;
+    cl_device_type type = 0;
+
+    /**
+     * @brief Measured FFT calculations per second for the calibration FFT size. Zero if the
+     * device wasn't calibrated.
+     */
+    double fftsPerSecond = 0.0;
+};
+
+/**
+ * @brief Enumerates OpenCL devices of all platforms and types and ranks them by measured FFT
+ * throughput.
+ */
+class OpenclDeviceSelector
+{
+public:
+    /**
+     * @brief Returns all devices of all platforms. Platforms without devices are skipped.
+     */
+    static std::vector<OpenclDeviceCandidate> enumerate();
+
+    /**
+     * @brief Enumerates devices, applies the override and sorts the remaining devices by
+     * calibration throughput, the fastest device goes first. Devices that fail to run the
+     * calibration FFT are excluded. A single remaining device is returned without calibration.
+     * @throws utils::Exception if the override doesn't match any device.
+     */
+    static std::vector<OpenclDeviceCandidate> rank(const OpenclDeviceSelectionSettings& settings);
+
+    /**
+     * @brief Measures FFT throughput of the device.
+     * @return FFT calculations per second.
+     * @throws cl::Error or utils::Exception if the device can't run the FFT.
+     */
+    static double calibrate(const cl::Device& device, size_t fftSize, size_t iterationCount);
+
+    static std::string getDeviceTypeName(cl_device_type type);
+
+    static void printCandidates(const std::vector<OpenclDeviceCandidate>& candidates,
+                                std::ostream& out);
+};
+}
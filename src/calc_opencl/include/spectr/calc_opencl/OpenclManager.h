@@ -1,6 +1,9 @@
 #pragma once
 
 #include <spectr/calc_opencl/OpenclApi.h>
+#include <spectr/calc_opencl/OpenclDeviceSelector.h>
+
+#include <vector>
 
 namespace spectr::calc_opencl
 {
@@ -10,7 +13,15 @@ namespace spectr::calc_opencl
 class OpenclManager
 {
 public:
-    OpenclManager(const std::vector<cl_context_properties>& additionalProperties = {});
+    /**
+     * @brief Selects the fastest device (or the overridden one) and creates a context for it.
+     * @param additionalProperties Context properties appended to the platform property, e.g.
+     * OpenGL sharing properties. They are valid only for devices that share the OpenGL context,
+     * so ranked devices are tried in order and the properties are dropped if none accepts them.
+     * @param selectionSettings Device calibration and override settings.
+     */
+    OpenclManager(const std::vector<cl_context_properties>& additionalProperties = {},
+                  const OpenclDeviceSelectionSettings& selectionSettings = {});
 
     cl::Platform getPlatform() const;
 
@@ -18,9 +29,25 @@ public:
 
     cl::Context getContext() const;
 
+    /**
+     * @brief Returns whether the context was created with the additional properties.
+     */
+    bool hasAdditionalProperties() const;
+
+    /**
+     * @brief Returns all usable devices, the fastest goes first.
+     */
+    const std::vector<OpenclDeviceCandidate>& getRankedDevices() const;
+
+private:
+    void createContext(const OpenclDeviceCandidate& candidate,
+                       const std::vector<cl_context_properties>& additionalProperties);
+
 private:
     cl::Platform m_platform;
     cl::Device m_device;
     cl::Context m_context;
+    bool m_hasAdditionalProperties = false;
+    std::vector<OpenclDeviceCandidate> m_rankedDevices;
 };
 }
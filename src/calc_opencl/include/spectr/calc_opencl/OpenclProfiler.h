@@ -0,0 +1,108 @@
+#pragma once
+
+#include <spectr/calc_opencl/OpenclApi.h>
+
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace spectr::calc_opencl
+{
+struct OpenclStageStatistics
+{
+    std::string name;
+    size_t sampleCount = 0; // samples in the rolling window
+    double lastMs = 0.0;
+    double averageMs = 0.0;
+    double minMs = 0.0;
+    double maxMs = 0.0;
+    double fractionOfTotal = 0.0; // share of the stage average in the sum of all stage averages
+};
+
+/**
+ * @brief Collects device execution times of OpenCL commands and aggregates them into rolling
+ * per-stage statistics.
+ * @details Durations are taken from CL_PROFILING_COMMAND_START/END of command events, so they
+ * don't include host-side waits. Command queues must be created with CL_QUEUE_PROFILING_ENABLE,
+ * see getQueueProperties(). Thread-safe.
+ */
+class OpenclProfiler
+{
+public:
+    /**
+     * @param windowSize Count of the latest samples per stage used for the statistics.
+     */
+    explicit OpenclProfiler(size_t windowSize = 128);
+
+    /**
+     * @brief Returns command queue properties, with profiling enabled if the profiler is given.
+     */
+    static cl::QueueProperties getQueueProperties(const OpenclProfiler* profiler);
+
+    /**
+     * @brief Adds the duration of a completed command.
+     * @param stageName Name of the stage the command belongs to.
+     * @param event Event of the completed command.
+     */
+    void record(const std::string& stageName, const cl::Event& event);
+
+    /**
+     * @brief Adds durations of the completed commands.
+     */
+    void record(const std::vector<std::pair<std::string, cl::Event>>& events);
+
+    void addSample(const std::string& stageName, double milliseconds);
+
+    /**
+     * @brief Returns statistics of all stages in the order they were first recorded.
+     */
+    std::vector<OpenclStageStatistics> getStatistics() const;
+
+    void reset();
+
+private:
+    struct Stage
+    {
+        std::string name;
+        std::deque<double> samples;
+    };
+
+    const size_t m_windowSize;
+    mutable std::mutex m_mutex;
+    std::vector<Stage> m_stages;
+    std::unordered_map<std::string, size_t> m_stageIndices;
+};
+
+/**
+ * @brief Events of enqueued commands waiting to be passed to the profiler once they complete.
+ * Does nothing if there is no profiler.
+ */
+class OpenclProfilingEvents
+{
+public:
+    explicit OpenclProfilingEvents(OpenclProfiler* profiler);
+
+    bool isEnabled() const;
+
+    /**
+     * @brief Returns pointer to an event to pass to an enqueue call, or nullptr without profiler.
+     * The pointer is valid until the next call of add().
+     */
+    cl::Event* add(std::string_view stageName);
+
+    void add(std::string_view stageName, cl::Event event);
+
+    /**
+     * @brief Records the events to the profiler. All commands must be completed.
+     */
+    void flush();
+
+private:
+    OpenclProfiler* m_profiler;
+    std::vector<std::pair<std::string, cl::Event>> m_events;
+};
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <spectr/calc_opencl/OpenclApi.h>
+
+#include <filesystem>
+#include <string>
+
+namespace spectr::calc_opencl
+{
+/**
+ * @brief Builds OpenCL programs and keeps their device binaries in an on-disk cache.
+ *
+ * Cache entries are keyed by the device name, driver version, hash of the program source and the
+ * build options, so a driver update or a kernel change produces a new entry instead of loading a
+ * stale binary. If a cached binary is missing or rejected by the driver, the program is built from
+ * source and the entry is rewritten.
+ */
+class OpenclProgramCache
+{
+public:
+    /**
+     * @brief Builds the program for the device of the context, loading the binary from the cache
+     * when possible.
+     * @param context OpenCL context with a single device.
+     * @param source Program source code.
+     * @param buildOptions Compiler options passed to clBuildProgram.
+     * @return Built program.
+     * @throws utils::Exception if the program can't be built from source.
+     */
+    static cl::Program build(cl::Context context,
+                             const std::string& source,
+                             const std::string& buildOptions);
+
+    /**
+     * @brief Builds the program from source without touching the cache.
+     * @throws utils::Exception if the build fails, the exception contains the build log.
+     */
+    static cl::Program buildFromSource(cl::Context context,
+                                       const std::string& source,
+                                       const std::string& buildOptions);
+
+    /**
+     * @brief Sets directory where program binaries are stored. Empty path disables the cache.
+     */
+    static void setCacheDirectory(const std::filesystem::path& directory);
+
+    /**
+     * @brief Returns directory where program binaries are stored. By default it's a "spectr"
+     * subdirectory of the system temporary directory.
+     */
+    static std::filesystem::path getCacheDirectory();
+};
+}
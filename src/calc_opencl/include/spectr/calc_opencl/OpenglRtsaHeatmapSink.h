@@ -0,0 +1,73 @@
+#pragma once
+
+#include <spectr/calc_opencl/RtsaHeatmapSink.h>
+
+#include <cstdint>
+#include <memory>
+
+namespace spectr::calc_opencl
+{
+/**
+ * @brief Copies the heatmap to the OpenGL buffer shared with OpenCL, the heatmap doesn't leave
+ * the device.
+ * @details Requires the context created with OpenGL sharing properties. OpenGL commands are
+ * finished before the buffer is acquired, so write() must be called from the thread of the
+ * OpenGL context.
+ */
+class OpenglSharedRtsaHeatmapSink : public RtsaHeatmapSink
+{
+public:
+    /**
+     * @throws cl::Error if the OpenGL buffer can't be shared with the context.
+     */
+    OpenglSharedRtsaHeatmapSink(cl::Context context, uint32_t openglBuffer, size_t size);
+
+    void write(cl::CommandQueue& queue,
+               const cl::Buffer& heatmapBuffer,
+               const std::vector<RtsaDirtyRange>& dirtyRanges,
+               OpenclProfilingEvents& profilingEvents) override;
+
+    size_t getSize() const override;
+
+private:
+    const size_t m_size;
+    cl::BufferGL m_sharedBuffer;
+};
+
+/**
+ * @brief Fallback for contexts without OpenGL sharing: reads the dirty ranges to the pinned host
+ * memory and uploads them to the OpenGL buffer. write() must be called from the thread of the
+ * OpenGL context.
+ */
+class OpenglCopyRtsaHeatmapSink : public RtsaHeatmapSink
+{
+public:
+    OpenglCopyRtsaHeatmapSink(cl::Context context, uint32_t openglBuffer, size_t size);
+
+    ~OpenglCopyRtsaHeatmapSink();
+
+    void write(cl::CommandQueue& queue,
+               const cl::Buffer& heatmapBuffer,
+               const std::vector<RtsaDirtyRange>& dirtyRanges,
+               OpenclProfilingEvents& profilingEvents) override;
+
+    size_t getSize() const override;
+
+private:
+    const size_t m_size;
+    const uint32_t m_openglBuffer;
+    cl::CommandQueue m_queue;
+    cl::Buffer m_stagingBuffer;
+    void* m_stagingMemory = nullptr;
+};
+
+/**
+ * @brief Creates the shared sink if the context supports OpenGL sharing, otherwise the copying
+ * one.
+ * @param isOpenglSharingEnabled Whether the context was created with OpenGL sharing properties.
+ */
+std::shared_ptr<RtsaHeatmapSink> createOpenglRtsaHeatmapSink(cl::Context context,
+                                                             bool isOpenglSharingEnabled,
+                                                             uint32_t openglBuffer,
+                                                             size_t size);
+}
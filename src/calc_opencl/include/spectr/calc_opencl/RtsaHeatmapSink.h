@@ -0,0 +1,90 @@
+#pragma once
+
+#include <spectr/calc_opencl/OpenclApi.h>
+#include <spectr/calc_opencl/OpenclProfiler.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace spectr::calc_opencl
+{
+/**
+ * @brief Byte range of the heatmap changed since the previous write.
+ */
+struct RtsaDirtyRange
+{
+    size_t offset;
+    size_t size;
+};
+
+/**
+ * @brief Returns union of two lists of sorted non-overlapping ranges, sorted, with overlapping
+ * and adjacent ranges joined.
+ */
+std::vector<RtsaDirtyRange> mergeRtsaDirtyRanges(const std::vector<RtsaDirtyRange>& left,
+                                                 const std::vector<RtsaDirtyRange>& right);
+
+/**
+ * @brief Destination of the RTSA density heatmap calculated by RtsaUpdater, also used for the
+ * spectrum traces of SpectrumTraceUpdater.
+ */
+class RtsaHeatmapSink
+{
+public:
+    virtual ~RtsaHeatmapSink() = default;
+
+    /**
+     * @brief Transfers the heatmap to the destination, the transfer is completed on return.
+     * @param queue Queue of the updater, the heatmap calculation is enqueued to it.
+     * @param heatmapBuffer Device buffer of the heatmap, at least getSize() bytes.
+     * @param dirtyRanges Sorted non-overlapping ranges changed since the previous write, the rest
+     * of the destination is up to date.
+     * @param profilingEvents Events of the enqueued commands for the profiler.
+     */
+    virtual void write(cl::CommandQueue& queue,
+                       const cl::Buffer& heatmapBuffer,
+                       const std::vector<RtsaDirtyRange>& dirtyRanges,
+                       OpenclProfilingEvents& profilingEvents) = 0;
+
+    /**
+     * @brief Returns the heatmap size in bytes.
+     */
+    virtual size_t getSize() const = 0;
+};
+
+/**
+ * @brief Copies the heatmap to the host memory, e.g. for headless processing and tests.
+ */
+class HostRtsaHeatmapSink : public RtsaHeatmapSink
+{
+public:
+    explicit HostRtsaHeatmapSink(size_t size);
+
+    void write(cl::CommandQueue& queue,
+               const cl::Buffer& heatmapBuffer,
+               const std::vector<RtsaDirtyRange>& dirtyRanges,
+               OpenclProfilingEvents& profilingEvents) override;
+
+    size_t getSize() const override;
+
+    /**
+     * @brief Returns the heatmap received by the last write.
+     */
+    const std::vector<uint8_t>& getData() const;
+
+    /**
+     * @brief Returns the ranges transferred by the last write.
+     */
+    const std::vector<RtsaDirtyRange>& getLastDirtyRanges() const;
+
+    /**
+     * @brief Returns count of the received heatmaps.
+     */
+    size_t getWriteCount() const;
+
+private:
+    std::vector<uint8_t> m_data;
+    std::vector<RtsaDirtyRange> m_lastDirtyRanges;
+    size_t m_writeCount = 0;
+};
+}
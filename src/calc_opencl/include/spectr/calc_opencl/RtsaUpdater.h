@@ -1,43 +1,222 @@
 #pragma once
 
 #include <spectr/calc_opencl/OpenclApi.h>
+#include <spectr/calc_opencl/OpenclProfiler.h>
+#include <spectr/calc_opencl/RtsaHeatmapSink.h>
 #include <spectr/calc_opencl/OpenclUtils.h>
 
+#include <spectr/render_gl/RtsaLevelOfDetail.h>
+#include <spectr/utils/RtsaStorageFormat.h>
+
+#include <atomic>
 #include <cstdint>
+#include <memory>
+#include <vector>
 
 namespace spectr::calc_opencl
 {
+/**
+ * @brief Way the density heatmap is recalculated after a new frame.
+ */
+enum class RtsaUpdateMode
+{
+    /**
+     * @brief Every heatmap cell scans all history frames, O(frequencies x resolution x history).
+     */
+    Gather,
+
+    /**
+     * @brief One work item per history frame and frequency adds its hits to a histogram with
+     * atomics, privatized per work group in the local memory, O(frequencies x history x hit
+     * cells). Faster than Gather for sparse spectra.
+     */
+    Scatter,
+
+    /**
+     * @brief Hit counts of the cells are kept between updates, only the cells hit by the newest
+     * and the evicted frame are changed, O(frequencies x hit cells), then the counts are converted
+     * to the heatmap elementwise.
+     */
+    Incremental,
+
+    /**
+     * @brief No history, every update decays all cells by a constant factor and adds the cells
+     * hit by the new frame, O(frequencies x resolution) with one multiply per cell. The decay
+     * factor follows from the persistence, see RtsaUpdater::setPersistence().
+     */
+    ExponentialDecay,
+};
+
 class RtsaUpdater
 {
 public:
+    /**
+     * @param historyBuffersCount Count of frames in the history, in ExponentialDecay mode it is
+     * the initial persistence.
+     * @param storageFormat Format of the heatmap cells, must match the OpenGL buffer.
+     */
     RtsaUpdater(cl::Context context,
                 size_t frequencyCount,
                 size_t magnitudeResolution,
                 size_t historyBuffersCount,
                 float magnitudeDbfsRange,
-                size_t bufferSize);
+                size_t bufferSize,
+                RtsaUpdateMode mode = RtsaUpdateMode::Incremental,
+                utils::RtsaStorageFormat storageFormat = utils::RtsaStorageFormat::Float2,
+                std::shared_ptr<OpenclProfiler> profiler = nullptr);
 
     ~RtsaUpdater();
 
-    void update(cl::Buffer magnitudesBuffer, uint32_t openglBuffer, float referenceValue);
+    /**
+     * @brief Processes the frame, see process(), and writes the density heatmap to the sink.
+     * Only the tiles changed since the previous update are transferred.
+     */
+    void update(cl::Buffer magnitudesBuffer, RtsaHeatmapSink& sink, float referenceValue);
+
+    /**
+     * @brief Same as update(), but magnitudes are taken from the host memory, e.g. when they were
+     * calculated on another device.
+     * @param magnitudes Array of frequency count magnitude values.
+     */
+    void update(const float* magnitudes, RtsaHeatmapSink& sink, float referenceValue);
+
+    /**
+     * @brief Same as update(), but the frame is given as dBFS values, e.g. calculated by
+     * FftCooleyTukeyRadix2::calculateSpectrum().
+     */
+    void updateDbfs(cl::Buffer dbfsBuffer, RtsaHeatmapSink& sink);
+
+    /**
+     * @brief Adds the frame to the history and recalculates the density heatmap on the device,
+     * without copying it to OpenGL. Blocking call.
+     * @param magnitudesBuffer Frequency count magnitude values, not modified.
+     */
+    void process(cl::Buffer magnitudesBuffer, float referenceValue);
+
+    /**
+     * @brief Same as process(), but the frame is given as frequency count dBFS values, which
+     * are only read.
+     */
+    void processDbfs(cl::Buffer dbfsBuffer);
+
+    /**
+     * @brief Same as process(), but magnitudes are taken from the host memory.
+     * @param magnitudes Array of frequency count magnitude values.
+     */
+    void process(const float* magnitudes, float referenceValue);
+
+    /**
+     * @brief Writes the density heatmap tiles changed since the previous write to the sink, e.g.
+     * after several process() calls.
+     * @param sink Of the heatmap buffer size, throws utils::Exception otherwise.
+     */
+    void write(RtsaHeatmapSink& sink);
+
+    /**
+     * @brief Returns the density heatmap calculated by the last process() call, (hit ratio,
+     * mean age) values of frequency count x magnitude resolution cells in the storage format.
+     */
+    cl::Buffer getHeatmapBuffer() const;
+
+    /**
+     * @brief Returns the buffer with dBFS values of the last processed frame, e.g. for the
+     * spectrum traces.
+     */
+    cl::Buffer getDbfsBuffer() const;
+
+    RtsaUpdateMode getMode() const;
+
+    utils::RtsaStorageFormat getStorageFormat() const;
+
+    /**
+     * @brief Sets the persistence of ExponentialDecay mode: count of frames after which the
+     * contribution of a frame decays by e times. Thread-safe, applied from the next update.
+     */
+    void setPersistence(float frameCount);
+
+    float getPersistence() const;
+
+    /**
+     * @brief Returns count of the levels of detail of the magnitude axis, see
+     * render_gl::getRtsaLevelCount().
+     */
+    size_t getLevelCount() const;
+
+    /**
+     * @brief Sets level of detail of the heatmap: at level L it has frequency count x
+     * (resolution >> L) cells, so the work and the transfers follow the size of the view.
+     * Thread-safe, applied from the next update. Gather and Scatter modes calculate the level
+     * from the history directly, Incremental mode rebuilds the hit counts from the history,
+     * ExponentialDecay mode resamples its state.
+     */
+    void setLevel(size_t level);
+
+    /**
+     * @brief Returns level of detail of the heatmap calculated by the last process() call.
+     */
+    size_t getLevel() const;
+
+private:
+    /**
+     * @brief Switches the per-cell state to the requested level of detail, if it has changed.
+     */
+    void applyRequestedLevel();
+
+    size_t getLevelResolution() const;
+
+    void updateGather(size_t currentHistoryBuffer);
+
+    void updateScatter(size_t currentHistoryBuffer);
+
+    void updateIncremental(cl::Buffer dbfsBuffer, size_t currentHistoryBuffer);
+
+    void updateExponentialDecay(cl::Buffer dbfsBuffer);
+
+    /**
+     * @brief Converts the magnitudes to dBFS values in a separate buffer, the magnitudes may be
+     * used by other consumers, e.g. the waterfall.
+     */
+    void convertToDbfs(cl::Buffer magnitudesBuffer, float referenceValue);
+
+    /**
+     * @brief Returns byte ranges of the tiles changed since the previous call and clears them.
+     */
+    std::vector<RtsaDirtyRange> takeDirtyRanges();
 
 private:
     const size_t m_frequencyCount;
-    const size_t m_magnitudeResolution;
+    const size_t m_magnitudeResolution; // at level of detail 0
+    const size_t m_levelCount;
     const size_t m_historyBuffersCount;
     const float m_magnitudeDbfsRange;
+    const RtsaUpdateMode m_mode;
+    const utils::RtsaStorageFormat m_storageFormat;
     cl::Context m_context;
     cl::Device m_device;
     cl::Program m_program;
+    std::shared_ptr<OpenclProfiler> m_profiler;
+    OpenclProfilingEvents m_profilingEvents;
     cl::CommandQueue m_queue;
     cl::Buffer m_historyBuffer;
+    cl::Buffer m_hostMagnitudesBuffer;
+    cl::Buffer m_convertedDbfsBuffer; // dBFS values of the magnitudes given to process()
+    cl::Buffer m_dbfsBuffer;          // dBFS values of the last processed frame
     size_t m_nextBufferIndex = 0;
+    cl_uint m_timestamp = 0; // count of processed frames, wraps around
+    cl::Buffer m_hitCountsBuffer;
+    cl::Buffer m_timestampSumsBuffer;
+    cl::Buffer m_ageSumsBuffer;
+    cl::Buffer m_decayStateBuffer; // float2 per cell, packed cells are too coarse for the decay
+    size_t m_scatterLocalFrequencyCount = 0;
+    size_t m_scatterLocalFrameCount = 0;
+    std::atomic<float> m_persistenceFrameCount;
+    std::atomic<size_t> m_requestedLevel = 0;
+    size_t m_level = 0;
+    cl::Buffer m_decayScratchBuffer; // previous level of the decay state while resampling
     size_t m_bufferSize;
-
-    // Used to speed up copy operations
     cl::Buffer m_workBuffer;
-    float* m_hostPinnedMemory;
-    float* m_hostMappedMemory;
-    uint32_t m_openglBuffer;
+    size_t m_dirtyTileSize;           // bytes
+    cl::Buffer m_dirtyTilesBuffer;    // uchar flag per tile, set by the kernels
+    std::vector<uint8_t> m_dirtyTiles;
 };
 }
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <spectr/calc_cpu/SpectralOccupancy.h>
+#include <spectr/calc_opencl/OpenclApi.h>
+#include <spectr/calc_opencl/OpenclProfiler.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace spectr::calc_opencl
+{
+/**
+ * @brief Calculates the spectral occupancy on the device from the dBFS values of frames, e.g.
+ * RtsaUpdater::getDbfsBuffer().
+ * @details The per-bin statistics are updated by every frame in place, so the cost of a frame
+ * doesn't depend on the observation time. Same results as calc_cpu::SpectralOccupancyCalculator.
+ */
+class SpectralOccupancyUpdater
+{
+public:
+    /**
+     * @param thresholdDbfs A bin is occupied in a frame if its dBFS value is above it.
+     * @param dutyCycleFrameCount Count of the recent frames the duty cycle follows.
+     */
+    SpectralOccupancyUpdater(cl::Context context,
+                             size_t frequencyCount,
+                             float thresholdDbfs,
+                             size_t dutyCycleFrameCount,
+                             std::shared_ptr<OpenclProfiler> profiler = nullptr);
+
+    /**
+     * @brief Updates the statistics with the frame, blocking call. Reads them from the device
+     * afterwards if requested.
+     * @param dbfsBuffer Frequency count dBFS values, in the context of the updater.
+     */
+    void process(cl::Buffer dbfsBuffer);
+
+    /**
+     * @brief Returns the statistics of every bin. They are read from the device only if frames
+     * were processed since the previous call. Thread-safe, waits for the running process().
+     */
+    std::vector<calc_cpu::SpectralOccupancyBin> getStatistics();
+
+    /**
+     * @brief Requests the next process() to read the statistics from the device on its thread.
+     * Thread-safe.
+     */
+    void requestStatistics();
+
+    /**
+     * @brief Returns the statistics read last, never waits for the device or process().
+     * Thread-safe.
+     */
+    std::vector<calc_cpu::SpectralOccupancyBin> getLastStatistics() const;
+
+    /**
+     * @brief Sets the threshold and restarts the statistics. Thread-safe, applied from the next
+     * frame.
+     */
+    void setThreshold(float thresholdDbfs);
+
+    float getThreshold() const;
+
+    /**
+     * @brief Restarts the statistics from the next frame. Thread-safe.
+     */
+    void reset();
+
+    size_t getFrameCount() const;
+
+private:
+    void clearStatistics();
+
+    /**
+     * @brief Reads the statistics from the device, the statistics buffers must be guarded.
+     */
+    void readStatistics();
+
+private:
+    const size_t m_frequencyCount;
+    const size_t m_dutyCycleFrameCount;
+    cl::Context m_context;
+    cl::Program m_program;
+    std::shared_ptr<OpenclProfiler> m_profiler;
+    OpenclProfilingEvents m_profilingEvents;
+    cl::CommandQueue m_queue;
+    cl::Buffer m_occupiedFrameCountsBuffer;
+    cl::Buffer m_dutyCyclesBuffer;
+    cl::Buffer m_framesSinceLastSeenBuffer;
+    std::atomic<float> m_thresholdDbfs;
+    std::atomic<bool> m_isResetRequested = false;
+    std::atomic<bool> m_isReadRequested = false;
+    std::atomic<size_t> m_frameCount = 0; // frames since the reset
+    std::mutex m_mutex; // guards the statistics buffers
+    size_t m_readFrameCount = 0; // frame count of m_statistics
+    mutable std::mutex m_statisticsMutex; // guards m_statistics, never held during device calls
+    std::vector<calc_cpu::SpectralOccupancyBin> m_statistics;
+    std::vector<cl_uint> m_occupiedFrameCounts;
+    std::vector<cl_float> m_dutyCycles;
+    std::vector<cl_uint> m_framesSinceLastSeen;
+};
+}
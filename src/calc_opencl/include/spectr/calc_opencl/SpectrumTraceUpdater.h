@@ -0,0 +1,67 @@
+#pragma once
+
+#include <spectr/calc_cpu/SpectrumTraces.h>
+#include <spectr/calc_opencl/OpenclApi.h>
+#include <spectr/calc_opencl/OpenclProfiler.h>
+#include <spectr/calc_opencl/RtsaHeatmapSink.h>
+
+#include <atomic>
+#include <memory>
+
+namespace spectr::calc_opencl
+{
+/**
+ * @brief Calculates the spectrum traces (live, max hold, min hold, average) on the device from
+ * the dBFS values of frames, e.g. RtsaUpdater::getDbfsBuffer().
+ * @details The traces buffer holds calc_cpu::SpectrumTraceCount traces of frequency count float
+ * dBFS values, in the order of calc_cpu::SpectrumTraceType. Same results as
+ * calc_cpu::SpectrumTraceCalculator.
+ */
+class SpectrumTraceUpdater
+{
+public:
+    SpectrumTraceUpdater(cl::Context context,
+                         size_t frequencyCount,
+                         size_t averageFrameCount,
+                         calc_cpu::SpectrumAverageMode averageMode,
+                         std::shared_ptr<OpenclProfiler> profiler = nullptr);
+
+    /**
+     * @brief Updates the traces with the frame, blocking call.
+     * @param dbfsBuffer Frequency count dBFS values, in the context of the updater.
+     */
+    void process(cl::Buffer dbfsBuffer);
+
+    /**
+     * @brief Same as process(), then writes the traces buffer to the sink.
+     * @param sink Of the traces buffer size, throws utils::Exception otherwise.
+     */
+    void update(cl::Buffer dbfsBuffer, RtsaHeatmapSink& sink);
+
+    /**
+     * @brief Restarts the hold and the average traces from the next frame. Thread-safe.
+     */
+    void reset();
+
+    cl::Buffer getTracesBuffer() const;
+
+    /**
+     * @brief Returns size of the traces buffer in bytes.
+     */
+    size_t getTracesBufferSize() const;
+
+private:
+    const size_t m_frequencyCount;
+    const size_t m_averageFrameCount;
+    const calc_cpu::SpectrumAverageMode m_averageMode;
+    cl::Context m_context;
+    cl::Program m_program;
+    std::shared_ptr<OpenclProfiler> m_profiler;
+    OpenclProfilingEvents m_profilingEvents;
+    cl::CommandQueue m_queue;
+    cl::Buffer m_tracesBuffer;
+    cl::Buffer m_averageStateBuffer;
+    size_t m_frameCount = 0; // frames since the reset
+    std::atomic<bool> m_isResetRequested = false;
+};
+}
@@ -0,0 +1,66 @@
+#include <spectr/calc_opencl/DeferredRtsaHeatmapSink.h>
+
+namespace spectr::calc_opencl
+{
+DeferredRtsaHeatmapSink::DeferredRtsaHeatmapSink(cl::Context context,
+                                                 std::shared_ptr<RtsaHeatmapSink> target,
+                                                 std::shared_ptr<OpenclProfiler> profiler)
+  : m_target{ std::move(target) }
+  , m_profiler{ std::move(profiler) }
+  , m_profilingEvents{ m_profiler.get() }
+  , m_queue{ context, OpenclProfiler::getQueueProperties(m_profiler.get()) }
+  , m_snapshotBuffer{ context, CL_MEM_READ_WRITE, m_target->getSize() }
+{
+}
+
+void DeferredRtsaHeatmapSink::write(cl::CommandQueue& queue,
+                                    const cl::Buffer& heatmapBuffer,
+                                    const std::vector<RtsaDirtyRange>& dirtyRanges,
+                                    OpenclProfilingEvents& profilingEvents)
+{
+    std::lock_guard<std::mutex> guard{ m_mutex };
+
+    for (const auto& range : dirtyRanges)
+    {
+        queue.enqueueCopyBuffer(heatmapBuffer,
+                                m_snapshotBuffer,
+                                range.offset,
+                                range.offset,
+                                range.size,
+                                nullptr,
+                                profilingEvents.add("copy heatmap snapshot"));
+    }
+    queue.finish();
+
+    m_pendingRanges = mergeRtsaDirtyRanges(m_pendingRanges, dirtyRanges);
+    m_pendingTag = m_tag;
+    m_isWritten = true;
+}
+
+size_t DeferredRtsaHeatmapSink::getSize() const
+{
+    return m_target->getSize();
+}
+
+void DeferredRtsaHeatmapSink::setTag(size_t tag)
+{
+    m_tag = tag;
+}
+
+std::optional<size_t> DeferredRtsaHeatmapSink::flush()
+{
+    std::lock_guard<std::mutex> guard{ m_mutex };
+
+    if (!m_isWritten)
+    {
+        return std::nullopt;
+    }
+
+    m_target->write(m_queue, m_snapshotBuffer, m_pendingRanges, m_profilingEvents);
+    m_profilingEvents.flush();
+
+    m_pendingRanges.clear();
+    m_isWritten = false;
+    return m_pendingTag;
+}
+}
@@ -2,6 +2,7 @@
 #include <complex>
 
 #include <spectr/calc_cpu/FftCooleyTukeyUtils.h>
+#include <spectr/calc_opencl/OpenclProgramCache.h>
 #include <spectr/calc_opencl/OpenclUtils.h>
 #include <spectr/utils/Asset.h>
 #include <spectr/utils/Exception.h>
@@ -20,44 +21,31 @@ namespace spectr::calc_opencl
 namespace
 {
 const std::string ProgramAssetPath = "opencl/FFTCooleyTukeyRadix2Float.cl";
+constexpr float MinDbfs = -10000.0f; // dBFS of zero magnitude, same as in the RTSA conversion
 }
 
-FftCooleyTukeyRadix2::FftCooleyTukeyRadix2(cl::Context context, size_t fftSize)
+FftCooleyTukeyRadix2::FftCooleyTukeyRadix2(cl::Context context,
+                                           size_t fftSize,
+                                           std::shared_ptr<OpenclProfiler> profiler)
   : m_fftSize{ fftSize }
   , m_stageCount{ utils::Math::getPowerOfTwo(m_fftSize) }
   , m_context{ context }
   , m_device{ OpenclUtils::getDevice(m_context) }
-  , m_queue{ m_context }
+  , m_profiler{ std::move(profiler) }
+  , m_profilingEvents{ m_profiler.get() }
+  , m_queue{ m_context, OpenclProfiler::getQueueProperties(m_profiler.get()) }
 {
     const auto sourcePath = utils::Asset::getPath(ProgramAssetPath);
     const auto source = utils::File::read(sourcePath);
-    m_program = cl::Program{ m_context, source };
-    try
-    {
-        const auto bitReverseShiftValue = (CHAR_BIT * sizeof(uint32_t)) - m_stageCount;
-
-        std::stringstream ss;
-        ss << "-cl-std=CL2.0";
-        ss << " -DBIT_REVERSE_SHIFT_VALUE=" << bitReverseShiftValue;
-        ss << " -DFFT_SIZE=" << m_fftSize;
-        const auto compilerDirectives = ss.str();
-        m_program.build(compilerDirectives.c_str());
-    }
-    catch (const cl::BuildError& ex)
-    {
-        const auto buildOptions = m_program.getBuildInfo<CL_PROGRAM_BUILD_OPTIONS>();
-        const auto buildStatus = m_program.getBuildInfo<CL_PROGRAM_BUILD_STATUS>();
-        const auto buildInfo = m_program.getBuildInfo<CL_PROGRAM_BUILD_LOG>();
+    const auto bitReverseShiftValue = (CHAR_BIT * sizeof(uint32_t)) - m_stageCount;
 
-        std::stringstream ss;
-        for (const auto& pair : ex.getBuildLog())
-        {
-            ss << pair.second << "\n";
-        }
-
-        throw utils::Exception(
-          "Failed to build a kernel. Error code: {}\n Error log:\n{}", ex.err(), ss.str());
-    }
+    std::stringstream ss;
+    ss << "-cl-std=CL2.0";
+    ss << " -DBIT_REVERSE_SHIFT_VALUE=" << bitReverseShiftValue;
+    ss << " -DFFT_SIZE=" << m_fftSize;
+    ss << " -DMIN_DBFS=" << std::fixed << MinDbfs << "f";
+    const auto compilerDirectives = ss.str();
+    m_program = OpenclProgramCache::build(m_context, source, compilerDirectives);
 
     // allocate two work buffers
     const auto complexNumberSize = 2 * sizeof(cl_float);
@@ -66,6 +54,7 @@ FftCooleyTukeyRadix2::FftCooleyTukeyRadix2(cl::Context context, size_t fftSize)
     m_workBuffers[0] = { m_context, CL_MEM_READ_WRITE, valuesBufferByteCount };
     m_workBuffers[1] = { m_context, CL_MEM_READ_WRITE, valuesBufferByteCount };
     m_magnitudesBuffer = { m_context, CL_MEM_READ_WRITE, valuesBufferByteCount / 2 };
+    m_dbfsBuffer = { m_context, CL_MEM_READ_WRITE, valuesBufferByteCount / 2 };
     m_maxValueBuffer = { m_context, CL_MEM_READ_WRITE, valuesBufferByteCount / 2 };
 
     // pre-calculate omega buffers
@@ -77,6 +66,20 @@ FftCooleyTukeyRadix2::FftCooleyTukeyRadix2(cl::Context context, size_t fftSize)
         cl::Buffer omegaBuffer{ m_context, omegas.begin(), omegas.end(), true };
         m_omegaBuffers.push_back(std::move(omegaBuffer));
     }
+
+    // reads to the mapped host-allocated buffer go with the pinned memory transfer speed
+    const auto magnitudesByteCount = m_fftSize / 2 * sizeof(cl_float);
+    m_magnitudesStagingBuffer = {
+        m_context, CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR, magnitudesByteCount
+    };
+    m_magnitudesStagingMemory = static_cast<float*>(m_queue.enqueueMapBuffer(
+      m_magnitudesStagingBuffer, true, CL_MAP_READ, 0, magnitudesByteCount));
+}
+
+FftCooleyTukeyRadix2::~FftCooleyTukeyRadix2()
+{
+    m_queue.enqueueUnmapMemObject(m_magnitudesStagingBuffer, m_magnitudesStagingMemory);
+    m_queue.finish();
 }
 
 cl::Context FftCooleyTukeyRadix2::getContext() const
@@ -84,11 +87,14 @@ cl::Context FftCooleyTukeyRadix2::getContext() const
     return m_context;
 }
 
-void FftCooleyTukeyRadix2::execute(std::vector<float> realValues)
+size_t FftCooleyTukeyRadix2::getFftSize() const
+{
+    return m_fftSize;
+}
+
+void FftCooleyTukeyRadix2::execute(const std::vector<float>& realValues)
 {
-    float* values = new float[realValues.size()];
-    std::memcpy(values, realValues.data(), realValues.size() * sizeof(float));
-    execute(values);
+    execute(realValues.data());
 }
 
 void FftCooleyTukeyRadix2::execute(const float* realValues)
@@ -102,19 +108,23 @@ void FftCooleyTukeyRadix2::execute(const float* realValues)
 
     // copy the signal data to the first buffer
     std::vector<std::complex<float>> complexValues(realValues, &realValues[m_fftSize]);
-    complexValues[0] = { 1 };
-    complexValues[1] = { 2 };
-    delete[] realValues;
 
     // TODO non-blocking copy?
-    cl::copy(m_queue, complexValues.begin(), complexValues.end(), m_workBuffers[0]);
+    m_queue.enqueueWriteBuffer(m_workBuffers[0],
+                               true,
+                               0,
+                               complexValues.size() * sizeof(Complex),
+                               complexValues.data(),
+                               nullptr,
+                               m_profilingEvents.add("write input"));
 
     // perform bit-reverse permutation
     auto bitReversePermutationKernel =
       cl::KernelFunctor<cl::Buffer, cl::Buffer>(m_program, "bit_reverse_permutation");
 
     const cl::EnqueueArgs enqueueArgs(m_queue, cl::NDRange(m_fftSize));
-    bitReversePermutationKernel(enqueueArgs, m_workBuffers[0], m_workBuffers[1]);
+    m_profilingEvents.add("bit_reverse_permutation",
+                          bitReversePermutationKernel(enqueueArgs, m_workBuffers[0], m_workBuffers[1]));
     std::swap(m_workBuffers[0], m_workBuffers[1]);
 
     auto fftStageKernel =
@@ -142,13 +152,17 @@ void FftCooleyTukeyRadix2::execute(const float* realValues)
                                           std::min(subFftHalfSize, 64ull) };*/
 
         const cl::EnqueueArgs enqueueArgs(m_queue, globalGroupSize); //, localGroupSize);
-        fftStageKernel(enqueueArgs,
-                       srcBuffer,
-                       dstBuffer,
-                       omegaBuffer,
-                       static_cast<cl_uint>(subFftSize),
-                       static_cast<cl_uint>(subFftCount),
-                       static_cast<cl_uint>(stageIndex));
+        auto event = fftStageKernel(enqueueArgs,
+                                    srcBuffer,
+                                    dstBuffer,
+                                    omegaBuffer,
+                                    static_cast<cl_uint>(subFftSize),
+                                    static_cast<cl_uint>(subFftCount),
+                                    static_cast<cl_uint>(stageIndex));
+        if (m_profilingEvents.isEnabled())
+        {
+            m_profilingEvents.add("fft_stage " + std::to_string(stageIndex), std::move(event));
+        }
 
         // spdlog::debug("After FFT stage {}:", stageIndex);
         // OpenclUtils::printComplexNumbers(m_queue, m_workBuffers[0], m_fftSize);
@@ -159,6 +173,7 @@ void FftCooleyTukeyRadix2::execute(const float* realValues)
     }
 
     m_queue.finish();
+    m_profilingEvents.flush();
 }
 
 cl::Buffer FftCooleyTukeyRadix2::getFftBufferGpu()
@@ -185,11 +200,93 @@ void FftCooleyTukeyRadix2::calculateMagnitudes()
         const cl::NDRange globalGroupSize{ valuesCount };
         const cl::NDRange localGroupSize{ std::min(valuesCount, static_cast<size_t>(64)) };
         const cl::EnqueueArgs enqueueArgs(m_queue, globalGroupSize, localGroupSize);
-        calculateMagnitudesKernel(enqueueArgs, getFftBufferGpu(), m_magnitudesBuffer);
+        m_profilingEvents.add("calculate_magnitudes",
+                              calculateMagnitudesKernel(enqueueArgs, getFftBufferGpu(), m_magnitudesBuffer));
         // OpenclUtils::printVector<float>(m_queue, m_magnitudesBuffer, valuesCount, "Magnitudes:");
     }
 }
 
+void FftCooleyTukeyRadix2::calculateSpectrum(float referenceValue, bool isMagnitudesNeeded)
+{
+    const auto valuesCount = m_fftSize / 2;
+
+    // magnitude = 2 * |X|, so 20 * log10(magnitude / reference) = 10 * log10(|X|^2) + offset
+    const auto dbfsOffset = 20.0f * std::log10(2.0f / referenceValue);
+
+    auto calculateSpectrumKernel =
+      cl::KernelFunctor<cl::Buffer, cl::Buffer, cl::Buffer, cl_uint, float>(m_program,
+                                                                            "calculate_spectrum");
+    const cl::NDRange globalGroupSize{ valuesCount };
+    const cl::NDRange localGroupSize{ std::min(valuesCount, static_cast<size_t>(64)) };
+    const cl::EnqueueArgs enqueueArgs(m_queue, globalGroupSize, localGroupSize);
+    m_profilingEvents.add("calculate_spectrum",
+                          calculateSpectrumKernel(enqueueArgs,
+                                                  getFftBufferGpu(),
+                                                  m_dbfsBuffer,
+                                                  m_magnitudesBuffer,
+                                                  isMagnitudesNeeded ? 1u : 0u,
+                                                  dbfsOffset));
+
+    // the values are consumed by the command queues of other calculators
+    m_queue.finish();
+    m_profilingEvents.flush();
+}
+
+float FftCooleyTukeyRadix2::findMaxMagnitude()
+{
+    const auto valuesCount = m_fftSize / 2;
+
+    auto findMaxKernel = cl::Kernel(m_program, "find_max");
+
+    // the reduction needs a power of two work group size that divides the values count
+    const auto maxWorkGroupSize = std::min(
+      findMaxKernel.getWorkGroupInfo<CL_KERNEL_WORK_GROUP_SIZE>(m_device), valuesCount);
+    size_t workGroupSize = 1;
+    while (workGroupSize * 2 <= maxWorkGroupSize)
+    {
+        workGroupSize *= 2;
+    }
+
+    const cl::NDRange localSize{ workGroupSize };
+    const cl::NDRange globalSize{ valuesCount };
+    findMaxKernel.setArg(0, m_magnitudesBuffer);
+    findMaxKernel.setArg(1, sizeof(float) * workGroupSize, nullptr);
+    findMaxKernel.setArg(2, m_maxValueBuffer);
+    m_queue.enqueueNDRangeKernel(findMaxKernel,
+                                 cl::NullRange,
+                                 globalSize,
+                                 localSize,
+                                 nullptr,
+                                 m_profilingEvents.add("find_max"));
+
+    const auto reducedMagnitudesCount = valuesCount / workGroupSize;
+    std::vector<float> values;
+    values.resize(reducedMagnitudesCount);
+    m_queue.enqueueReadBuffer(m_maxValueBuffer,
+                              true,
+                              0,
+                              values.size() * sizeof(float),
+                              values.data(),
+                              nullptr,
+                              m_profilingEvents.add("read max values"));
+    m_profilingEvents.flush();
+
+    return *std::max_element(values.begin(), values.end());
+}
+
+void FftCooleyTukeyRadix2::readMagnitudes(float* destination)
+{
+    const auto valuesCount = m_fftSize / 2;
+    m_queue.enqueueReadBuffer(m_magnitudesBuffer,
+                              true,
+                              0,
+                              valuesCount * sizeof(float),
+                              destination,
+                              nullptr,
+                              m_profilingEvents.add("read magnitudes"));
+    m_profilingEvents.flush();
+}
+
 void FftCooleyTukeyRadix2::copyMagnitudesTo(uint32_t openglBuffer,
                                             cl_uint elementOffset,
                                             float* maxMagnitude)
@@ -199,44 +296,26 @@ void FftCooleyTukeyRadix2::copyMagnitudesTo(uint32_t openglBuffer,
     // find max magnitude // TODO disable or calculate mathematically???
     if (maxMagnitude)
     {
-        auto findMaxKernel = cl::Kernel(m_program, "find_max");
-        const auto workGroupSize =
-          findMaxKernel.getWorkGroupInfo<CL_KERNEL_WORK_GROUP_SIZE>(m_device);
-        const cl::NDRange localSize{ workGroupSize };
-        const cl::NDRange globalSize{ valuesCount };
-        const cl::EnqueueArgs enqueueArgs{ m_queue, globalSize, localSize };
-        findMaxKernel.setArg(0, m_magnitudesBuffer);
-        findMaxKernel.setArg(1, sizeof(float) * workGroupSize, nullptr);
-        findMaxKernel.setArg(2, m_maxValueBuffer);
-        m_queue.enqueueNDRangeKernel(findMaxKernel, cl::NullRange, globalSize, localSize);
-
-        const auto reducedMagnitudesCount = valuesCount / workGroupSize;
-        std::vector<float> values;
-        values.resize(reducedMagnitudesCount);
-        cl::copy(m_queue, m_maxValueBuffer, values.begin(), values.end());
-
-        *maxMagnitude = *std::max_element(values.begin(), values.end());
+        *maxMagnitude = findMaxMagnitude();
     }
 
-    {
-        float* ptr = new float[valuesCount];
-
-        m_queue.enqueueReadBuffer(m_magnitudesBuffer,
-                                  true,
-                                  0,//elementOffset * sizeof(float),
-                                  valuesCount * sizeof(float),
-                                  ptr);
+    readMagnitudes(m_magnitudesStagingMemory);
 
-        glBindBuffer(GL_SHADER_STORAGE_BUFFER, openglBuffer);
-        glBufferSubData(GL_SHADER_STORAGE_BUFFER, elementOffset * sizeof(float), valuesCount * sizeof(float), ptr);
-        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
-
-        delete[] ptr;
-    }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, openglBuffer);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER,
+                    elementOffset * sizeof(float),
+                    valuesCount * sizeof(float),
+                    m_magnitudesStagingMemory);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 }
 
 cl::Buffer FftCooleyTukeyRadix2::getMagnitudesBuffer()
 {
     return m_magnitudesBuffer;
 }
+
+cl::Buffer FftCooleyTukeyRadix2::getDbfsBuffer()
+{
+    return m_dbfsBuffer;
+}
 }
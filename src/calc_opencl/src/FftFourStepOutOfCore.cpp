@@ -0,0 +1,370 @@
+#include <spectr/calc_opencl/FftFourStepOutOfCore.h>
+
+#include <spectr/calc_opencl/OpenclProgramCache.h>
+#include <spectr/utils/Asset.h>
+#include <spectr/utils/Exception.h>
+#include <spectr/utils/File.h>
+#include <spectr/utils/Math.h>
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <string>
+
+namespace spectr::calc_opencl
+{
+namespace
+{
+const std::string ProgramAssetPath = "opencl/FFTFourStep.cl";
+
+/**
+ * @brief Each block slot has two buffers and the pass pipeline keeps two slots in flight.
+ */
+constexpr size_t BuffersPerBudget = 4;
+
+constexpr size_t MaxTransposeTileSize = 16;
+
+/**
+ * @brief Kernels index the buffers with 32-bit unsigned integers.
+ */
+constexpr size_t MaxBlockElementCount = size_t{ 1 } << 31;
+
+size_t floorPowerOfTwo(size_t value)
+{
+    size_t result = 1;
+    while (result * 2 <= value)
+    {
+        result *= 2;
+    }
+    return result;
+}
+
+size_t roundUp(size_t value, size_t multiple)
+{
+    return (value + multiple - 1) / multiple * multiple;
+}
+}
+
+FftFourStepOutOfCore::FftFourStepOutOfCore(cl::Context context,
+                                           size_t fftSize,
+                                           size_t deviceMemoryBudget)
+  : m_fftSize{ fftSize }
+  , m_fftSizePower{ utils::Math::getPowerOfTwo(m_fftSize) }
+  , m_columnCount{ size_t{ 1 } << (m_fftSizePower / 2) }
+  , m_rowCount{ m_fftSize / m_columnCount }
+  , m_context{ context }
+  , m_device{ OpenclUtils::getDevice(m_context) }
+  , m_transferQueue{ m_context }
+  , m_computeQueue{ m_context }
+{
+    if (m_fftSizePower < 2)
+    {
+        throw utils::Exception("Four-step FFT size must be at least 4, actual: {}", m_fftSize);
+    }
+
+    // the transpose tile must fit in a single work group
+    const auto maxWorkGroupSize = m_device.getInfo<CL_DEVICE_MAX_WORK_GROUP_SIZE>();
+    m_transposeTileSize = MaxTransposeTileSize;
+    while (m_transposeTileSize > 1 && m_transposeTileSize * m_transposeTileSize > maxWorkGroupSize)
+    {
+        m_transposeTileSize /= 2;
+    }
+
+    const auto sourcePath = utils::Asset::getPath(ProgramAssetPath);
+    const auto source = utils::File::read(sourcePath);
+
+    std::stringstream ss;
+    ss << "-cl-std=CL2.0";
+    ss << " -DTRANSPOSE_TILE_SIZE=" << m_transposeTileSize;
+    m_program = OpenclProgramCache::build(m_context, source, ss.str());
+
+    // the omega table of the bigger FFT size (rows) serves the smaller one with a stride
+    std::vector<Complex> omegas(m_rowCount / 2);
+    for (size_t k = 0; k < omegas.size(); ++k)
+    {
+        const auto angle = -2.0 * utils::Math::PI * k / m_rowCount;
+        omegas[k] = { static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle)) };
+    }
+    m_omegaBuffer = { m_context, omegas.begin(), omegas.end(), true };
+    const auto omegaBufferSize = omegas.size() * sizeof(Complex);
+
+    if (deviceMemoryBudget == 0)
+    {
+        deviceMemoryBudget = m_device.getInfo<CL_DEVICE_GLOBAL_MEM_SIZE>() / 2;
+    }
+
+    const auto maxAllocationSize = m_device.getInfo<CL_DEVICE_MAX_MEM_ALLOC_SIZE>();
+    const auto availableBufferSize =
+      deviceMemoryBudget > omegaBufferSize
+        ? std::min<size_t>((deviceMemoryBudget - omegaBufferSize) / BuffersPerBudget,
+                           maxAllocationSize)
+        : 0;
+    const auto maxBlockElementCount = std::min(
+      { availableBufferSize / sizeof(Complex), m_fftSize, MaxBlockElementCount });
+
+    // a block holds at least one whole column (first pass) and one whole row (second pass)
+    const auto minBlockElementCount = std::max(m_rowCount, m_columnCount);
+    if (maxBlockElementCount < minBlockElementCount)
+    {
+        const auto minBudget =
+          BuffersPerBudget * minBlockElementCount * sizeof(Complex) + omegaBufferSize;
+        throw utils::Exception(
+          "Device memory budget {} bytes is too small for FFT size {}, at least {} bytes required.",
+          deviceMemoryBudget,
+          m_fftSize,
+          minBudget);
+    }
+
+    const auto blockElementCount = floorPowerOfTwo(maxBlockElementCount);
+    m_columnsPerBlock = std::min(m_columnCount, blockElementCount / m_rowCount);
+    m_rowsPerBlock = std::min(m_rowCount, blockElementCount / m_columnCount);
+
+    const auto bufferSize =
+      std::max(m_columnsPerBlock * m_rowCount, m_rowsPerBlock * m_columnCount) * sizeof(Complex);
+    for (auto& slot : m_slots)
+    {
+        slot.transferBuffer = { m_context, CL_MEM_READ_WRITE, bufferSize };
+        slot.workBuffer = { m_context, CL_MEM_READ_WRITE, bufferSize };
+    }
+    m_deviceMemoryUsage = m_slots.size() * 2 * bufferSize + omegaBufferSize;
+}
+
+void FftFourStepOutOfCore::execute(const float* realValues, Complex* output)
+{
+    m_intermediateValues.resize(m_fftSize);
+
+    executeColumnPass(realValues);
+    executeRowPass(output);
+}
+
+std::vector<Complex> FftFourStepOutOfCore::execute(const std::vector<float>& realValues)
+{
+    if (realValues.size() != m_fftSize)
+    {
+        throw utils::Exception(
+          "Values count {} doesn't equal to the FFT size {}.", realValues.size(), m_fftSize);
+    }
+
+    std::vector<Complex> output(m_fftSize);
+    execute(realValues.data(), output.data());
+    return output;
+}
+
+size_t FftFourStepOutOfCore::getFftSize() const
+{
+    return m_fftSize;
+}
+
+size_t FftFourStepOutOfCore::getRowCount() const
+{
+    return m_rowCount;
+}
+
+size_t FftFourStepOutOfCore::getColumnCount() const
+{
+    return m_columnCount;
+}
+
+size_t FftFourStepOutOfCore::getColumnsPerBlock() const
+{
+    return m_columnsPerBlock;
+}
+
+size_t FftFourStepOutOfCore::getRowsPerBlock() const
+{
+    return m_rowsPerBlock;
+}
+
+size_t FftFourStepOutOfCore::getDeviceMemoryUsage() const
+{
+    return m_deviceMemoryUsage;
+}
+
+void FftFourStepOutOfCore::executeColumnPass(const float* realValues)
+{
+    // input element n1 + N1 * n2 is the element (n2, n1) of the N2 x N1 matrix, a block of columns
+    // is stored on the device as a N2 x columnsPerBlock matrix
+    const auto blockColumnCount = m_columnsPerBlock;
+    const auto blockCount = m_columnCount / blockColumnCount;
+
+    auto bitReverseKernel =
+      cl::KernelFunctor<cl::Buffer, cl::Buffer, cl_uint, cl_uint, cl_uint>(m_program,
+                                                                          "bit_reverse_real");
+    auto applyTwiddlesKernel =
+      cl::KernelFunctor<cl::Buffer, cl_uint, cl_uint, cl_uint>(m_program, "apply_twiddles");
+
+    std::array<cl::Event, 2> computeEvents;
+    const auto enqueueRead = [&](size_t blockIndex)
+    {
+        const auto slotIndex = blockIndex % m_slots.size();
+        const std::vector<cl::Event> waitEvents{ computeEvents[slotIndex] };
+        m_transferQueue.enqueueReadBufferRect(
+          m_slots[slotIndex].workBuffer,
+          false,
+          { 0, 0, 0 },
+          { blockIndex * blockColumnCount * sizeof(Complex), 0, 0 },
+          { blockColumnCount * sizeof(Complex), m_rowCount, 1 },
+          blockColumnCount * sizeof(Complex),
+          0,
+          m_columnCount * sizeof(Complex),
+          0,
+          m_intermediateValues.data(),
+          &waitEvents);
+    };
+
+    for (size_t blockIndex = 0; blockIndex < blockCount; ++blockIndex)
+    {
+        const auto slotIndex = blockIndex % m_slots.size();
+        const auto& slot = m_slots[slotIndex];
+        const auto columnOffset = blockIndex * blockColumnCount;
+
+        // the in-order transfer queue has already read the previous block of this slot
+        cl::Event writeEvent;
+        m_transferQueue.enqueueWriteBufferRect(slot.transferBuffer,
+                                               false,
+                                               { 0, 0, 0 },
+                                               { columnOffset * sizeof(float), 0, 0 },
+                                               { blockColumnCount * sizeof(float), m_rowCount, 1 },
+                                               blockColumnCount * sizeof(float),
+                                               0,
+                                               m_columnCount * sizeof(float),
+                                               0,
+                                               realValues,
+                                               nullptr,
+                                               &writeEvent);
+        // a queue waits for the events of the other one only after they are submitted
+        m_transferQueue.flush();
+
+        const auto rowCountPower = m_fftSizePower - m_fftSizePower / 2;
+        bitReverseKernel(
+          cl::EnqueueArgs(m_computeQueue, writeEvent, cl::NDRange(m_rowCount, blockColumnCount)),
+          slot.transferBuffer,
+          slot.workBuffer,
+          static_cast<cl_uint>(rowCountPower),
+          static_cast<cl_uint>(blockColumnCount),
+          1);
+
+        enqueueFftStages(slot.workBuffer, m_rowCount, blockColumnCount, blockColumnCount, 1);
+
+        computeEvents[slotIndex] = applyTwiddlesKernel(
+          cl::EnqueueArgs(m_computeQueue, cl::NDRange(blockColumnCount, m_rowCount)),
+          slot.workBuffer,
+          static_cast<cl_uint>(columnOffset),
+          static_cast<cl_uint>(blockColumnCount),
+          static_cast<cl_uint>(m_fftSizePower));
+        m_computeQueue.flush();
+
+        // read the previous block while this one is being calculated
+        if (blockIndex > 0)
+        {
+            enqueueRead(blockIndex - 1);
+        }
+    }
+    enqueueRead(blockCount - 1);
+
+    m_transferQueue.finish();
+}
+
+void FftFourStepOutOfCore::executeRowPass(Complex* output)
+{
+    // row k2 of the intermediate matrix is contiguous, FFT over the row gives X[k2 + N2 * k1];
+    // the transposed block of rows is the block of columns of the N1 x N2 output matrix
+    const auto blockRowCount = m_rowsPerBlock;
+    const auto blockCount = m_rowCount / blockRowCount;
+    const auto blockElementCount = blockRowCount * m_columnCount;
+
+    auto bitReverseKernel =
+      cl::KernelFunctor<cl::Buffer, cl::Buffer, cl_uint, cl_uint, cl_uint>(m_program,
+                                                                          "bit_reverse_complex");
+    auto transposeKernel =
+      cl::KernelFunctor<cl::Buffer, cl::Buffer, cl_uint, cl_uint>(m_program, "transpose");
+
+    std::array<cl::Event, 2> computeEvents;
+    const auto enqueueRead = [&](size_t blockIndex)
+    {
+        const auto slotIndex = blockIndex % m_slots.size();
+        const std::vector<cl::Event> waitEvents{ computeEvents[slotIndex] };
+        m_transferQueue.enqueueReadBufferRect(m_slots[slotIndex].transferBuffer,
+                                              false,
+                                              { 0, 0, 0 },
+                                              { blockIndex * blockRowCount * sizeof(Complex), 0, 0 },
+                                              { blockRowCount * sizeof(Complex), m_columnCount, 1 },
+                                              blockRowCount * sizeof(Complex),
+                                              0,
+                                              m_rowCount * sizeof(Complex),
+                                              0,
+                                              output,
+                                              &waitEvents);
+    };
+
+    for (size_t blockIndex = 0; blockIndex < blockCount; ++blockIndex)
+    {
+        const auto slotIndex = blockIndex % m_slots.size();
+        const auto& slot = m_slots[slotIndex];
+        const auto rowOffset = blockIndex * blockRowCount;
+
+        cl::Event writeEvent;
+        m_transferQueue.enqueueWriteBuffer(slot.transferBuffer,
+                                           false,
+                                           0,
+                                           blockElementCount * sizeof(Complex),
+                                           m_intermediateValues.data() + rowOffset * m_columnCount,
+                                           nullptr,
+                                           &writeEvent);
+        m_transferQueue.flush();
+
+        const auto columnCountPower = m_fftSizePower / 2;
+        bitReverseKernel(
+          cl::EnqueueArgs(m_computeQueue, writeEvent, cl::NDRange(m_columnCount, blockRowCount)),
+          slot.transferBuffer,
+          slot.workBuffer,
+          static_cast<cl_uint>(columnCountPower),
+          1,
+          static_cast<cl_uint>(m_columnCount));
+
+        enqueueFftStages(slot.workBuffer, m_columnCount, blockRowCount, 1, m_columnCount);
+
+        const cl::NDRange transposeGlobalSize{ roundUp(m_columnCount, m_transposeTileSize),
+                                               roundUp(blockRowCount, m_transposeTileSize) };
+        const cl::NDRange transposeLocalSize{ m_transposeTileSize, m_transposeTileSize };
+        computeEvents[slotIndex] = transposeKernel(
+          cl::EnqueueArgs(m_computeQueue, transposeGlobalSize, transposeLocalSize),
+          slot.workBuffer,
+          slot.transferBuffer,
+          static_cast<cl_uint>(blockRowCount),
+          static_cast<cl_uint>(m_columnCount));
+        m_computeQueue.flush();
+
+        if (blockIndex > 0)
+        {
+            enqueueRead(blockIndex - 1);
+        }
+    }
+    enqueueRead(blockCount - 1);
+
+    m_transferQueue.finish();
+}
+
+void FftFourStepOutOfCore::enqueueFftStages(const cl::Buffer& buffer,
+                                            size_t fftSize,
+                                            size_t batchCount,
+                                            size_t elementStride,
+                                            size_t batchStride)
+{
+    auto fftStageKernel =
+      cl::KernelFunctor<cl::Buffer, cl::Buffer, cl_uint, cl_uint, cl_uint, cl_uint>(m_program,
+                                                                                   "fft_stage");
+
+    const cl::EnqueueArgs enqueueArgs(m_computeQueue, cl::NDRange(fftSize / 2, batchCount));
+    for (size_t subFftSize = 2; subFftSize <= fftSize; subFftSize *= 2)
+    {
+        fftStageKernel(enqueueArgs,
+                       buffer,
+                       m_omegaBuffer,
+                       static_cast<cl_uint>(subFftSize),
+                       static_cast<cl_uint>(m_rowCount / subFftSize),
+                       static_cast<cl_uint>(elementStride),
+                       static_cast<cl_uint>(batchStride));
+    }
+}
+}
@@ -0,0 +1,197 @@
+#include <spectr/calc_opencl/MultiDeviceFftScheduler.h>
+
+#include <spectr/utils/Assert.h>
+#include <spectr/utils/Exception.h>
+#include <spectr/utils/Timer.h>
+
+#include <algorithm>
+#include <future>
+#include <numeric>
+
+namespace spectr::calc_opencl
+{
+namespace
+{
+/**
+ * @brief Weight of the latest measurement in the throughput estimation.
+ */
+constexpr double ThroughputSmoothingFactor = 0.3;
+
+/**
+ * @brief Throughput of every device if some device wasn't calibrated, so the first batch is split
+ * evenly.
+ */
+constexpr double DefaultThroughput = 1.0;
+}
+
+MultiDeviceFftScheduler::MultiDeviceFftScheduler(
+  const std::vector<OpenclDeviceCandidate>& devices,
+  size_t fftSize,
+  std::shared_ptr<OpenclProfiler> profiler)
+  : m_fftSize{ fftSize }
+{
+    if (devices.empty())
+    {
+        throw utils::Exception("Multi-device FFT scheduler requires at least one device.");
+    }
+
+    // calibration results are comparable only if every device was calibrated
+    const auto isCalibrated =
+      std::all_of(devices.begin(),
+                  devices.end(),
+                  [](const OpenclDeviceCandidate& device) { return device.fftsPerSecond > 0.0; });
+
+    m_workers.reserve(devices.size());
+    for (const auto& device : devices)
+    {
+        const cl::Context context{ device.device };
+
+        DeviceWorker worker{
+            .name = device.name,
+            .fftCalculator = std::make_unique<FftCooleyTukeyRadix2>(context, m_fftSize, profiler),
+            .fftsPerSecond = isCalibrated ? device.fftsPerSecond : DefaultThroughput,
+        };
+        m_workers.push_back(std::move(worker));
+    }
+}
+
+std::vector<FftColumnResult> MultiDeviceFftScheduler::process(const std::vector<FftFrame>& frames)
+{
+    std::vector<FftColumnResult> results(frames.size());
+    if (frames.empty())
+    {
+        return results;
+    }
+
+    const auto distribution = getFrameDistribution(frames.size());
+
+    std::vector<std::future<void>> tasks;
+    size_t chunkStart = 0;
+    for (size_t workerIndex = 0; workerIndex < m_workers.size(); ++workerIndex)
+    {
+        const auto chunkSize = distribution[workerIndex];
+        if (chunkSize == 0)
+        {
+            continue;
+        }
+
+        auto& worker = m_workers[workerIndex];
+        const auto* chunkFrames = frames.data() + chunkStart;
+        auto* chunkResults = results.data() + chunkStart;
+        tasks.push_back(std::async(std::launch::async,
+                                   [this, &worker, chunkFrames, chunkSize, chunkResults]()
+                                   { processChunk(worker, chunkFrames, chunkSize, chunkResults); }));
+
+        chunkStart += chunkSize;
+    }
+    ASSERT(chunkStart == frames.size());
+
+    // wait for all tasks before rethrowing, the tasks reference the result vector
+    for (auto& task : tasks)
+    {
+        task.wait();
+    }
+    for (auto& task : tasks)
+    {
+        task.get();
+    }
+
+    std::sort(results.begin(),
+              results.end(),
+              [](const FftColumnResult& lhs, const FftColumnResult& rhs)
+              { return lhs.columnIndex < rhs.columnIndex; });
+
+    return results;
+}
+
+size_t MultiDeviceFftScheduler::getDeviceCount() const
+{
+    return m_workers.size();
+}
+
+size_t MultiDeviceFftScheduler::getFftSize() const
+{
+    return m_fftSize;
+}
+
+std::vector<size_t> MultiDeviceFftScheduler::getFrameDistribution(size_t frameCount) const
+{
+    const auto totalThroughput =
+      std::accumulate(m_workers.begin(),
+                      m_workers.end(),
+                      0.0,
+                      [](double sum, const DeviceWorker& worker) { return sum + worker.fftsPerSecond; });
+
+    // largest remainder method: floor of the proportional shares, then the frames left are given
+    // to the devices with the biggest fractional parts
+    std::vector<size_t> distribution(m_workers.size());
+    std::vector<std::pair<double, size_t>> remainders;
+    size_t distributedCount = 0;
+    for (size_t i = 0; i < m_workers.size(); ++i)
+    {
+        const auto share = frameCount * m_workers[i].fftsPerSecond / totalThroughput;
+        distribution[i] = static_cast<size_t>(share);
+        distributedCount += distribution[i];
+        remainders.emplace_back(share - static_cast<double>(distribution[i]), i);
+    }
+
+    std::stable_sort(remainders.begin(),
+                     remainders.end(),
+                     [](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+
+    for (size_t i = 0; distributedCount < frameCount; ++i, ++distributedCount)
+    {
+        ++distribution[remainders[i % remainders.size()].second];
+    }
+
+    return distribution;
+}
+
+std::vector<std::string> MultiDeviceFftScheduler::getDeviceNames() const
+{
+    std::vector<std::string> names;
+    for (const auto& worker : m_workers)
+    {
+        names.push_back(worker.name);
+    }
+    return names;
+}
+
+std::vector<double> MultiDeviceFftScheduler::getDeviceThroughputs() const
+{
+    std::vector<double> throughputs;
+    for (const auto& worker : m_workers)
+    {
+        throughputs.push_back(worker.fftsPerSecond);
+    }
+    return throughputs;
+}
+
+void MultiDeviceFftScheduler::processChunk(DeviceWorker& worker,
+                                           const FftFrame* frames,
+                                           size_t frameCount,
+                                           FftColumnResult* results)
+{
+    auto& fftCalculator = *worker.fftCalculator;
+
+    utils::Timer timer;
+    for (size_t i = 0; i < frameCount; ++i)
+    {
+        const auto& frame = frames[i];
+        auto& result = results[i];
+
+        fftCalculator.execute(frame.samples);
+        fftCalculator.calculateMagnitudes();
+
+        result.columnIndex = frame.columnIndex;
+        result.maxMagnitude = fftCalculator.findMaxMagnitude();
+        result.magnitudes.resize(m_fftSize / 2);
+        fftCalculator.readMagnitudes(result.magnitudes.data());
+    }
+
+    const auto elapsedSeconds = std::max(static_cast<double>(timer.getTime()), 1e-9);
+    const auto measuredThroughput = frameCount / elapsedSeconds;
+    worker.fftsPerSecond = (1.0 - ThroughputSmoothingFactor) * worker.fftsPerSecond +
+                           ThroughputSmoothingFactor * measuredThroughput;
+}
+}
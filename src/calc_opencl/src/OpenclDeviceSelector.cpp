@@ -0,0 +1,253 @@
+#include <spectr/calc_opencl/OpenclDeviceSelector.h>
+
+#include <spectr/calc_opencl/FftCooleyTukeyRadix2CL.h>
+#include <spectr/utils/Exception.h>
+#include <spectr/utils/Timer.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+
+namespace spectr::calc_opencl
+{
+namespace
+{
+const char* const DeviceOverrideEnvironmentVariable = "SPECTR_OPENCL_DEVICE";
+
+std::string toLower(std::string str)
+{
+    std::transform(str.begin(),
+                   str.end(),
+                   str.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return str;
+}
+
+std::string getDeviceOverride(const OpenclDeviceSelectionSettings& settings)
+{
+    if (!settings.deviceOverride.empty())
+    {
+        return settings.deviceOverride;
+    }
+
+    const auto* environmentValue = std::getenv(DeviceOverrideEnvironmentVariable);
+    return environmentValue ? environmentValue : "";
+}
+
+std::optional<std::pair<size_t, size_t>> parseDeviceIndices(const std::string& str)
+{
+    const auto separatorPosition = str.find(':');
+    if (separatorPosition == std::string::npos)
+    {
+        return std::nullopt;
+    }
+
+    try
+    {
+        size_t platformCharCount = 0;
+        size_t deviceCharCount = 0;
+        const auto platformPart = str.substr(0, separatorPosition);
+        const auto devicePart = str.substr(separatorPosition + 1);
+        const auto platformIndex = std::stoul(platformPart, &platformCharCount);
+        const auto deviceIndex = std::stoul(devicePart, &deviceCharCount);
+        if (platformCharCount != platformPart.size() || deviceCharCount != devicePart.size())
+        {
+            return std::nullopt;
+        }
+        return std::make_pair(platformIndex, deviceIndex);
+    }
+    catch (const std::exception&)
+    {
+        return std::nullopt;
+    }
+}
+
+bool isOverrideMatch(const OpenclDeviceCandidate& candidate, const std::string& deviceOverride)
+{
+    if (const auto indices = parseDeviceIndices(deviceOverride))
+    {
+        return indices->first == candidate.platformIndex &&
+               indices->second == candidate.deviceIndex;
+    }
+
+    const auto lowerOverride = toLower(deviceOverride);
+    if (lowerOverride == OpenclDeviceSelector::getDeviceTypeName(candidate.type))
+    {
+        return true;
+    }
+
+    return toLower(candidate.name).find(lowerOverride) != std::string::npos;
+}
+}
+
+std::vector<OpenclDeviceCandidate> OpenclDeviceSelector::enumerate()
+{
+    std::vector<cl::Platform> platforms;
+    try
+    {
+        cl::Platform::get(&platforms);
+    }
+    catch (const cl::Error& ex)
+    {
+        // the ICD loader reports an error instead of an empty list if there are no platforms
+        std::cerr << "Failed to get OpenCL platforms. Error code: " << ex.err() << std::endl;
+        return {};
+    }
+
+    std::vector<OpenclDeviceCandidate> candidates;
+    for (size_t platformIndex = 0; platformIndex < platforms.size(); ++platformIndex)
+    {
+        const auto& platform = platforms[platformIndex];
+
+        std::vector<cl::Device> devices;
+        try
+        {
+            platform.getDevices(CL_DEVICE_TYPE_ALL, &devices);
+        }
+        catch (const cl::Error& ex)
+        {
+            std::cerr << "Failed to get devices of OpenCL platform " << platformIndex
+                      << ". Error code: " << ex.err() << std::endl;
+            continue;
+        }
+
+        const auto platformName = platform.getInfo<CL_PLATFORM_NAME>();
+        for (size_t deviceIndex = 0; deviceIndex < devices.size(); ++deviceIndex)
+        {
+            const auto& device = devices[deviceIndex];
+
+            OpenclDeviceCandidate candidate;
+            candidate.platform = platform;
+            candidate.device = device;
+            candidate.platformIndex = platformIndex;
+            candidate.deviceIndex = deviceIndex;
+            candidate.name = std::string{ platformName.c_str() } + " / " +
+                             device.getInfo<CL_DEVICE_NAME>().c_str();
+            candidate.type = device.getInfo<CL_DEVICE_TYPE>();
+            candidates.push_back(std::move(candidate));
+        }
+    }
+
+    return candidates;
+}
+
+std::vector<OpenclDeviceCandidate> OpenclDeviceSelector::rank(
+  const OpenclDeviceSelectionSettings& settings)
+{
+    auto candidates = enumerate();
+
+    const auto deviceOverride = getDeviceOverride(settings);
+    if (!deviceOverride.empty())
+    {
+        std::erase_if(candidates,
+                      [&](const OpenclDeviceCandidate& candidate)
+                      { return !isOverrideMatch(candidate, deviceOverride); });
+
+        if (candidates.empty())
+        {
+            throw utils::Exception("No OpenCL device matches the device override \"{}\".",
+                                   deviceOverride);
+        }
+    }
+
+    if (candidates.size() <= 1)
+    {
+        return candidates;
+    }
+
+    for (auto& candidate : candidates)
+    {
+        try
+        {
+            candidate.fftsPerSecond = calibrate(
+              candidate.device, settings.calibrationFftSize, settings.calibrationIterationCount);
+        }
+        catch (const std::exception& ex)
+        {
+            std::cerr << "OpenCL device \"" << candidate.name
+                      << "\" failed the calibration FFT: " << ex.what() << std::endl;
+            candidate.fftsPerSecond = 0.0;
+        }
+    }
+
+    std::erase_if(candidates,
+                  [](const OpenclDeviceCandidate& candidate)
+                  { return candidate.fftsPerSecond <= 0.0; });
+
+    std::stable_sort(candidates.begin(),
+                     candidates.end(),
+                     [](const OpenclDeviceCandidate& lhs, const OpenclDeviceCandidate& rhs)
+                     { return lhs.fftsPerSecond > rhs.fftsPerSecond; });
+
+    return candidates;
+}
+
+double OpenclDeviceSelector::calibrate(const cl::Device& device,
+                                       size_t fftSize,
+                                       size_t iterationCount)
+{
+    ASSERT(iterationCount > 0);
+
+    const cl::Context context{ device };
+    FftCooleyTukeyRadix2 fftCalculator{ context, fftSize };
+
+    std::vector<float> signal(fftSize);
+    for (size_t i = 0; i < fftSize; ++i)
+    {
+        signal[i] = std::sin(static_cast<float>(i) * 0.1f) + std::sin(static_cast<float>(i) * 0.37f);
+    }
+
+    // the first execution includes lazy driver initialization, so it isn't measured
+    fftCalculator.execute(signal);
+    fftCalculator.calculateMagnitudes();
+    fftCalculator.getFffBufferCpu();
+
+    utils::Timer timer;
+    for (size_t i = 0; i < iterationCount; ++i)
+    {
+        fftCalculator.execute(signal);
+        fftCalculator.calculateMagnitudes();
+    }
+    fftCalculator.getFffBufferCpu();
+    const auto elapsedSeconds = std::max(static_cast<double>(timer.getTime()), 1e-9);
+
+    return static_cast<double>(iterationCount) / elapsedSeconds;
+}
+
+std::string OpenclDeviceSelector::getDeviceTypeName(cl_device_type type)
+{
+    if (type & CL_DEVICE_TYPE_GPU)
+    {
+        return "gpu";
+    }
+    if (type & CL_DEVICE_TYPE_CPU)
+    {
+        return "cpu";
+    }
+    if (type & CL_DEVICE_TYPE_ACCELERATOR)
+    {
+        return "accelerator";
+    }
+    return "other";
+}
+
+void OpenclDeviceSelector::printCandidates(const std::vector<OpenclDeviceCandidate>& candidates,
+                                           std::ostream& out)
+{
+    out << "OpenCL devices ranked by FFT throughput:\n";
+    for (size_t i = 0; i < candidates.size(); ++i)
+    {
+        const auto& candidate = candidates[i];
+        out << "\t" << i + 1 << ". [" << candidate.platformIndex << ":" << candidate.deviceIndex
+            << "] " << candidate.name << " (" << getDeviceTypeName(candidate.type) << ")";
+        if (candidate.fftsPerSecond > 0.0)
+        {
+            out << ": " << candidate.fftsPerSecond << " FFT/s";
+        }
+        out << "\n";
+    }
+}
+}
@@ -19,61 +19,65 @@ void notifyCallback(const char* errorInfo, const void* privateInfo, size_t cb, v
 }
 }
 
-OpenclManager::OpenclManager(const std::vector<cl_context_properties>& additionalProperties)
+OpenclManager::OpenclManager(const std::vector<cl_context_properties>& additionalProperties,
+                             const OpenclDeviceSelectionSettings& selectionSettings)
 {
     std::stringstream ss;
     OpenclUtils::printPlatformsAndDevices(ss);
     // spdlog::trace(ss.str());
     std::cout << ss.str() << std::endl;
 
-    std::vector<cl::Platform> platforms;
-    ASSERT_CL_SUCCESS(cl::Platform::get(&platforms));
-
-    if (platforms.empty())
+    m_rankedDevices = OpenclDeviceSelector::rank(selectionSettings);
+    if (m_rankedDevices.empty())
     {
-        throw utils::Exception("No platforms found for OpenCL!");
+        throw utils::Exception("No OpenCL devices found.");
     }
 
-    std::vector<std::pair<cl::Platform, cl::Device>> candidates;
-    for (const auto& platform : platforms)
-    {
-        std::vector<cl::Device> devices;
-        ASSERT_CL_SUCCESS(platform.getDevices(CL_DEVICE_TYPE_ALL, &devices));
-        if (devices.empty())
-        {
-            throw utils::Exception("No devices found.");
-        }
+    OpenclDeviceSelector::printCandidates(m_rankedDevices, std::cout);
 
-        for (const auto& device : devices)
+    if (!additionalProperties.empty())
+    {
+        for (const auto& candidate : m_rankedDevices)
         {
-            const auto type = device.getInfo<CL_DEVICE_TYPE>();
-            if (type & CL_DEVICE_TYPE_GPU)
+            try
+            {
+                createContext(candidate, additionalProperties);
+                m_hasAdditionalProperties = true;
+                break;
+            }
+            catch (const cl::Error& ex)
             {
-                candidates.push_back({ platform, device });
+                std::cerr << "OpenCL device \"" << candidate.name
+                          << "\" doesn't accept additional context properties. Error code: "
+                          << ex.err() << std::endl;
             }
         }
     }
 
-    if (candidates.empty())
+    if (!m_hasAdditionalProperties)
     {
-        throw utils::Exception("Failed to select device.");
+        createContext(m_rankedDevices.front(), {});
     }
 
-    const auto& selected = candidates.front();
-    m_platform = selected.first;
-    m_device = selected.second;
+    std::cout << "Selected OpenCL device: " << m_device.getInfo<CL_DEVICE_NAME>().c_str()
+              << std::endl;
+}
 
-    const cl_platform_id platformId = m_platform();
+void OpenclManager::createContext(const OpenclDeviceCandidate& candidate,
+                                  const std::vector<cl_context_properties>& additionalProperties)
+{
+    const cl_platform_id platformId = candidate.platform();
 
     std::vector<cl_context_properties> properties{
         CL_CONTEXT_PLATFORM,
         reinterpret_cast<cl_context_properties>(platformId),
-        0
     };
-    // properties.insert(properties.end(), additionalProperties.begin(), additionalProperties.end());
+    properties.insert(properties.end(), additionalProperties.begin(), additionalProperties.end());
     properties.push_back(0);
 
-    m_context = cl::Context(m_device, properties.data(), notifyCallback);
+    m_context = cl::Context(candidate.device, properties.data(), notifyCallback);
+    m_platform = candidate.platform;
+    m_device = candidate.device;
 }
 
 cl::Platform OpenclManager::getPlatform() const
@@ -93,4 +97,14 @@ cl::Context OpenclManager::getContext() const
     ASSERT_MESSAGE(m_context(), "Context is nullptr.");
     return m_context;
 }
+
+bool OpenclManager::hasAdditionalProperties() const
+{
+    return m_hasAdditionalProperties;
+}
+
+const std::vector<OpenclDeviceCandidate>& OpenclManager::getRankedDevices() const
+{
+    return m_rankedDevices;
+}
 }
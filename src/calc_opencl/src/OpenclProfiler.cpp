@@ -0,0 +1,143 @@
+#include <spectr/calc_opencl/OpenclProfiler.h>
+
+#include <spectr/utils/Assert.h>
+
+#include <algorithm>
+#include <numeric>
+
+namespace spectr::calc_opencl
+{
+OpenclProfiler::OpenclProfiler(size_t windowSize)
+  : m_windowSize{ windowSize }
+{
+    ASSERT(m_windowSize > 0);
+}
+
+cl::QueueProperties OpenclProfiler::getQueueProperties(const OpenclProfiler* profiler)
+{
+    return profiler ? cl::QueueProperties::Profiling : cl::QueueProperties::None;
+}
+
+void OpenclProfiler::record(const std::string& stageName, const cl::Event& event)
+{
+    const auto start = event.getProfilingInfo<CL_PROFILING_COMMAND_START>();
+    const auto end = event.getProfilingInfo<CL_PROFILING_COMMAND_END>();
+    const auto nanoseconds = end > start ? end - start : 0;
+    addSample(stageName, static_cast<double>(nanoseconds) * 1e-6);
+}
+
+void OpenclProfiler::record(const std::vector<std::pair<std::string, cl::Event>>& events)
+{
+    for (const auto& [stageName, event] : events)
+    {
+        record(stageName, event);
+    }
+}
+
+void OpenclProfiler::addSample(const std::string& stageName, double milliseconds)
+{
+    std::lock_guard<std::mutex> guard{ m_mutex };
+
+    auto it = m_stageIndices.find(stageName);
+    if (it == m_stageIndices.end())
+    {
+        it = m_stageIndices.emplace(stageName, m_stages.size()).first;
+        m_stages.push_back(Stage{ .name = stageName, .samples = {} });
+    }
+
+    auto& samples = m_stages[it->second].samples;
+    samples.push_back(milliseconds);
+    if (samples.size() > m_windowSize)
+    {
+        samples.pop_front();
+    }
+}
+
+std::vector<OpenclStageStatistics> OpenclProfiler::getStatistics() const
+{
+    std::lock_guard<std::mutex> guard{ m_mutex };
+
+    std::vector<OpenclStageStatistics> statistics;
+    statistics.reserve(m_stages.size());
+
+    double averagesSum = 0.0;
+    for (const auto& stage : m_stages)
+    {
+        OpenclStageStatistics stageStatistics;
+        stageStatistics.name = stage.name;
+        stageStatistics.sampleCount = stage.samples.size();
+        if (!stage.samples.empty())
+        {
+            const auto [minIt, maxIt] =
+              std::minmax_element(stage.samples.begin(), stage.samples.end());
+            const auto sum = std::accumulate(stage.samples.begin(), stage.samples.end(), 0.0);
+            stageStatistics.lastMs = stage.samples.back();
+            stageStatistics.averageMs = sum / stage.samples.size();
+            stageStatistics.minMs = *minIt;
+            stageStatistics.maxMs = *maxIt;
+        }
+
+        averagesSum += stageStatistics.averageMs;
+        statistics.push_back(std::move(stageStatistics));
+    }
+
+    if (averagesSum > 0.0)
+    {
+        for (auto& stageStatistics : statistics)
+        {
+            stageStatistics.fractionOfTotal = stageStatistics.averageMs / averagesSum;
+        }
+    }
+
+    return statistics;
+}
+
+void OpenclProfiler::reset()
+{
+    std::lock_guard<std::mutex> guard{ m_mutex };
+    m_stages.clear();
+    m_stageIndices.clear();
+}
+
+OpenclProfilingEvents::OpenclProfilingEvents(OpenclProfiler* profiler)
+  : m_profiler{ profiler }
+{
+}
+
+bool OpenclProfilingEvents::isEnabled() const
+{
+    return m_profiler != nullptr;
+}
+
+cl::Event* OpenclProfilingEvents::add(std::string_view stageName)
+{
+    if (!m_profiler)
+    {
+        return nullptr;
+    }
+
+    m_events.emplace_back(std::string{ stageName }, cl::Event{});
+    return &m_events.back().second;
+}
+
+void OpenclProfilingEvents::add(std::string_view stageName, cl::Event event)
+{
+    if (!m_profiler)
+    {
+        return;
+    }
+
+    m_events.emplace_back(std::string{ stageName }, std::move(event));
+}
+
+void OpenclProfilingEvents::flush()
+{
+    if (!m_profiler)
+    {
+        return;
+    }
+
+    m_profiler->record(m_events);
+    m_events.clear();
+}
+}
@@ -0,0 +1,232 @@
+#include <spectr/calc_opencl/OpenclProgramCache.h>
+
+#include <spectr/calc_opencl/OpenclUtils.h>
+#include <spectr/utils/Exception.h>
+
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace spectr::calc_opencl
+{
+namespace
+{
+const std::string CacheFileMagic = "SPECTR_CL_BINARY_1";
+const std::string CacheFileExtension = ".clbin";
+
+std::mutex cacheDirectoryMutex;
+std::optional<std::filesystem::path> cacheDirectory;
+
+std::filesystem::path getDefaultCacheDirectory()
+{
+    std::error_code errorCode;
+    const auto tempDirectory = std::filesystem::temp_directory_path(errorCode);
+    if (errorCode)
+    {
+        return {};
+    }
+    return tempDirectory / "spectr" / "opencl_program_cache";
+}
+
+/**
+ * @brief 64-bit FNV-1a hash. Unlike std::hash it's stable between runs and compilers.
+ */
+uint64_t getHash(const std::string& data)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (const auto c : data)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+std::string toHexString(uint64_t value)
+{
+    std::stringstream ss;
+    ss << std::hex << std::setw(16) << std::setfill('0') << value;
+    return ss.str();
+}
+
+std::string getCacheKey(const cl::Device& device,
+                        const std::string& source,
+                        const std::string& buildOptions)
+{
+    std::stringstream ss;
+    ss << "device: " << device.getInfo<CL_DEVICE_NAME>().c_str() << "\n";
+    ss << "vendor: " << device.getInfo<CL_DEVICE_VENDOR>().c_str() << "\n";
+    ss << "device version: " << device.getInfo<CL_DEVICE_VERSION>().c_str() << "\n";
+    ss << "driver version: " << device.getInfo<CL_DRIVER_VERSION>().c_str() << "\n";
+    ss << "source hash: " << toHexString(getHash(source)) << "\n";
+    ss << "build options: " << buildOptions;
+    return ss.str();
+}
+
+std::optional<std::vector<unsigned char>> readCacheEntry(const std::filesystem::path& path,
+                                                         const std::string& key)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        return std::nullopt;
+    }
+
+    std::string magic(CacheFileMagic.size(), '\0');
+    uint64_t keySize = 0;
+    file.read(magic.data(), magic.size());
+    file.read(reinterpret_cast<char*>(&keySize), sizeof(keySize));
+    if (!file || magic != CacheFileMagic || keySize != key.size())
+    {
+        return std::nullopt;
+    }
+
+    // the full key is stored in the entry to detect hash collisions of file names
+    std::string storedKey(keySize, '\0');
+    uint64_t binarySize = 0;
+    file.read(storedKey.data(), storedKey.size());
+    file.read(reinterpret_cast<char*>(&binarySize), sizeof(binarySize));
+    if (!file || storedKey != key || binarySize == 0)
+    {
+        return std::nullopt;
+    }
+
+    std::vector<unsigned char> binary(binarySize);
+    file.read(reinterpret_cast<char*>(binary.data()), binary.size());
+    if (!file)
+    {
+        return std::nullopt;
+    }
+
+    return binary;
+}
+
+void writeCacheEntry(const std::filesystem::path& path,
+                     const std::string& key,
+                     const std::vector<unsigned char>& binary)
+{
+    std::error_code errorCode;
+    std::filesystem::create_directories(path.parent_path(), errorCode);
+    if (errorCode)
+    {
+        std::cerr << "Failed to create OpenCL program cache directory: " << errorCode.message()
+                  << std::endl;
+        return;
+    }
+
+    // write to a unique temporary file first, so concurrent builds never observe partial entries
+    std::stringstream tempName;
+    tempName << path.filename().string() << "." << std::this_thread::get_id() << ".tmp";
+    const auto tempPath = path.parent_path() / tempName.str();
+
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        const uint64_t keySize = key.size();
+        const uint64_t binarySize = binary.size();
+        file.write(CacheFileMagic.data(), CacheFileMagic.size());
+        file.write(reinterpret_cast<const char*>(&keySize), sizeof(keySize));
+        file.write(key.data(), key.size());
+        file.write(reinterpret_cast<const char*>(&binarySize), sizeof(binarySize));
+        file.write(reinterpret_cast<const char*>(binary.data()), binary.size());
+        if (!file)
+        {
+            std::cerr << "Failed to write OpenCL program cache entry: " << tempPath << std::endl;
+            file.close();
+            std::filesystem::remove(tempPath, errorCode);
+            return;
+        }
+    }
+
+    std::filesystem::rename(tempPath, path, errorCode);
+    if (errorCode)
+    {
+        std::filesystem::remove(tempPath, errorCode);
+    }
+}
+}
+
+cl::Program OpenclProgramCache::build(cl::Context context,
+                                      const std::string& source,
+                                      const std::string& buildOptions)
+{
+    const auto directory = getCacheDirectory();
+    if (directory.empty())
+    {
+        return buildFromSource(context, source, buildOptions);
+    }
+
+    const auto device = OpenclUtils::getDevice(context);
+    const auto key = getCacheKey(device, source, buildOptions);
+    const auto entryPath = directory / (toHexString(getHash(key)) + CacheFileExtension);
+
+    if (const auto binary = readCacheEntry(entryPath, key))
+    {
+        try
+        {
+            cl::Program program{ context, { device }, { *binary } };
+            program.build(buildOptions.c_str());
+            return program;
+        }
+        catch (const cl::Error& ex)
+        {
+            std::cerr << "Cached OpenCL program binary is rejected, rebuilding from source. "
+                      << "Error code: " << ex.err() << std::endl;
+        }
+    }
+
+    auto program = buildFromSource(context, source, buildOptions);
+
+    const auto binaries = program.getInfo<CL_PROGRAM_BINARIES>();
+    if (binaries.size() == 1 && !binaries.front().empty())
+    {
+        writeCacheEntry(entryPath, key, binaries.front());
+    }
+
+    return program;
+}
+
+cl::Program OpenclProgramCache::buildFromSource(cl::Context context,
+                                                const std::string& source,
+                                                const std::string& buildOptions)
+{
+    cl::Program program{ context, source };
+    try
+    {
+        program.build(buildOptions.c_str());
+    }
+    catch (const cl::BuildError& ex)
+    {
+        std::stringstream ss;
+        for (const auto& pair : ex.getBuildLog())
+        {
+            ss << pair.second << "\n";
+        }
+
+        throw utils::Exception(
+          "Failed to build a kernel. Error code: {}\n Error log:\n{}", ex.err(), ss.str());
+    }
+    return program;
+}
+
+void OpenclProgramCache::setCacheDirectory(const std::filesystem::path& directory)
+{
+    std::lock_guard<std::mutex> guard{ cacheDirectoryMutex };
+    cacheDirectory = directory;
+}
+
+std::filesystem::path OpenclProgramCache::getCacheDirectory()
+{
+    std::lock_guard<std::mutex> guard{ cacheDirectoryMutex };
+    if (!cacheDirectory)
+    {
+        cacheDirectory = getDefaultCacheDirectory();
+    }
+    return *cacheDirectory;
+}
+}
@@ -0,0 +1,121 @@
+#include <spectr/calc_opencl/OpenglRtsaHeatmapSink.h>
+
+#include <spectr/render_gl/GraphicsApi.h>
+
+#include <iostream>
+
+namespace spectr::calc_opencl
+{
+OpenglSharedRtsaHeatmapSink::OpenglSharedRtsaHeatmapSink(cl::Context context,
+                                                         uint32_t openglBuffer,
+                                                         size_t size)
+  : m_size{ size }
+  , m_sharedBuffer{ context, CL_MEM_WRITE_ONLY, openglBuffer }
+{
+}
+
+void OpenglSharedRtsaHeatmapSink::write(cl::CommandQueue& queue,
+                                        const cl::Buffer& heatmapBuffer,
+                                        const std::vector<RtsaDirtyRange>& dirtyRanges,
+                                        OpenclProfilingEvents& profilingEvents)
+{
+    if (dirtyRanges.empty())
+    {
+        return;
+    }
+
+    // implicit synchronization: OpenGL must not use the buffer while OpenCL owns it
+    glFinish();
+
+    const std::vector<cl::Memory> sharedObjects{ m_sharedBuffer };
+    queue.enqueueAcquireGLObjects(&sharedObjects);
+    for (const auto& range : dirtyRanges)
+    {
+        queue.enqueueCopyBuffer(heatmapBuffer,
+                                m_sharedBuffer,
+                                range.offset,
+                                range.offset,
+                                range.size,
+                                nullptr,
+                                profilingEvents.add("copy density heatmap to OpenGL"));
+    }
+    queue.enqueueReleaseGLObjects(&sharedObjects);
+    queue.finish();
+}
+
+size_t OpenglSharedRtsaHeatmapSink::getSize() const
+{
+    return m_size;
+}
+
+OpenglCopyRtsaHeatmapSink::OpenglCopyRtsaHeatmapSink(cl::Context context,
+                                                     uint32_t openglBuffer,
+                                                     size_t size)
+  : m_size{ size }
+  , m_openglBuffer{ openglBuffer }
+  , m_queue{ context }
+  , m_stagingBuffer{ context, CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR, size }
+{
+    // reads to the mapped host-allocated buffer go with the pinned memory transfer speed
+    m_stagingMemory = m_queue.enqueueMapBuffer(m_stagingBuffer, true, CL_MAP_READ, 0, m_size);
+}
+
+OpenglCopyRtsaHeatmapSink::~OpenglCopyRtsaHeatmapSink()
+{
+    m_queue.enqueueUnmapMemObject(m_stagingBuffer, m_stagingMemory);
+    m_queue.finish();
+}
+
+void OpenglCopyRtsaHeatmapSink::write(cl::CommandQueue& queue,
+                                      const cl::Buffer& heatmapBuffer,
+                                      const std::vector<RtsaDirtyRange>& dirtyRanges,
+                                      OpenclProfilingEvents& profilingEvents)
+{
+    const auto stagingMemory = static_cast<uint8_t*>(m_stagingMemory);
+    for (const auto& range : dirtyRanges)
+    {
+        queue.enqueueReadBuffer(heatmapBuffer,
+                                false,
+                                range.offset,
+                                range.size,
+                                stagingMemory + range.offset,
+                                nullptr,
+                                profilingEvents.add("read density heatmap"));
+    }
+    queue.finish();
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_openglBuffer);
+    for (const auto& range : dirtyRanges)
+    {
+        glBufferSubData(
+          GL_SHADER_STORAGE_BUFFER, range.offset, range.size, stagingMemory + range.offset);
+    }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+size_t OpenglCopyRtsaHeatmapSink::getSize() const
+{
+    return m_size;
+}
+
+std::shared_ptr<RtsaHeatmapSink> createOpenglRtsaHeatmapSink(cl::Context context,
+                                                             bool isOpenglSharingEnabled,
+                                                             uint32_t openglBuffer,
+                                                             size_t size)
+{
+    if (isOpenglSharingEnabled)
+    {
+        try
+        {
+            return std::make_shared<OpenglSharedRtsaHeatmapSink>(context, openglBuffer, size);
+        }
+        catch (const cl::Error& error)
+        {
+            std::cout << "Failed to share RTSA buffer with OpenCL (" << error.what() << ", "
+                      << error.err() << "), falling back to host copy" << std::endl;
+        }
+    }
+
+    return std::make_shared<OpenglCopyRtsaHeatmapSink>(context, openglBuffer, size);
+}
+}
@@ -0,0 +1,84 @@
+#include <spectr/calc_opencl/RtsaHeatmapSink.h>
+
+#include <algorithm>
+#include <iterator>
+
+namespace spectr::calc_opencl
+{
+std::vector<RtsaDirtyRange> mergeRtsaDirtyRanges(const std::vector<RtsaDirtyRange>& left,
+                                                 const std::vector<RtsaDirtyRange>& right)
+{
+    std::vector<RtsaDirtyRange> ranges;
+    ranges.reserve(left.size() + right.size());
+    std::merge(left.begin(),
+               left.end(),
+               right.begin(),
+               right.end(),
+               std::back_inserter(ranges),
+               [](const RtsaDirtyRange& a, const RtsaDirtyRange& b)
+               { return a.offset < b.offset; });
+
+    std::vector<RtsaDirtyRange> merged;
+    merged.reserve(ranges.size());
+    for (const auto& range : ranges)
+    {
+        if (!merged.empty() && range.offset <= merged.back().offset + merged.back().size)
+        {
+            auto& last = merged.back();
+            last.size = std::max(last.offset + last.size, range.offset + range.size) - last.offset;
+        }
+        else
+        {
+            merged.push_back(range);
+        }
+    }
+
+    return merged;
+}
+
+HostRtsaHeatmapSink::HostRtsaHeatmapSink(size_t size)
+  : m_data(size)
+{
+}
+
+void HostRtsaHeatmapSink::write(cl::CommandQueue& queue,
+                                const cl::Buffer& heatmapBuffer,
+                                const std::vector<RtsaDirtyRange>& dirtyRanges,
+                                OpenclProfilingEvents& profilingEvents)
+{
+    for (const auto& range : dirtyRanges)
+    {
+        queue.enqueueReadBuffer(heatmapBuffer,
+                                false,
+                                range.offset,
+                                range.size,
+                                m_data.data() + range.offset,
+                                nullptr,
+                                profilingEvents.add("read density heatmap"));
+    }
+    queue.finish();
+
+    m_lastDirtyRanges = dirtyRanges;
+    ++m_writeCount;
+}
+
+size_t HostRtsaHeatmapSink::getSize() const
+{
+    return m_data.size();
+}
+
+const std::vector<uint8_t>& HostRtsaHeatmapSink::getData() const
+{
+    return m_data;
+}
+
+const std::vector<RtsaDirtyRange>& HostRtsaHeatmapSink::getLastDirtyRanges() const
+{
+    return m_lastDirtyRanges;
+}
+
+size_t HostRtsaHeatmapSink::getWriteCount() const
+{
+    return m_writeCount;
+}
+}
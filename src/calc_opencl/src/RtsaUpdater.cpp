@@ -1,16 +1,93 @@
 #include <spectr/calc_opencl/RtsaUpdater.h>
 
-#include <spectr/render_gl/GraphicsApi.h>
+#include <spectr/calc_opencl/OpenclProgramCache.h>
 
 #include <spectr/utils/Asset.h>
 #include <spectr/utils/Exception.h>
 #include <spectr/utils/File.h>
 
+#include <algorithm>
+#include <cmath>
+
 namespace spectr::calc_opencl
 {
 namespace
 {
 const std::string KernelAssetPath{ "opencl/DensityHeatmapUpdater.cl" };
+
+constexpr size_t DirtyTileSize = 4096;    // bytes, a tile is transferred whole
+constexpr size_t MaxDirtyRangeCount = 64; // more ranges are merged to limit transfer calls
+
+size_t floorPowerOfTwo(size_t value)
+{
+    size_t result = 1;
+    while (result * 2 <= value)
+    {
+        result *= 2;
+    }
+    return result;
+}
+
+/**
+ * @brief Joins runs of the dirty tiles into byte ranges, then merges the ranges separated by the
+ * smallest gaps until there are at most maxRangeCount of them.
+ */
+std::vector<RtsaDirtyRange> getDirtyRanges(const std::vector<uint8_t>& dirtyTiles,
+                                           size_t tileSize,
+                                           size_t bufferSize,
+                                           size_t maxRangeCount)
+{
+    std::vector<RtsaDirtyRange> ranges;
+    for (size_t tileIndex = 0; tileIndex < dirtyTiles.size(); ++tileIndex)
+    {
+        if (!dirtyTiles[tileIndex])
+        {
+            continue;
+        }
+
+        const auto offset = tileIndex * tileSize;
+        const auto size = std::min(tileSize, bufferSize - offset);
+        if (!ranges.empty() && ranges.back().offset + ranges.back().size == offset)
+        {
+            ranges.back().size += size;
+        }
+        else
+        {
+            ranges.push_back({ offset, size });
+        }
+    }
+
+    while (ranges.size() > maxRangeCount)
+    {
+        std::vector<size_t> gaps;
+        gaps.reserve(ranges.size() - 1);
+        for (size_t i = 1; i < ranges.size(); ++i)
+        {
+            gaps.push_back(ranges[i].offset - (ranges[i - 1].offset + ranges[i - 1].size));
+        }
+
+        const auto mergedGapCount = ranges.size() - maxRangeCount;
+        std::nth_element(gaps.begin(), gaps.begin() + (mergedGapCount - 1), gaps.end());
+        const auto maxMergedGap = gaps[mergedGapCount - 1];
+
+        std::vector<RtsaDirtyRange> mergedRanges{ ranges.front() };
+        for (size_t i = 1; i < ranges.size(); ++i)
+        {
+            auto& last = mergedRanges.back();
+            if (ranges[i].offset - (last.offset + last.size) <= maxMergedGap)
+            {
+                last.size = ranges[i].offset + ranges[i].size - last.offset;
+            }
+            else
+            {
+                mergedRanges.push_back(ranges[i]);
+            }
+        }
+        ranges = std::move(mergedRanges);
+    }
+
+    return ranges;
+}
 }
 
 RtsaUpdater::RtsaUpdater(cl::Context context,
@@ -18,127 +95,531 @@ RtsaUpdater::RtsaUpdater(cl::Context context,
                          size_t magnitudeResolution,
                          size_t historyBuffersCount,
                          float magnitudeDbfsRange,
-                         size_t bufferSize)
+                         size_t bufferSize,
+                         RtsaUpdateMode mode,
+                         utils::RtsaStorageFormat storageFormat,
+                         std::shared_ptr<OpenclProfiler> profiler)
   : m_frequencyCount{ frequencyCount }
   , m_magnitudeResolution{ magnitudeResolution }
+  , m_levelCount{ render_gl::getRtsaLevelCount(m_magnitudeResolution) }
   , m_historyBuffersCount{ historyBuffersCount }
   , m_magnitudeDbfsRange{ magnitudeDbfsRange }
+  , m_mode{ mode }
+  , m_storageFormat{ storageFormat }
   , m_context{ context }
   , m_device{ OpenclUtils::getDevice(m_context) }
-  , m_queue{ m_context }
+  , m_profiler{ std::move(profiler) }
+  , m_profilingEvents{ m_profiler.get() }
+  , m_queue{ m_context, OpenclProfiler::getQueueProperties(m_profiler.get()) }
+  , m_persistenceFrameCount{ static_cast<float>(historyBuffersCount) }
   , m_bufferSize{ bufferSize }
-  , m_hostMappedMemory{ NULL }
 {
-    // allocate history buffer
-    const auto historyBufferSize = sizeof(float) * m_frequencyCount * m_historyBuffersCount;
-    m_historyBuffer = cl::Buffer(m_context, CL_MEM_READ_WRITE, historyBufferSize);
+    // allocate history buffer, the exponential decay doesn't need it
+    if (m_mode != RtsaUpdateMode::ExponentialDecay)
+    {
+        const auto historyBufferSize = sizeof(float) * m_frequencyCount * m_historyBuffersCount;
+        m_historyBuffer = cl::Buffer(m_context, CL_MEM_READ_WRITE, historyBufferSize);
 
-    m_queue.enqueueFillBuffer<cl_float>(m_historyBuffer, -1000.0f, 0, historyBufferSize);
+        m_queue.enqueueFillBuffer<cl_float>(m_historyBuffer, -1000.0f, 0, historyBufferSize);
+    }
+
+    m_hostMagnitudesBuffer =
+      cl::Buffer(m_context, CL_MEM_READ_WRITE, sizeof(float) * m_frequencyCount);
+    m_convertedDbfsBuffer =
+      cl::Buffer(m_context, CL_MEM_READ_WRITE, sizeof(float) * m_frequencyCount);
 
     // compile OpenCL program
     const auto sourcePath = utils::Asset::getPath(KernelAssetPath);
     const auto source = utils::File::read(sourcePath);
-    m_program = { m_context, source };
-    try
+    std::string buildOptions = "-cl-std=CL2.0";
+    if (m_storageFormat == utils::RtsaStorageFormat::Unorm16x2)
+    {
+        buildOptions += " -DRTSA_PACKED";
+    }
+    const auto cellSize = m_storageFormat == utils::RtsaStorageFormat::Unorm16x2
+                            ? sizeof(cl_uint)
+                            : sizeof(cl_float2);
+    const auto dirtyTileCellCount = std::max<size_t>(DirtyTileSize / cellSize, 1);
+    m_dirtyTileSize = dirtyTileCellCount * cellSize;
+    buildOptions += " -DDIRTY_TILE_CELL_COUNT=" + std::to_string(dirtyTileCellCount);
+
+    m_program = OpenclProgramCache::build(m_context, source, buildOptions);
+
+    // Allocate work buffer, kernels store only the changed cells, so it starts zeroed
+    m_workBuffer = cl::Buffer(m_context, CL_MEM_READ_WRITE, m_bufferSize);
+    m_queue.enqueueFillBuffer<cl_uchar>(m_workBuffer, 0, 0, m_bufferSize);
+
+    // the destination isn't initialized, so the first update transfers everything
+    m_dirtyTiles.resize((m_bufferSize + m_dirtyTileSize - 1) / m_dirtyTileSize);
+    m_dirtyTilesBuffer = cl::Buffer(m_context, CL_MEM_READ_WRITE, m_dirtyTiles.size());
+    m_queue.enqueueFillBuffer<cl_uchar>(m_dirtyTilesBuffer, 1, 0, m_dirtyTiles.size());
+
+    if (m_mode == RtsaUpdateMode::Incremental)
     {
-        std::stringstream ss;
-        ss << "-cl-std=CL2.0";
-        const auto compilerDirectives = ss.str();
-        m_program.build(compilerDirectives.c_str());
+        const auto cellsBufferSize = sizeof(cl_uint) * m_frequencyCount * m_magnitudeResolution;
+        m_hitCountsBuffer = cl::Buffer(m_context, CL_MEM_READ_WRITE, cellsBufferSize);
+        m_timestampSumsBuffer = cl::Buffer(m_context, CL_MEM_READ_WRITE, cellsBufferSize);
+        m_queue.enqueueFillBuffer<cl_uint>(m_hitCountsBuffer, 0, 0, cellsBufferSize);
+        m_queue.enqueueFillBuffer<cl_uint>(m_timestampSumsBuffer, 0, 0, cellsBufferSize);
     }
-    catch (const cl::BuildError& ex)
+
+    if (m_mode == RtsaUpdateMode::Scatter)
     {
-        const auto buildOptions = m_program.getBuildInfo<CL_PROGRAM_BUILD_OPTIONS>();
-        const auto buildStatus = m_program.getBuildInfo<CL_PROGRAM_BUILD_STATUS>();
-        const auto buildInfo = m_program.getBuildInfo<CL_PROGRAM_BUILD_LOG>();
+        const auto cellsBufferSize = sizeof(cl_uint) * m_frequencyCount * m_magnitudeResolution;
+        m_hitCountsBuffer = cl::Buffer(m_context, CL_MEM_READ_WRITE, cellsBufferSize);
+        m_ageSumsBuffer = cl::Buffer(m_context, CL_MEM_READ_WRITE, cellsBufferSize);
 
-        std::stringstream ss;
-        for (const auto& pair : ex.getBuildLog())
+        // a work group keeps hit counts and age sums of its frequencies in the local memory
+        const auto localMemorySize = m_device.getInfo<CL_DEVICE_LOCAL_MEM_SIZE>();
+        const auto localFrequencySize = 2 * sizeof(cl_uint) * m_magnitudeResolution;
+        if (localFrequencySize > localMemorySize)
         {
-            ss << pair.second << "\n";
+            throw utils::Exception(
+              "RTSA scatter mode requires {} bytes of local memory, available: {}",
+              localFrequencySize,
+              localMemorySize);
         }
 
-        throw utils::Exception(
-          "Failed to build a kernel. Error code: {}\n Error log:\n{}", ex.err(), ss.str());
+        const cl::Kernel scatterKernel{ m_program, "scatterDensityHits" };
+        const auto maxWorkGroupSize =
+          scatterKernel.getWorkGroupInfo<CL_KERNEL_WORK_GROUP_SIZE>(m_device);
+        m_scatterLocalFrequencyCount = floorPowerOfTwo(std::min(
+          { localMemorySize / localFrequencySize, maxWorkGroupSize, m_frequencyCount }));
+        m_scatterLocalFrameCount =
+          std::min(floorPowerOfTwo(maxWorkGroupSize / m_scatterLocalFrequencyCount),
+                   floorPowerOfTwo(m_historyBuffersCount));
     }
 
-    // Allocate work buffer
-    m_workBuffer = cl::Buffer(m_context, CL_MEM_READ_WRITE, m_bufferSize);
-    m_hostPinnedMemory = (float*)m_queue.enqueueMapBuffer(m_workBuffer, false, 0, 0, m_bufferSize);
+    // float heatmap is the persistence state of the exponential decay, packed one needs a copy
+    if (m_mode == RtsaUpdateMode::ExponentialDecay)
+    {
+        if (m_storageFormat == utils::RtsaStorageFormat::Float2)
+        {
+            m_decayStateBuffer = m_workBuffer;
+        }
+        else
+        {
+            const auto stateBufferSize =
+              sizeof(cl_float2) * m_frequencyCount * m_magnitudeResolution;
+            m_decayStateBuffer = cl::Buffer(m_context, CL_MEM_READ_WRITE, stateBufferSize);
+            m_queue.enqueueFillBuffer<cl_float>(m_decayStateBuffer, 0.0f, 0, stateBufferSize);
+        }
+    }
 }
 
-RtsaUpdater::~RtsaUpdater() {
-    m_queue.enqueueUnmapMemObject(m_workBuffer, m_hostPinnedMemory);
+RtsaUpdater::~RtsaUpdater() = default;
 
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_openglBuffer);
-    glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+void RtsaUpdater::update(const float* magnitudes, RtsaHeatmapSink& sink, float referenceValue)
+{
+    process(magnitudes, referenceValue);
+    write(sink);
 }
 
-void RtsaUpdater::update(cl::Buffer magnitudesBuffer,
-                         uint32_t openglBuffer,
-                         float referenceValue)
+void RtsaUpdater::update(cl::Buffer magnitudesBuffer, RtsaHeatmapSink& sink, float referenceValue)
 {
-    // calculate dBFS values
-    {
-        /*OpenclUtils::printVector<float>(
-          m_queue, magnitudesBuffer, m_frequencyCount, "Magnitudes values:\n");*/
+    convertToDbfs(magnitudesBuffer, referenceValue);
+    updateDbfs(m_convertedDbfsBuffer, sink);
+}
 
-        // TODO copy to other buffer instead of calculating in place ?
+void RtsaUpdater::updateDbfs(cl::Buffer dbfsBuffer, RtsaHeatmapSink& sink)
+{
+    processDbfs(dbfsBuffer);
+    write(sink);
+}
 
-        auto calculateDbfsKernel = cl::KernelFunctor<cl::Buffer, float>(m_program, "convertToDBFS");
+void RtsaUpdater::process(cl::Buffer magnitudesBuffer, float referenceValue)
+{
+    convertToDbfs(magnitudesBuffer, referenceValue);
+    processDbfs(m_convertedDbfsBuffer);
+}
 
-        const cl::NDRange globalGroupSize{ m_frequencyCount };
-        const cl::NDRange localGroupSize{ std::min(m_frequencyCount, static_cast<size_t>(64)) };
-        const cl::EnqueueArgs enqueueArgs(m_queue, globalGroupSize, localGroupSize);
-        calculateDbfsKernel(enqueueArgs, magnitudesBuffer, referenceValue);
+void RtsaUpdater::process(const float* magnitudes, float referenceValue)
+{
+    m_queue.enqueueWriteBuffer(m_hostMagnitudesBuffer,
+                               true,
+                               0,
+                               sizeof(float) * m_frequencyCount,
+                               magnitudes,
+                               nullptr,
+                               m_profilingEvents.add("write host magnitudes"));
+    process(m_hostMagnitudesBuffer, referenceValue);
+}
 
-        // OpenclUtils::printVector<float>(m_queue, magnitudesBuffer, m_frequencyCount, "");
+void RtsaUpdater::write(RtsaHeatmapSink& sink)
+{
+    // the dirty ranges cover the whole heatmap
+    if (sink.getSize() != m_bufferSize)
+    {
+        throw utils::Exception("RTSA heatmap sink size {} doesn't match the heatmap size {}",
+                               sink.getSize(),
+                               m_bufferSize);
+    }
+
+    sink.write(m_queue, m_workBuffer, takeDirtyRanges(), m_profilingEvents);
+    m_profilingEvents.flush();
+}
+
+void RtsaUpdater::processDbfs(cl::Buffer dbfsBuffer)
+{
+    m_dbfsBuffer = dbfsBuffer;
+    applyRequestedLevel();
+
+    if (m_mode == RtsaUpdateMode::ExponentialDecay)
+    {
+        updateExponentialDecay(dbfsBuffer);
+        m_queue.finish();
+        m_profilingEvents.flush();
+        return;
     }
 
-    // copy to the storage buffer
     const auto currentHistoryBuffer = m_nextBufferIndex;
     m_nextBufferIndex = (m_nextBufferIndex + 1) % m_historyBuffersCount;
+
+    // the incremental update reads the evicted frame, so it goes before the copy
+    if (m_mode == RtsaUpdateMode::Incremental)
+    {
+        updateIncremental(dbfsBuffer, currentHistoryBuffer);
+    }
+
+    // copy to the storage buffer
     {
         const auto magnitudeBufferSize = sizeof(float) * m_frequencyCount;
         const auto dstOffset = magnitudeBufferSize * currentHistoryBuffer;
 
-        m_queue.enqueueCopyBuffer(
-          magnitudesBuffer, m_historyBuffer, 0, dstOffset, magnitudeBufferSize);
+        m_queue.enqueueCopyBuffer(dbfsBuffer,
+                                  m_historyBuffer,
+                                  0,
+                                  dstOffset,
+                                  magnitudeBufferSize,
+                                  nullptr,
+                                  m_profilingEvents.add("copy dBFS to history"));
+    }
+
+    if (m_mode == RtsaUpdateMode::Gather)
+    {
+        updateGather(currentHistoryBuffer);
+    }
+    else if (m_mode == RtsaUpdateMode::Scatter)
+    {
+        updateScatter(currentHistoryBuffer);
+    }
+
+    ++m_timestamp;
+    m_queue.finish();
+    m_profilingEvents.flush();
+}
+
+cl::Buffer RtsaUpdater::getHeatmapBuffer() const
+{
+    return m_workBuffer;
+}
+
+cl::Buffer RtsaUpdater::getDbfsBuffer() const
+{
+    return m_dbfsBuffer;
+}
+
+RtsaUpdateMode RtsaUpdater::getMode() const
+{
+    return m_mode;
+}
+
+utils::RtsaStorageFormat RtsaUpdater::getStorageFormat() const
+{
+    return m_storageFormat;
+}
+
+void RtsaUpdater::setPersistence(float frameCount)
+{
+    if (!(frameCount > 0.0f))
+    {
+        throw utils::Exception("RTSA persistence must be positive, actual: {} frames", frameCount);
+    }
+    m_persistenceFrameCount = frameCount;
+}
+
+float RtsaUpdater::getPersistence() const
+{
+    return m_persistenceFrameCount;
+}
+
+size_t RtsaUpdater::getLevelCount() const
+{
+    return m_levelCount;
+}
+
+void RtsaUpdater::setLevel(size_t level)
+{
+    if (level >= m_levelCount)
+    {
+        throw utils::Exception(
+          "RTSA level {} is out of range, level count: {}", level, m_levelCount);
     }
+    m_requestedLevel = level;
+}
 
-    if (!m_hostMappedMemory) {
-        glBindBuffer(GL_SHADER_STORAGE_BUFFER, openglBuffer);
-        m_hostMappedMemory = (float*)glMapBuffer(GL_SHADER_STORAGE_BUFFER, GL_WRITE_ONLY);
-        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+size_t RtsaUpdater::getLevel() const
+{
+    return m_level;
+}
 
-        m_openglBuffer = openglBuffer;
+void RtsaUpdater::applyRequestedLevel()
+{
+    const size_t level = m_requestedLevel;
+    if (level == m_level)
+    {
+        return;
     }
 
-    // update the density heatmap
+    const auto previousResolution = getLevelResolution();
+    m_level = level;
+    const auto resolution = getLevelResolution();
+    const auto magnitudeIndexToDbfsCoeff = m_magnitudeDbfsRange / resolution;
+
+    if (m_mode == RtsaUpdateMode::Incremental)
     {
-        auto updateDensityHeatmapKernel =
-          cl::KernelFunctor<cl::Buffer, cl::Buffer, cl_uint, cl_uint, cl_uint, cl_uint, float>(
-            m_program, "updateDensityHeatmap");
-        
-        const cl::NDRange globalGroupSize{ m_frequencyCount, m_magnitudeResolution };
-        const cl::EnqueueArgs enqueueArgs(m_queue, globalGroupSize);
-        
-        const auto magnitudeIndexToDbfsCoeff = m_magnitudeDbfsRange / m_magnitudeResolution;
-                
-        updateDensityHeatmapKernel(enqueueArgs,
-                                   m_workBuffer,
-                                   m_historyBuffer,
-                                   static_cast<cl_uint>(m_frequencyCount),
-                                   static_cast<cl_uint>(m_magnitudeResolution),
-                                   static_cast<cl_uint>(m_historyBuffersCount),
-                                   static_cast<cl_uint>(currentHistoryBuffer),
-                                   static_cast<float>(magnitudeIndexToDbfsCoeff));
+        const auto cellsBufferSize = sizeof(cl_uint) * m_frequencyCount * resolution;
+        m_queue.enqueueFillBuffer<cl_uint>(m_hitCountsBuffer, 0, 0, cellsBufferSize);
+        m_queue.enqueueFillBuffer<cl_uint>(m_timestampSumsBuffer, 0, 0, cellsBufferSize);
 
-        m_queue.enqueueReadBuffer(m_workBuffer, false, 0, m_bufferSize, m_hostMappedMemory);
-        m_queue.finish();
+        const auto mostRecentBufferIndex =
+          (m_nextBufferIndex + m_historyBuffersCount - 1) % m_historyBuffersCount;
 
-        //std::memcpy(m_hostMappedMemory, m_hostPinnedMemory, m_bufferSize);
+        auto rebuildHitCountsKernel = cl::KernelFunctor<cl::Buffer,
+                                                        cl::Buffer,
+                                                        cl::Buffer,
+                                                        cl_uint,
+                                                        cl_uint,
+                                                        cl_uint,
+                                                        cl_uint,
+                                                        cl_uint,
+                                                        float>(m_program, "rebuildHitCounts");
+        auto event =
+          rebuildHitCountsKernel(cl::EnqueueArgs(m_queue, cl::NDRange(m_frequencyCount)),
+                                 m_hitCountsBuffer,
+                                 m_timestampSumsBuffer,
+                                 m_historyBuffer,
+                                 static_cast<cl_uint>(m_frequencyCount),
+                                 static_cast<cl_uint>(resolution),
+                                 static_cast<cl_uint>(m_historyBuffersCount),
+                                 static_cast<cl_uint>(mostRecentBufferIndex),
+                                 m_timestamp - 1,
+                                 static_cast<float>(magnitudeIndexToDbfsCoeff));
+        m_profilingEvents.add("rebuildHitCounts", std::move(event));
     }
+
+    if (m_mode == RtsaUpdateMode::ExponentialDecay)
+    {
+        const auto stateBufferSize = sizeof(cl_float2) * m_frequencyCount * m_magnitudeResolution;
+        if (!m_decayScratchBuffer())
+        {
+            m_decayScratchBuffer = cl::Buffer(m_context, CL_MEM_READ_WRITE, stateBufferSize);
+        }
+
+        m_queue.enqueueCopyBuffer(m_decayStateBuffer,
+                                  m_decayScratchBuffer,
+                                  0,
+                                  0,
+                                  sizeof(cl_float2) * m_frequencyCount * previousResolution);
+
+        auto resampleDecayStateKernel =
+          cl::KernelFunctor<cl::Buffer, cl::Buffer, cl_uint, cl_uint>(m_program,
+                                                                      "resampleDecayState");
+        auto event = resampleDecayStateKernel(
+          cl::EnqueueArgs(m_queue, cl::NDRange(m_frequencyCount, resolution)),
+          m_decayScratchBuffer,
+          m_decayStateBuffer,
+          static_cast<cl_uint>(previousResolution),
+          static_cast<cl_uint>(resolution));
+        m_profilingEvents.add("resampleDecayState", std::move(event));
+    }
+
+    // the layout of the heatmap has changed, so it is transferred whole
+    m_queue.enqueueFillBuffer<cl_uchar>(m_dirtyTilesBuffer, 1, 0, m_dirtyTiles.size());
+}
+
+size_t RtsaUpdater::getLevelResolution() const
+{
+    return render_gl::getRtsaLevelResolution(m_magnitudeResolution, m_level);
+}
+
+void RtsaUpdater::updateGather(size_t currentHistoryBuffer)
+{
+    auto updateDensityHeatmapKernel = cl::KernelFunctor<cl::Buffer,
+                                                        cl::Buffer,
+                                                        cl::Buffer,
+                                                        cl_uint,
+                                                        cl_uint,
+                                                        cl_uint,
+                                                        cl_uint,
+                                                        float>(m_program, "updateDensityHeatmap");
+
+    const auto resolution = getLevelResolution();
+    const cl::NDRange globalGroupSize{ m_frequencyCount, resolution };
+    const cl::EnqueueArgs enqueueArgs(m_queue, globalGroupSize);
+
+    const auto magnitudeIndexToDbfsCoeff = m_magnitudeDbfsRange / resolution;
+
+    auto event = updateDensityHeatmapKernel(enqueueArgs,
+                                            m_workBuffer,
+                                            m_dirtyTilesBuffer,
+                                            m_historyBuffer,
+                                            static_cast<cl_uint>(m_frequencyCount),
+                                            static_cast<cl_uint>(resolution),
+                                            static_cast<cl_uint>(m_historyBuffersCount),
+                                            static_cast<cl_uint>(currentHistoryBuffer),
+                                            static_cast<float>(magnitudeIndexToDbfsCoeff));
+    m_profilingEvents.add("updateDensityHeatmap", std::move(event));
+}
+
+void RtsaUpdater::updateScatter(size_t currentHistoryBuffer)
+{
+    const auto resolution = getLevelResolution();
+    const auto cellsBufferSize = sizeof(cl_uint) * m_frequencyCount * resolution;
+    m_queue.enqueueFillBuffer<cl_uint>(m_hitCountsBuffer, 0, 0, cellsBufferSize);
+    m_queue.enqueueFillBuffer<cl_uint>(m_ageSumsBuffer, 0, 0, cellsBufferSize);
+
+    const auto magnitudeIndexToDbfsCoeff = m_magnitudeDbfsRange / resolution;
+    const auto localCellCount = m_scatterLocalFrequencyCount * resolution;
+
+    auto scatterDensityHitsKernel = cl::KernelFunctor<cl::Buffer,
+                                                      cl::Buffer,
+                                                      cl::Buffer,
+                                                      cl::LocalSpaceArg,
+                                                      cl::LocalSpaceArg,
+                                                      cl_uint,
+                                                      cl_uint,
+                                                      cl_uint,
+                                                      cl_uint,
+                                                      float>(m_program, "scatterDensityHits");
+
+    const cl::NDRange globalSize{
+        (m_frequencyCount + m_scatterLocalFrequencyCount - 1) / m_scatterLocalFrequencyCount *
+          m_scatterLocalFrequencyCount,
+        (m_historyBuffersCount + m_scatterLocalFrameCount - 1) / m_scatterLocalFrameCount *
+          m_scatterLocalFrameCount,
+    };
+    const cl::NDRange localSize{ m_scatterLocalFrequencyCount, m_scatterLocalFrameCount };
+    auto scatterEvent =
+      scatterDensityHitsKernel(cl::EnqueueArgs(m_queue, globalSize, localSize),
+                               m_hitCountsBuffer,
+                               m_ageSumsBuffer,
+                               m_historyBuffer,
+                               cl::Local(sizeof(cl_uint) * localCellCount),
+                               cl::Local(sizeof(cl_uint) * localCellCount),
+                               static_cast<cl_uint>(m_frequencyCount),
+                               static_cast<cl_uint>(resolution),
+                               static_cast<cl_uint>(m_historyBuffersCount),
+                               static_cast<cl_uint>(currentHistoryBuffer),
+                               static_cast<float>(magnitudeIndexToDbfsCoeff));
+    m_profilingEvents.add("scatterDensityHits", std::move(scatterEvent));
+
+    auto resolveScatteredHitsKernel =
+      cl::KernelFunctor<cl::Buffer, cl::Buffer, cl::Buffer, cl::Buffer, cl_uint>(
+        m_program, "resolveScatteredHits");
+    auto resolveEvent = resolveScatteredHitsKernel(
+      cl::EnqueueArgs(m_queue, cl::NDRange(m_frequencyCount * resolution)),
+      m_workBuffer,
+      m_dirtyTilesBuffer,
+      m_hitCountsBuffer,
+      m_ageSumsBuffer,
+      static_cast<cl_uint>(m_historyBuffersCount));
+    m_profilingEvents.add("resolveScatteredHits", std::move(resolveEvent));
+}
+
+void RtsaUpdater::updateIncremental(cl::Buffer dbfsBuffer, size_t currentHistoryBuffer)
+{
+    const auto resolution = getLevelResolution();
+    const auto magnitudeIndexToDbfsCoeff = m_magnitudeDbfsRange / resolution;
+
+    auto updateHitCountsKernel = cl::KernelFunctor<cl::Buffer,
+                                                   cl::Buffer,
+                                                   cl::Buffer,
+                                                   cl::Buffer,
+                                                   cl_uint,
+                                                   cl_uint,
+                                                   cl_uint,
+                                                   cl_uint,
+                                                   cl_uint,
+                                                   float>(m_program, "updateHitCounts");
+    auto updateEvent =
+      updateHitCountsKernel(cl::EnqueueArgs(m_queue, cl::NDRange(m_frequencyCount)),
+                            m_hitCountsBuffer,
+                            m_timestampSumsBuffer,
+                            m_historyBuffer,
+                            dbfsBuffer,
+                            static_cast<cl_uint>(m_frequencyCount),
+                            static_cast<cl_uint>(resolution),
+                            static_cast<cl_uint>(currentHistoryBuffer),
+                            m_timestamp,
+                            static_cast<cl_uint>(m_historyBuffersCount),
+                            static_cast<float>(magnitudeIndexToDbfsCoeff));
+    m_profilingEvents.add("updateHitCounts", std::move(updateEvent));
+
+    auto resolveHitCountsKernel =
+      cl::KernelFunctor<cl::Buffer, cl::Buffer, cl::Buffer, cl::Buffer, cl_uint, cl_uint>(
+        m_program, "resolveHitCounts");
+    auto resolveEvent = resolveHitCountsKernel(
+      cl::EnqueueArgs(m_queue, cl::NDRange(m_frequencyCount * resolution)),
+      m_workBuffer,
+      m_dirtyTilesBuffer,
+      m_hitCountsBuffer,
+      m_timestampSumsBuffer,
+      m_timestamp,
+      static_cast<cl_uint>(m_historyBuffersCount));
+    m_profilingEvents.add("resolveHitCounts", std::move(resolveEvent));
+}
+
+void RtsaUpdater::updateExponentialDecay(cl::Buffer dbfsBuffer)
+{
+    const auto resolution = getLevelResolution();
+    const auto magnitudeIndexToDbfsCoeff = m_magnitudeDbfsRange / resolution;
+    const auto decayFactor = std::exp(-1.0f / m_persistenceFrameCount);
+
+    auto decayDensityHeatmapKernel =
+      cl::KernelFunctor<cl::Buffer, cl::Buffer, cl::Buffer, cl::Buffer, cl_uint, float, float>(
+        m_program, "decayDensityHeatmap");
+    auto event = decayDensityHeatmapKernel(
+      cl::EnqueueArgs(m_queue, cl::NDRange(m_frequencyCount, resolution)),
+      m_decayStateBuffer,
+      m_workBuffer,
+      m_dirtyTilesBuffer,
+      dbfsBuffer,
+      static_cast<cl_uint>(resolution),
+      decayFactor,
+      static_cast<float>(magnitudeIndexToDbfsCoeff));
+    m_profilingEvents.add("decayDensityHeatmap", std::move(event));
+}
+
+void RtsaUpdater::convertToDbfs(cl::Buffer magnitudesBuffer, float referenceValue)
+{
+    /*OpenclUtils::printVector<float>(
+      m_queue, magnitudesBuffer, m_frequencyCount, "Magnitudes values:\n");*/
+
+    auto calculateDbfsKernel =
+      cl::KernelFunctor<cl::Buffer, cl::Buffer, float>(m_program, "convertToDBFS");
+
+    const cl::NDRange globalGroupSize{ m_frequencyCount };
+    const cl::NDRange localGroupSize{ std::min(m_frequencyCount, static_cast<size_t>(64)) };
+    const cl::EnqueueArgs enqueueArgs(m_queue, globalGroupSize, localGroupSize);
+    m_profilingEvents.add(
+      "convertToDBFS",
+      calculateDbfsKernel(enqueueArgs, magnitudesBuffer, m_convertedDbfsBuffer, referenceValue));
+
+    // OpenclUtils::printVector<float>(m_queue, m_convertedDbfsBuffer, m_frequencyCount, "");
+}
+
+std::vector<RtsaDirtyRange> RtsaUpdater::takeDirtyRanges()
+{
+    m_queue.enqueueReadBuffer(m_dirtyTilesBuffer,
+                              true,
+                              0,
+                              m_dirtyTiles.size(),
+                              m_dirtyTiles.data(),
+                              nullptr,
+                              m_profilingEvents.add("read dirty tiles"));
+    m_queue.enqueueFillBuffer<cl_uchar>(m_dirtyTilesBuffer, 0, 0, m_dirtyTiles.size());
+
+    return getDirtyRanges(m_dirtyTiles, m_dirtyTileSize, m_bufferSize, MaxDirtyRangeCount);
 }
 }
@@ -0,0 +1,162 @@
+#include <spectr/calc_opencl/SpectralOccupancyUpdater.h>
+
+#include <spectr/calc_opencl/OpenclProgramCache.h>
+#include <spectr/utils/Assert.h>
+#include <spectr/utils/Asset.h>
+#include <spectr/utils/File.h>
+
+#include <sstream>
+
+namespace spectr::calc_opencl
+{
+namespace
+{
+const std::string ProgramAssetPath = "opencl/SpectralOccupancy.cl";
+}
+
+SpectralOccupancyUpdater::SpectralOccupancyUpdater(cl::Context context,
+                                                   size_t frequencyCount,
+                                                   float thresholdDbfs,
+                                                   size_t dutyCycleFrameCount,
+                                                   std::shared_ptr<OpenclProfiler> profiler)
+  : m_frequencyCount{ frequencyCount }
+  , m_dutyCycleFrameCount{ dutyCycleFrameCount }
+  , m_context{ context }
+  , m_profiler{ std::move(profiler) }
+  , m_profilingEvents{ m_profiler.get() }
+  , m_queue{ m_context, OpenclProfiler::getQueueProperties(m_profiler.get()) }
+  , m_thresholdDbfs{ thresholdDbfs }
+  , m_statistics(frequencyCount)
+  , m_occupiedFrameCounts(frequencyCount)
+  , m_dutyCycles(frequencyCount)
+  , m_framesSinceLastSeen(frequencyCount)
+{
+    ASSERT(m_dutyCycleFrameCount > 0);
+
+    const auto source = utils::File::read(utils::Asset::getPath(ProgramAssetPath));
+    std::stringstream ss;
+    ss << "-cl-std=CL2.0";
+    ss << " -DNEVER_SEEN=" << calc_cpu::SpectralOccupancyNeverSeen << "u";
+    m_program = OpenclProgramCache::build(m_context, source, ss.str());
+
+    const auto countsBufferSize = sizeof(cl_uint) * m_frequencyCount;
+    m_occupiedFrameCountsBuffer = cl::Buffer(m_context, CL_MEM_READ_WRITE, countsBufferSize);
+    m_dutyCyclesBuffer = cl::Buffer(m_context, CL_MEM_READ_WRITE, countsBufferSize);
+    m_framesSinceLastSeenBuffer = cl::Buffer(m_context, CL_MEM_READ_WRITE, countsBufferSize);
+    clearStatistics();
+    m_queue.finish();
+}
+
+void SpectralOccupancyUpdater::process(cl::Buffer dbfsBuffer)
+{
+    std::lock_guard<std::mutex> guard{ m_mutex };
+
+    if (m_isResetRequested.exchange(false))
+    {
+        clearStatistics();
+    }
+
+    using calc_cpu::SpectralOccupancyCalculator;
+    const auto weight =
+      SpectralOccupancyCalculator::getDutyCycleWeight(m_frameCount, m_dutyCycleFrameCount);
+
+    auto updateOccupancyKernel =
+      cl::KernelFunctor<cl::Buffer, cl::Buffer, cl::Buffer, cl::Buffer, float, float>(
+        m_program, "updateOccupancy");
+    m_profilingEvents.add(
+      "updateOccupancy",
+      updateOccupancyKernel(cl::EnqueueArgs(m_queue, cl::NDRange(m_frequencyCount)),
+                            m_occupiedFrameCountsBuffer,
+                            m_dutyCyclesBuffer,
+                            m_framesSinceLastSeenBuffer,
+                            dbfsBuffer,
+                            m_thresholdDbfs.load(),
+                            weight));
+
+    ++m_frameCount;
+    m_queue.finish();
+    m_profilingEvents.flush();
+
+    if (m_isReadRequested.exchange(false))
+    {
+        readStatistics();
+    }
+}
+
+std::vector<calc_cpu::SpectralOccupancyBin> SpectralOccupancyUpdater::getStatistics()
+{
+    std::lock_guard<std::mutex> guard{ m_mutex };
+
+    if (m_readFrameCount != m_frameCount)
+    {
+        readStatistics();
+    }
+    return getLastStatistics();
+}
+
+void SpectralOccupancyUpdater::requestStatistics()
+{
+    m_isReadRequested = true;
+}
+
+std::vector<calc_cpu::SpectralOccupancyBin> SpectralOccupancyUpdater::getLastStatistics() const
+{
+    std::lock_guard<std::mutex> guard{ m_statisticsMutex };
+    return m_statistics;
+}
+
+void SpectralOccupancyUpdater::readStatistics()
+{
+    const size_t frameCount = m_frameCount;
+    const auto countsBufferSize = sizeof(cl_uint) * m_frequencyCount;
+    m_queue.enqueueReadBuffer(
+      m_occupiedFrameCountsBuffer, false, 0, countsBufferSize, m_occupiedFrameCounts.data());
+    m_queue.enqueueReadBuffer(m_dutyCyclesBuffer, false, 0, countsBufferSize, m_dutyCycles.data());
+    m_queue.enqueueReadBuffer(
+      m_framesSinceLastSeenBuffer, true, 0, countsBufferSize, m_framesSinceLastSeen.data());
+
+    std::lock_guard<std::mutex> guard{ m_statisticsMutex };
+    for (size_t i = 0; i < m_frequencyCount; ++i)
+    {
+        auto& bin = m_statistics[i];
+        bin.occupancy = frameCount == 0 ? 0.0f
+                                        : static_cast<float>(m_occupiedFrameCounts[i]) /
+                                            static_cast<float>(frameCount);
+        bin.dutyCycle = m_dutyCycles[i];
+        bin.framesSinceLastSeen = m_framesSinceLastSeen[i];
+    }
+    m_readFrameCount = frameCount;
+}
+
+void SpectralOccupancyUpdater::setThreshold(float thresholdDbfs)
+{
+    m_thresholdDbfs = thresholdDbfs;
+    reset();
+}
+
+float SpectralOccupancyUpdater::getThreshold() const
+{
+    return m_thresholdDbfs;
+}
+
+void SpectralOccupancyUpdater::reset()
+{
+    m_isResetRequested = true;
+}
+
+size_t SpectralOccupancyUpdater::getFrameCount() const
+{
+    return m_frameCount;
+}
+
+void SpectralOccupancyUpdater::clearStatistics()
+{
+    const auto countsBufferSize = sizeof(cl_uint) * m_frequencyCount;
+    m_queue.enqueueFillBuffer<cl_uint>(m_occupiedFrameCountsBuffer, 0, 0, countsBufferSize);
+    m_queue.enqueueFillBuffer<cl_float>(m_dutyCyclesBuffer, 0.0f, 0, countsBufferSize);
+    m_queue.enqueueFillBuffer<cl_uint>(
+      m_framesSinceLastSeenBuffer, calc_cpu::SpectralOccupancyNeverSeen, 0, countsBufferSize);
+    m_frameCount = 0;
+    m_readFrameCount = SIZE_MAX; // the cached statistics are stale
+}
+}
@@ -0,0 +1,143 @@
+#include <spectr/calc_opencl/SpectrumTraceUpdater.h>
+
+#include <spectr/calc_opencl/OpenclProgramCache.h>
+#include <spectr/utils/Asset.h>
+#include <spectr/utils/Exception.h>
+#include <spectr/utils/File.h>
+
+#include <sstream>
+
+namespace spectr::calc_opencl
+{
+namespace
+{
+const std::string ProgramAssetPath = "opencl/SpectrumTraces.cl";
+
+cl_uint getTraceOffset(calc_cpu::SpectrumTraceType type, size_t frequencyCount)
+{
+    return static_cast<cl_uint>(static_cast<size_t>(type) * frequencyCount);
+}
+}
+
+SpectrumTraceUpdater::SpectrumTraceUpdater(cl::Context context,
+                                           size_t frequencyCount,
+                                           size_t averageFrameCount,
+                                           calc_cpu::SpectrumAverageMode averageMode,
+                                           std::shared_ptr<OpenclProfiler> profiler)
+  : m_frequencyCount{ frequencyCount }
+  , m_averageFrameCount{ averageFrameCount }
+  , m_averageMode{ averageMode }
+  , m_context{ context }
+  , m_profiler{ std::move(profiler) }
+  , m_profilingEvents{ m_profiler.get() }
+  , m_queue{ m_context, OpenclProfiler::getQueueProperties(m_profiler.get()) }
+{
+    ASSERT(m_averageFrameCount > 0);
+
+    const auto source = utils::File::read(utils::Asset::getPath(ProgramAssetPath));
+    std::stringstream ss;
+    ss << "-cl-std=CL2.0";
+    ss << " -DMIN_DBFS=" << std::fixed << calc_cpu::SpectrumTraceCalculator::MinDbfs << "f";
+    m_program = OpenclProgramCache::build(m_context, source, ss.str());
+
+    m_tracesBuffer = cl::Buffer(m_context, CL_MEM_READ_WRITE, getTracesBufferSize());
+    m_averageStateBuffer =
+      cl::Buffer(m_context, CL_MEM_READ_WRITE, sizeof(cl_float) * m_frequencyCount);
+    m_queue.enqueueFillBuffer<cl_float>(
+      m_tracesBuffer, calc_cpu::SpectrumTraceCalculator::MinDbfs, 0, getTracesBufferSize());
+    m_queue.enqueueFillBuffer<cl_float>(
+      m_averageStateBuffer, 0.0f, 0, sizeof(cl_float) * m_frequencyCount);
+    m_queue.finish();
+}
+
+void SpectrumTraceUpdater::process(cl::Buffer dbfsBuffer)
+{
+    using calc_cpu::SpectrumTraceType;
+
+    const cl::EnqueueArgs enqueueArgs{ m_queue, cl::NDRange(m_frequencyCount) };
+    if (m_isResetRequested.exchange(false))
+    {
+        m_frameCount = 0;
+    }
+    const cl_uint isFirstFrame = m_frameCount == 0 ? 1 : 0;
+
+    auto liveKernel =
+      cl::KernelFunctor<cl::Buffer, cl::Buffer, cl_uint>(m_program, "updateLiveTrace");
+    m_profilingEvents.add(
+      "updateLiveTrace",
+      liveKernel(enqueueArgs,
+                 m_tracesBuffer,
+                 dbfsBuffer,
+                 getTraceOffset(SpectrumTraceType::Live, m_frequencyCount)));
+
+    auto maxHoldKernel =
+      cl::KernelFunctor<cl::Buffer, cl::Buffer, cl_uint, cl_uint>(m_program, "updateMaxHoldTrace");
+    m_profilingEvents.add(
+      "updateMaxHoldTrace",
+      maxHoldKernel(enqueueArgs,
+                    m_tracesBuffer,
+                    dbfsBuffer,
+                    getTraceOffset(SpectrumTraceType::MaxHold, m_frequencyCount),
+                    isFirstFrame));
+
+    auto minHoldKernel =
+      cl::KernelFunctor<cl::Buffer, cl::Buffer, cl_uint, cl_uint>(m_program, "updateMinHoldTrace");
+    m_profilingEvents.add(
+      "updateMinHoldTrace",
+      minHoldKernel(enqueueArgs,
+                    m_tracesBuffer,
+                    dbfsBuffer,
+                    getTraceOffset(SpectrumTraceType::MinHold, m_frequencyCount),
+                    isFirstFrame));
+
+    const auto weight =
+      calc_cpu::SpectrumTraceCalculator::getAverageWeight(m_frameCount, m_averageFrameCount);
+    const auto dbfsScale = m_averageMode == calc_cpu::SpectrumAverageMode::Rms ? 10.0f : 20.0f;
+    auto averageKernel =
+      cl::KernelFunctor<cl::Buffer, cl::Buffer, cl::Buffer, cl_uint, float, float>(
+        m_program, "updateAverageTrace");
+    m_profilingEvents.add(
+      "updateAverageTrace",
+      averageKernel(enqueueArgs,
+                    m_tracesBuffer,
+                    m_averageStateBuffer,
+                    dbfsBuffer,
+                    getTraceOffset(SpectrumTraceType::Average, m_frequencyCount),
+                    weight,
+                    dbfsScale));
+
+    ++m_frameCount;
+    m_queue.finish();
+    m_profilingEvents.flush();
+}
+
+void SpectrumTraceUpdater::update(cl::Buffer dbfsBuffer, RtsaHeatmapSink& sink)
+{
+    if (sink.getSize() != getTracesBufferSize())
+    {
+        throw utils::Exception("Spectrum trace sink size {} doesn't match the traces size {}",
+                               sink.getSize(),
+                               getTracesBufferSize());
+    }
+
+    process(dbfsBuffer);
+
+    sink.write(m_queue, m_tracesBuffer, { { 0, getTracesBufferSize() } }, m_profilingEvents);
+    m_profilingEvents.flush();
+}
+
+void SpectrumTraceUpdater::reset()
+{
+    m_isResetRequested = true;
+}
+
+cl::Buffer SpectrumTraceUpdater::getTracesBuffer() const
+{
+    return m_tracesBuffer;
+}
+
+size_t SpectrumTraceUpdater::getTracesBufferSize() const
+{
+    return sizeof(cl_float) * m_frequencyCount * calc_cpu::SpectrumTraceCount;
+}
+}
@@ -0,0 +1,82 @@
+#include <spectr/calc_opencl/DeferredRtsaHeatmapSink.h>
+
+#include <spectr/calc_opencl/OpenclManager.h>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <numeric>
+#include <vector>
+
+namespace spectr::calc_opencl::test
+{
+TEST(RtsaDirtyRangeTest, MergesOverlappingAndAdjacentRanges)
+{
+    const std::vector<RtsaDirtyRange> left{ { 0, 4 }, { 16, 4 }, { 40, 8 } };
+    const std::vector<RtsaDirtyRange> right{ { 4, 4 }, { 18, 8 }, { 60, 4 } };
+
+    const auto merged = mergeRtsaDirtyRanges(left, right);
+    ASSERT_EQ(merged.size(), 4);
+    EXPECT_EQ(merged[0].offset, 0);
+    EXPECT_EQ(merged[0].size, 8);
+    EXPECT_EQ(merged[1].offset, 16);
+    EXPECT_EQ(merged[1].size, 10);
+    EXPECT_EQ(merged[2].offset, 40);
+    EXPECT_EQ(merged[2].size, 8);
+    EXPECT_EQ(merged[3].offset, 60);
+    EXPECT_EQ(merged[3].size, 4);
+}
+
+TEST(DeferredRtsaHeatmapSinkTest, FlushesMergedWrites)
+{
+    constexpr size_t Size = 64;
+
+    OpenclManager openclManager;
+    auto context = openclManager.getContext();
+    cl::CommandQueue queue{ context };
+    OpenclProfilingEvents profilingEvents{ nullptr };
+
+    auto target = std::make_shared<HostRtsaHeatmapSink>(Size);
+    DeferredRtsaHeatmapSink sink{ context, target };
+    EXPECT_FALSE(sink.flush().has_value());
+
+    std::vector<uint8_t> first(Size);
+    std::iota(first.begin(), first.end(), 0);
+    cl::Buffer firstBuffer{ context, first.begin(), first.end(), true };
+    sink.setTag(1);
+    sink.write(queue, firstBuffer, { { 0, 8 } }, profilingEvents);
+
+    std::vector<uint8_t> second(Size, 200);
+    cl::Buffer secondBuffer{ context, second.begin(), second.end(), true };
+    sink.setTag(2);
+    sink.write(queue, secondBuffer, { { 4, 8 }, { 32, 4 } }, profilingEvents);
+    EXPECT_EQ(target->getWriteCount(), 0);
+
+    const auto tag = sink.flush();
+    ASSERT_TRUE(tag.has_value());
+    EXPECT_EQ(*tag, 2);
+    EXPECT_EQ(target->getWriteCount(), 1);
+    EXPECT_FALSE(sink.flush().has_value());
+
+    const auto& data = target->getData();
+    for (size_t i = 0; i < 4; ++i)
+    {
+        EXPECT_EQ(data[i], first[i]) << i;
+    }
+    for (size_t i = 4; i < 12; ++i)
+    {
+        EXPECT_EQ(data[i], second[i]) << i;
+    }
+    for (size_t i = 32; i < 36; ++i)
+    {
+        EXPECT_EQ(data[i], second[i]) << i;
+    }
+
+    const auto& ranges = target->getLastDirtyRanges();
+    ASSERT_EQ(ranges.size(), 2);
+    EXPECT_EQ(ranges[0].offset, 0);
+    EXPECT_EQ(ranges[0].size, 12);
+    EXPECT_EQ(ranges[1].offset, 32);
+    EXPECT_EQ(ranges[1].size, 4);
+}
+}
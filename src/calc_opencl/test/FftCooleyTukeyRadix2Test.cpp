@@ -6,6 +6,8 @@
 #include <gtest/gtest.h>
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
+#include <cmath>
 #include <vector>
 
 namespace spectr::calc_opencl::test
@@ -33,11 +35,8 @@ public:
 
         // OpenclUtils::printContextInfo(context, std::cout);
 
-        float* duplicatedArray = new float[inputRealValues.size()];
-        std::copy(inputRealValues.begin(), inputRealValues.end(), duplicatedArray);
-
         FftCooleyTukeyRadix2 fftOpenCl(context, inputRealValues.size());
-        fftOpenCl.execute(duplicatedArray);
+        fftOpenCl.execute(inputRealValues);
         const auto v = fftOpenCl.getFffBufferCpu();
         return v;
     }
@@ -72,4 +71,45 @@ TEST_F(FftCooleyTukeyRadix2Test, EightNaturalNumbers)
     ExpectNear(v[1], Complex{ -4, -4 });
     ExpectNear(v[1], Complex{ -4, -9.656854f });
 }
+
+TEST(FftCooleyTukeyRadix2SpectrumTest, CalculateSpectrumMatchesMagnitudes)
+{
+    constexpr size_t FftSize = 256;
+    constexpr float ReferenceValue = 128.0f;
+
+    OpenclManager openclManager;
+    auto context = openclManager.getContext();
+    cl::CommandQueue queue{ context };
+
+    std::vector<float> signal(FftSize);
+    for (size_t i = 0; i < FftSize; ++i)
+    {
+        signal[i] = std::sin(0.3f * i) + 0.25f * std::cos(1.7f * i);
+    }
+    signal[3] = 0.0f; // so not all values are periodic
+
+    FftCooleyTukeyRadix2 fftOpenCl(context, FftSize);
+    fftOpenCl.execute(signal);
+
+    fftOpenCl.calculateSpectrum(ReferenceValue, true);
+
+    std::vector<float> magnitudes(FftSize / 2);
+    std::vector<float> dbfsValues(FftSize / 2);
+    fftOpenCl.readMagnitudes(magnitudes.data());
+    cl::copy(queue, fftOpenCl.getDbfsBuffer(), dbfsValues.begin(), dbfsValues.end());
+
+    const auto fft = fftOpenCl.getFffBufferCpu();
+    for (size_t i = 0; i < FftSize / 2; ++i)
+    {
+        const auto expectedMagnitude = 2.0f * std::abs(fft[i]);
+        EXPECT_NEAR(magnitudes[i], expectedMagnitude, 1e-4f * (1.0f + expectedMagnitude));
+
+        // the rounding noise of the near-zero values is too large in the log scale
+        if (expectedMagnitude > 1e-2f)
+        {
+            const auto expectedDbfs = 20.0f * std::log10(expectedMagnitude / ReferenceValue);
+            EXPECT_NEAR(dbfsValues[i], expectedDbfs, 1e-3f);
+        }
+    }
+}
 }
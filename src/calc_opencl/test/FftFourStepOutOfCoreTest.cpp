@@ -0,0 +1,103 @@
+#include <spectr/calc_opencl/FftFourStepOutOfCore.h>
+
+#include <spectr/calc_cpu/FftCooleyTukeyRadix2.h>
+#include <spectr/calc_opencl/OpenclManager.h>
+#include <spectr/utils/Exception.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+namespace spectr::calc_opencl::test
+{
+namespace
+{
+constexpr float RelativeEps = 1e-4f;
+
+std::vector<float> createSignal(size_t size)
+{
+    std::vector<float> values(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        const auto x = static_cast<float>(i);
+        values[i] = std::sin(x * 0.01f) + 0.25f * std::cos(x * 0.7f) + ((i % 7) == 0 ? 0.5f : 0.0f);
+    }
+    return values;
+}
+
+/**
+ * @brief Budget for two slots of two buffers with the given count of complex values and the
+ * omega table.
+ */
+size_t getBudget(size_t blockElementCount, size_t rowCount)
+{
+    return 4 * blockElementCount * sizeof(Complex) + rowCount / 2 * sizeof(Complex);
+}
+
+void expectMatchesCpu(FftFourStepOutOfCore& fft)
+{
+    const auto signal = createSignal(fft.getFftSize());
+    const auto actual = fft.execute(signal);
+    const auto expected = calc_cpu::FftCooleyTukeyRadix2::getFFT(signal);
+
+    ASSERT_EQ(actual.size(), expected.size());
+    const auto tolerance = RelativeEps * static_cast<float>(fft.getFftSize());
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        EXPECT_NEAR(actual[i].real(), expected[i].real(), tolerance) << "index " << i;
+        EXPECT_NEAR(actual[i].imag(), expected[i].imag(), tolerance) << "index " << i;
+    }
+}
+}
+
+TEST(FftFourStepOutOfCoreTest, SmallBudgetSplitsIntoBlocks)
+{
+    OpenclManager openclManager;
+
+    // 2^12 = 64 rows x 64 columns, blocks of 4 columns and 4 rows
+    const size_t fftSize = 1 << 12;
+    FftFourStepOutOfCore fft{ openclManager.getContext(), fftSize, getBudget(256, 64) };
+    EXPECT_EQ(fft.getRowCount(), 64);
+    EXPECT_EQ(fft.getColumnCount(), 64);
+    EXPECT_EQ(fft.getColumnsPerBlock(), 4);
+    EXPECT_EQ(fft.getRowsPerBlock(), 4);
+    EXPECT_LE(fft.getDeviceMemoryUsage(), getBudget(256, 64));
+
+    expectMatchesCpu(fft);
+}
+
+TEST(FftFourStepOutOfCoreTest, OddPowerOfTwo)
+{
+    OpenclManager openclManager;
+
+    // 2^13 = 128 rows x 64 columns, blocks of 1 column and 2 rows
+    const size_t fftSize = 1 << 13;
+    FftFourStepOutOfCore fft{ openclManager.getContext(), fftSize, getBudget(128, 128) };
+    EXPECT_EQ(fft.getRowCount(), 128);
+    EXPECT_EQ(fft.getColumnCount(), 64);
+    EXPECT_EQ(fft.getColumnsPerBlock(), 1);
+    EXPECT_EQ(fft.getRowsPerBlock(), 2);
+
+    expectMatchesCpu(fft);
+}
+
+TEST(FftFourStepOutOfCoreTest, WholeTransformInOneBlock)
+{
+    OpenclManager openclManager;
+
+    FftFourStepOutOfCore fft{ openclManager.getContext(), 1 << 10 };
+    EXPECT_EQ(fft.getColumnsPerBlock(), fft.getColumnCount());
+    EXPECT_EQ(fft.getRowsPerBlock(), fft.getRowCount());
+
+    expectMatchesCpu(fft);
+}
+
+TEST(FftFourStepOutOfCoreTest, TooSmallBudgetThrows)
+{
+    OpenclManager openclManager;
+
+    EXPECT_THROW(FftFourStepOutOfCore(openclManager.getContext(), 1 << 12, getBudget(32, 64)),
+                 utils::Exception);
+}
+}
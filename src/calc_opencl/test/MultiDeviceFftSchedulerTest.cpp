@@ -0,0 +1,101 @@
+#include <spectr/calc_opencl/MultiDeviceFftScheduler.h>
+
+#include <spectr/calc_cpu/FftCooleyTukeyRadix2.h>
+#include <spectr/calc_opencl/OpenclDeviceSelector.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+// The tests use all available devices. To check splitting between devices on a machine without
+// GPUs, run them with PoCL exposing two CPU devices: POCL_DEVICES="pthread pthread".
+
+namespace spectr::calc_opencl::test
+{
+namespace
+{
+constexpr size_t FftSize = 256;
+constexpr size_t FrameCount = 37;
+constexpr float RelativeEps = 1e-3f;
+
+std::vector<float> createFrame(size_t frameIndex)
+{
+    std::vector<float> values(FftSize);
+    for (size_t i = 0; i < FftSize; ++i)
+    {
+        const auto x = static_cast<float>(i);
+        values[i] = std::sin(x * 0.05f * (frameIndex + 1)) + 0.5f * std::cos(x * 0.3f);
+    }
+    return values;
+}
+
+std::vector<OpenclDeviceCandidate> getDevices()
+{
+    OpenclDeviceSelectionSettings settings;
+    settings.calibrationFftSize = FftSize;
+    settings.calibrationIterationCount = 2;
+    return OpenclDeviceSelector::rank(settings);
+}
+}
+
+TEST(MultiDeviceFftSchedulerTest, ResultsAreInColumnOrderAndMatchCpu)
+{
+    const auto devices = getDevices();
+    ASSERT_FALSE(devices.empty());
+
+    MultiDeviceFftScheduler scheduler{ devices, FftSize };
+    EXPECT_EQ(scheduler.getDeviceCount(), devices.size());
+
+    std::vector<std::vector<float>> signals;
+    std::vector<FftFrame> frames;
+    for (size_t i = 0; i < FrameCount; ++i)
+    {
+        signals.push_back(createFrame(i));
+    }
+    for (size_t i = 0; i < FrameCount; ++i)
+    {
+        // column indices don't start from zero to check they are passed through
+        frames.push_back({ 100 + i, signals[i].data() });
+    }
+
+    // process twice, the second batch uses the refined throughput values
+    for (size_t batchIndex = 0; batchIndex < 2; ++batchIndex)
+    {
+        const auto results = scheduler.process(frames);
+        ASSERT_EQ(results.size(), FrameCount);
+
+        for (size_t i = 0; i < FrameCount; ++i)
+        {
+            const auto& result = results[i];
+            EXPECT_EQ(result.columnIndex, 100 + i);
+            ASSERT_EQ(result.magnitudes.size(), FftSize / 2);
+
+            const auto expected = calc_cpu::FftCooleyTukeyRadix2::getMagnitudes(signals[i]);
+            float expectedMax = 0;
+            for (size_t k = 0; k < FftSize / 2; ++k)
+            {
+                EXPECT_NEAR(result.magnitudes[k], expected[k], RelativeEps * (1 + expected[k]));
+                expectedMax = std::max(expectedMax, expected[k]);
+            }
+            EXPECT_NEAR(result.maxMagnitude, expectedMax, RelativeEps * expectedMax);
+        }
+    }
+}
+
+TEST(MultiDeviceFftSchedulerTest, DistributionCoversWholeBatch)
+{
+    const auto devices = getDevices();
+    ASSERT_FALSE(devices.empty());
+
+    MultiDeviceFftScheduler scheduler{ devices, FftSize };
+    for (size_t frameCount : { 0, 1, 2, 3, 10, 97 })
+    {
+        const auto distribution = scheduler.getFrameDistribution(frameCount);
+        ASSERT_EQ(distribution.size(), devices.size());
+        EXPECT_EQ(std::accumulate(distribution.begin(), distribution.end(), size_t{ 0 }),
+                  frameCount);
+    }
+}
+}
@@ -0,0 +1,45 @@
+#include <spectr/calc_opencl/OpenclProfiler.h>
+
+#include <gtest/gtest.h>
+
+namespace spectr::calc_opencl::test
+{
+TEST(OpenclProfilerTest, StatisticsUseRollingWindow)
+{
+    OpenclProfiler profiler{ 3 };
+    for (const auto milliseconds : { 10.0, 1.0, 2.0, 3.0 })
+    {
+        profiler.addSample("fft", milliseconds);
+    }
+    profiler.addSample("read", 6.0);
+
+    const auto statistics = profiler.getStatistics();
+    ASSERT_EQ(statistics.size(), 2);
+
+    const auto& fft = statistics[0];
+    EXPECT_EQ(fft.name, "fft");
+    EXPECT_EQ(fft.sampleCount, 3);
+    EXPECT_DOUBLE_EQ(fft.lastMs, 3.0);
+    EXPECT_DOUBLE_EQ(fft.averageMs, 2.0);
+    EXPECT_DOUBLE_EQ(fft.minMs, 1.0);
+    EXPECT_DOUBLE_EQ(fft.maxMs, 3.0);
+    EXPECT_DOUBLE_EQ(fft.fractionOfTotal, 0.25);
+
+    const auto& read = statistics[1];
+    EXPECT_EQ(read.name, "read");
+    EXPECT_DOUBLE_EQ(read.fractionOfTotal, 0.75);
+
+    profiler.reset();
+    EXPECT_TRUE(profiler.getStatistics().empty());
+}
+
+TEST(OpenclProfilerTest, EventsWithoutProfilerAreIgnored)
+{
+    OpenclProfilingEvents events{ nullptr };
+    EXPECT_FALSE(events.isEnabled());
+    EXPECT_EQ(events.add("stage"), nullptr);
+    events.flush();
+
+    EXPECT_EQ(OpenclProfiler::getQueueProperties(nullptr), cl::QueueProperties::None);
+}
+}
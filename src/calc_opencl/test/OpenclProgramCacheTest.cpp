@@ -0,0 +1,106 @@
+#include <spectr/calc_opencl/OpenclProgramCache.h>
+
+#include <spectr/calc_opencl/OpenclManager.h>
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace spectr::calc_opencl::test
+{
+namespace
+{
+const std::string ProgramSource = R"(
+__kernel void add_value(__global float* values, float value)
+{
+    values[get_global_id(0)] += value;
+}
+)";
+
+class OpenclProgramCacheTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_previousCacheDirectory = OpenclProgramCache::getCacheDirectory();
+        m_cacheDirectory = std::filesystem::temp_directory_path() / "spectr_program_cache_test";
+        std::filesystem::remove_all(m_cacheDirectory);
+        OpenclProgramCache::setCacheDirectory(m_cacheDirectory);
+    }
+
+    void TearDown() override
+    {
+        OpenclProgramCache::setCacheDirectory(m_previousCacheDirectory);
+        std::filesystem::remove_all(m_cacheDirectory);
+    }
+
+    size_t getCacheEntryCount() const
+    {
+        if (!std::filesystem::exists(m_cacheDirectory))
+        {
+            return 0;
+        }
+        const std::filesystem::directory_iterator iterator{ m_cacheDirectory };
+        return std::distance(std::filesystem::begin(iterator), std::filesystem::end(iterator));
+    }
+
+    std::vector<float> runProgram(cl::Context context, cl::Program program)
+    {
+        std::vector<float> values{ 1, 2, 3, 4 };
+        cl::CommandQueue queue{ context };
+        cl::Buffer buffer{ context, values.begin(), values.end(), false };
+        auto kernel = cl::KernelFunctor<cl::Buffer, float>(program, "add_value");
+        kernel(cl::EnqueueArgs(queue, cl::NDRange(values.size())), buffer, 10.0f);
+        cl::copy(queue, buffer, values.begin(), values.end());
+        return values;
+    }
+
+    std::filesystem::path m_previousCacheDirectory;
+    std::filesystem::path m_cacheDirectory;
+};
+}
+
+TEST_F(OpenclProgramCacheTest, SecondBuildUsesCachedBinary)
+{
+    OpenclManager openclManager;
+    const auto context = openclManager.getContext();
+
+    const auto program1 = OpenclProgramCache::build(context, ProgramSource, "-cl-std=CL2.0");
+    EXPECT_EQ(getCacheEntryCount(), 1);
+
+    const auto program2 = OpenclProgramCache::build(context, ProgramSource, "-cl-std=CL2.0");
+    EXPECT_EQ(getCacheEntryCount(), 1);
+
+    const std::vector<float> expected{ 11, 12, 13, 14 };
+    EXPECT_EQ(runProgram(context, program1), expected);
+    EXPECT_EQ(runProgram(context, program2), expected);
+}
+
+TEST_F(OpenclProgramCacheTest, DifferentBuildOptionsUseDifferentEntries)
+{
+    OpenclManager openclManager;
+    const auto context = openclManager.getContext();
+
+    OpenclProgramCache::build(context, ProgramSource, "-cl-std=CL2.0");
+    OpenclProgramCache::build(context, ProgramSource, "-cl-std=CL2.0 -cl-fast-relaxed-math");
+    EXPECT_EQ(getCacheEntryCount(), 2);
+}
+
+TEST_F(OpenclProgramCacheTest, CorruptedEntryFallsBackToSource)
+{
+    OpenclManager openclManager;
+    const auto context = openclManager.getContext();
+
+    OpenclProgramCache::build(context, ProgramSource, "-cl-std=CL2.0");
+    for (const auto& entry : std::filesystem::directory_iterator{ m_cacheDirectory })
+    {
+        std::filesystem::resize_file(entry.path(), std::filesystem::file_size(entry.path()) / 2);
+    }
+
+    const auto program = OpenclProgramCache::build(context, ProgramSource, "-cl-std=CL2.0");
+    const std::vector<float> expected{ 11, 12, 13, 14 };
+    EXPECT_EQ(runProgram(context, program), expected);
+}
+}
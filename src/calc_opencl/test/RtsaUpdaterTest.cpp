@@ -0,0 +1,393 @@
+#include <spectr/calc_opencl/RtsaUpdater.h>
+
+#include <spectr/calc_opencl/OpenclManager.h>
+#include <spectr/utils/Exception.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace spectr::calc_opencl::test
+{
+namespace
+{
+constexpr size_t FrequencyCount = 64;
+constexpr size_t MagnitudeResolution = 128;
+constexpr size_t HistoryBufferCount = 8;
+constexpr float MagnitudeDbfsRange = 96.0f;
+constexpr float ReferenceValue = 32768.0f;
+constexpr size_t HeatmapValueCount = FrequencyCount * MagnitudeResolution * 2;
+
+std::unique_ptr<RtsaUpdater> createUpdater(
+  cl::Context context,
+  RtsaUpdateMode mode,
+  utils::RtsaStorageFormat storageFormat = utils::RtsaStorageFormat::Float2,
+  size_t magnitudeResolution = MagnitudeResolution)
+{
+    const auto cellSize = storageFormat == utils::RtsaStorageFormat::Unorm16x2
+                            ? sizeof(uint32_t)
+                            : sizeof(float) * 2;
+    return std::make_unique<RtsaUpdater>(context,
+                                         FrequencyCount,
+                                         magnitudeResolution,
+                                         HistoryBufferCount,
+                                         MagnitudeDbfsRange,
+                                         FrequencyCount * magnitudeResolution * cellSize,
+                                         mode,
+                                         storageFormat);
+}
+
+std::vector<float> readHeatmap(cl::CommandQueue& queue,
+                               const RtsaUpdater& updater,
+                               size_t valueCount = HeatmapValueCount)
+{
+    std::vector<float> values(valueCount);
+    queue.enqueueReadBuffer(
+      updater.getHeatmapBuffer(), true, 0, values.size() * sizeof(float), values.data());
+    return values;
+}
+
+std::vector<float> readPackedHeatmap(cl::CommandQueue& queue, const RtsaUpdater& updater)
+{
+    std::vector<uint32_t> packedValues(FrequencyCount * MagnitudeResolution);
+    queue.enqueueReadBuffer(updater.getHeatmapBuffer(),
+                            true,
+                            0,
+                            packedValues.size() * sizeof(uint32_t),
+                            packedValues.data());
+
+    // same layout as GLSL unpackUnorm2x16: the first value in the low 16 bits
+    std::vector<float> values;
+    values.reserve(HeatmapValueCount);
+    for (const auto packedValue : packedValues)
+    {
+        values.push_back(static_cast<float>(packedValue & 0xFFFF) / 65535.0f);
+        values.push_back(static_cast<float>(packedValue >> 16) / 65535.0f);
+    }
+    return values;
+}
+}
+
+class RtsaUpdaterModeTest : public ::testing::TestWithParam<RtsaUpdateMode>
+{
+};
+
+TEST_P(RtsaUpdaterModeTest, MatchesGatherMode)
+{
+    OpenclManager openclManager;
+    auto context = openclManager.getContext();
+    cl::CommandQueue queue{ context };
+
+    auto gatherUpdater = createUpdater(context, RtsaUpdateMode::Gather);
+    auto testedUpdater = createUpdater(context, GetParam());
+
+    std::mt19937 generator{ 42 };
+    std::uniform_real_distribution<float> attenuationDistribution{ 0.0f, MagnitudeDbfsRange };
+
+    // the ring is filled and then every frame evicts an older one
+    for (size_t frameIndex = 0; frameIndex < 3 * HistoryBufferCount; ++frameIndex)
+    {
+        std::vector<float> magnitudes(FrequencyCount);
+        for (auto& magnitude : magnitudes)
+        {
+            // some frequencies keep the same value, so cells are hit by several frames
+            const auto attenuation =
+              (frameIndex % 3 == 0) ? 30.0f : attenuationDistribution(generator);
+            magnitude = ReferenceValue * std::pow(10.0f, -attenuation / 20.0f);
+        }
+
+        // the magnitudes are only read, so both updaters share the buffer
+        cl::Buffer magnitudesBuffer{ context, magnitudes.begin(), magnitudes.end(), false };
+        gatherUpdater->process(magnitudesBuffer, ReferenceValue);
+        testedUpdater->process(magnitudesBuffer, ReferenceValue);
+
+        const auto expected = readHeatmap(queue, *gatherUpdater);
+        const auto actual = readHeatmap(queue, *testedUpdater);
+        for (size_t i = 0; i < HeatmapValueCount; ++i)
+        {
+            ASSERT_FLOAT_EQ(actual[i], expected[i]) << "frame " << frameIndex << ", value " << i;
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(HistoryModes,
+                         RtsaUpdaterModeTest,
+                         ::testing::Values(RtsaUpdateMode::Scatter, RtsaUpdateMode::Incremental));
+
+TEST(RtsaUpdaterTest, ExponentialDecayConvergesToConstantFrame)
+{
+    OpenclManager openclManager;
+    auto context = openclManager.getContext();
+    cl::CommandQueue queue{ context };
+
+    auto updater = createUpdater(context, RtsaUpdateMode::ExponentialDecay);
+    const auto persistence = 4.0f;
+    updater->setPersistence(persistence);
+
+    // -30 dBFS at every frequency hits the cells around 30 / 96 * 128 = 40
+    const auto attenuation = 30.0f;
+    const auto hitCellIndex = static_cast<size_t>(attenuation / MagnitudeDbfsRange *
+                                                  MagnitudeResolution);
+    const auto missedCellIndex = MagnitudeResolution - 1;
+    const std::vector<float> magnitudes(
+      FrequencyCount, ReferenceValue * std::pow(10.0f, -attenuation / 20.0f));
+
+    const auto decayFactor = std::exp(-1.0f / persistence);
+    float expectedIntensity = 0.0f;
+    float expectedAge = 0.0f;
+    for (size_t frameIndex = 0; frameIndex < 20; ++frameIndex)
+    {
+        cl::Buffer magnitudesBuffer{ context, magnitudes.begin(), magnitudes.end(), false };
+        updater->process(magnitudesBuffer, ReferenceValue);
+
+        expectedAge = decayFactor * (expectedAge + 0.5f * (1.0f - decayFactor) * expectedIntensity);
+        expectedIntensity = decayFactor * expectedIntensity + (1.0f - decayFactor);
+    }
+
+    const auto heatmap = readHeatmap(queue, *updater);
+    for (size_t frequencyIndex = 0; frequencyIndex < FrequencyCount; ++frequencyIndex)
+    {
+        const auto hitCell = 2 * (frequencyIndex * MagnitudeResolution + hitCellIndex);
+        EXPECT_NEAR(heatmap[hitCell], expectedIntensity, 1e-5f);
+        EXPECT_NEAR(heatmap[hitCell + 1], expectedAge, 1e-5f);
+
+        const auto missedCell = 2 * (frequencyIndex * MagnitudeResolution + missedCellIndex);
+        EXPECT_EQ(heatmap[missedCell], 0.0f);
+        EXPECT_EQ(heatmap[missedCell + 1], 0.0f);
+    }
+}
+
+TEST(RtsaUpdaterTest, UpdateWritesHeatmapToSink)
+{
+    OpenclManager openclManager;
+    auto context = openclManager.getContext();
+    cl::CommandQueue queue{ context };
+
+    auto updater = createUpdater(context, RtsaUpdateMode::Incremental);
+    HostRtsaHeatmapSink sink{ HeatmapValueCount * sizeof(float) };
+
+    const std::vector<float> magnitudes(FrequencyCount, ReferenceValue / 100.0f);
+    for (size_t frameIndex = 0; frameIndex < 3; ++frameIndex)
+    {
+        updater->update(magnitudes.data(), sink, ReferenceValue);
+    }
+
+    EXPECT_EQ(sink.getWriteCount(), 3);
+
+    const auto expected = readHeatmap(queue, *updater);
+    std::vector<float> actual(HeatmapValueCount);
+    std::memcpy(actual.data(), sink.getData().data(), sink.getSize());
+    EXPECT_EQ(actual, expected);
+}
+
+TEST(RtsaUpdaterTest, UpdateTransfersOnlyChangedTiles)
+{
+    OpenclManager openclManager;
+    auto context = openclManager.getContext();
+    cl::CommandQueue queue{ context };
+
+    auto updater = createUpdater(context, RtsaUpdateMode::Gather);
+    HostRtsaHeatmapSink sink{ HeatmapValueCount * sizeof(float) };
+
+    // the first update transfers the whole heatmap
+    const std::vector<float> magnitudes(FrequencyCount, ReferenceValue / 100.0f);
+    updater->update(magnitudes.data(), sink, ReferenceValue);
+    ASSERT_EQ(sink.getLastDirtyRanges().size(), 1);
+    EXPECT_EQ(sink.getLastDirtyRanges()[0].offset, 0);
+    EXPECT_EQ(sink.getLastDirtyRanges()[0].size, sink.getSize());
+
+    // once the history is filled with the same frame, the heatmap doesn't change
+    for (size_t frameIndex = 1; frameIndex < HistoryBufferCount; ++frameIndex)
+    {
+        updater->update(magnitudes.data(), sink, ReferenceValue);
+    }
+    updater->update(magnitudes.data(), sink, ReferenceValue);
+    EXPECT_TRUE(sink.getLastDirtyRanges().empty());
+
+    // a single changed frequency dirties a part of the heatmap
+    auto changedMagnitudes = magnitudes;
+    changedMagnitudes[FrequencyCount / 2] = ReferenceValue / 1000.0f;
+    updater->update(changedMagnitudes.data(), sink, ReferenceValue);
+
+    size_t dirtySize = 0;
+    for (const auto& range : sink.getLastDirtyRanges())
+    {
+        dirtySize += range.size;
+    }
+    EXPECT_GT(dirtySize, 0);
+    EXPECT_LT(dirtySize, sink.getSize());
+
+    std::vector<float> actual(HeatmapValueCount);
+    std::memcpy(actual.data(), sink.getData().data(), sink.getSize());
+    EXPECT_EQ(actual, readHeatmap(queue, *updater));
+}
+
+TEST(RtsaUpdaterTest, WriteRejectsSinkOfOtherSize)
+{
+    OpenclManager openclManager;
+    auto context = openclManager.getContext();
+
+    auto updater = createUpdater(context, RtsaUpdateMode::Gather);
+    const std::vector<float> magnitudes(FrequencyCount, ReferenceValue / 100.0f);
+    updater->process(magnitudes.data(), ReferenceValue);
+
+    HostRtsaHeatmapSink smallerSink{ HeatmapValueCount * sizeof(float) / 2 };
+    EXPECT_THROW(updater->write(smallerSink), utils::Exception);
+    HostRtsaHeatmapSink largerSink{ HeatmapValueCount * sizeof(float) * 2 };
+    EXPECT_THROW(updater->write(largerSink), utils::Exception);
+}
+
+TEST(RtsaUpdaterTest, ProcessDbfsMatchesProcess)
+{
+    OpenclManager openclManager;
+    auto context = openclManager.getContext();
+    cl::CommandQueue queue{ context };
+
+    auto magnitudesUpdater = createUpdater(context, RtsaUpdateMode::Incremental);
+    auto dbfsUpdater = createUpdater(context, RtsaUpdateMode::Incremental);
+
+    std::mt19937 generator{ 42 };
+    std::uniform_real_distribution<float> attenuationDistribution{ 0.0f, MagnitudeDbfsRange };
+
+    for (size_t frameIndex = 0; frameIndex < 2 * HistoryBufferCount; ++frameIndex)
+    {
+        std::vector<float> magnitudes(FrequencyCount);
+        std::vector<float> dbfsValues(FrequencyCount);
+        for (size_t i = 0; i < FrequencyCount; ++i)
+        {
+            const auto attenuation = attenuationDistribution(generator);
+            magnitudes[i] = ReferenceValue * std::pow(10.0f, -attenuation / 20.0f);
+            dbfsValues[i] = 20.0f * std::log10(magnitudes[i] / ReferenceValue);
+        }
+
+        cl::Buffer magnitudesBuffer{ context, magnitudes.begin(), magnitudes.end(), false };
+        cl::Buffer dbfsBuffer{ context, dbfsValues.begin(), dbfsValues.end(), false };
+        magnitudesUpdater->process(magnitudesBuffer, ReferenceValue);
+        dbfsUpdater->processDbfs(dbfsBuffer);
+
+        // the magnitudes stay intact for the other consumers
+        std::vector<float> magnitudesAfter(FrequencyCount);
+        cl::copy(queue, magnitudesBuffer, magnitudesAfter.begin(), magnitudesAfter.end());
+        ASSERT_EQ(magnitudesAfter, magnitudes);
+    }
+
+    const auto expected = readHeatmap(queue, *magnitudesUpdater);
+    const auto actual = readHeatmap(queue, *dbfsUpdater);
+    for (size_t i = 0; i < HeatmapValueCount; ++i)
+    {
+        ASSERT_NEAR(actual[i], expected[i], 1e-5f) << "value " << i;
+    }
+}
+
+class RtsaUpdaterLevelTest : public ::testing::TestWithParam<RtsaUpdateMode>
+{
+};
+
+TEST_P(RtsaUpdaterLevelTest, MatchesCoarseGatherUpdater)
+{
+    OpenclManager openclManager;
+    auto context = openclManager.getContext();
+    cl::CommandQueue queue{ context };
+
+    auto testedUpdater = createUpdater(context, GetParam());
+    ASSERT_EQ(testedUpdater->getLevelCount(), 2);
+
+    // level 1 has the cells of an updater with the half resolution
+    const auto coarseResolution = MagnitudeResolution / 2;
+    auto coarseUpdater = createUpdater(
+      context, RtsaUpdateMode::Gather, utils::RtsaStorageFormat::Float2, coarseResolution);
+
+    std::mt19937 generator{ 42 };
+    std::uniform_real_distribution<float> attenuationDistribution{ 0.0f, MagnitudeDbfsRange };
+
+    // the level is switched when the history already has frames
+    for (size_t frameIndex = 0; frameIndex < 2 * HistoryBufferCount; ++frameIndex)
+    {
+        if (frameIndex == HistoryBufferCount + 3)
+        {
+            testedUpdater->setLevel(1);
+        }
+
+        std::vector<float> magnitudes(FrequencyCount);
+        for (auto& magnitude : magnitudes)
+        {
+            const auto attenuation =
+              (frameIndex % 3 == 0) ? 30.0f : attenuationDistribution(generator);
+            magnitude = ReferenceValue * std::pow(10.0f, -attenuation / 20.0f);
+        }
+
+        cl::Buffer magnitudesBuffer{ context, magnitudes.begin(), magnitudes.end(), false };
+        testedUpdater->process(magnitudesBuffer, ReferenceValue);
+        coarseUpdater->process(magnitudesBuffer, ReferenceValue);
+    }
+
+    EXPECT_EQ(testedUpdater->getLevel(), 1);
+
+    const auto coarseValueCount = FrequencyCount * coarseResolution * 2;
+    const auto expected = readHeatmap(queue, *coarseUpdater, coarseValueCount);
+    const auto actual = readHeatmap(queue, *testedUpdater, coarseValueCount);
+    for (size_t i = 0; i < coarseValueCount; ++i)
+    {
+        ASSERT_FLOAT_EQ(actual[i], expected[i]) << "value " << i;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(HistoryModes,
+                         RtsaUpdaterLevelTest,
+                         ::testing::Values(RtsaUpdateMode::Gather,
+                                           RtsaUpdateMode::Scatter,
+                                           RtsaUpdateMode::Incremental));
+
+class RtsaUpdaterPackedStorageTest : public ::testing::TestWithParam<RtsaUpdateMode>
+{
+};
+
+TEST_P(RtsaUpdaterPackedStorageTest, MatchesFloatStorage)
+{
+    OpenclManager openclManager;
+    auto context = openclManager.getContext();
+    cl::CommandQueue queue{ context };
+
+    auto floatUpdater = createUpdater(context, GetParam());
+    auto packedUpdater =
+      createUpdater(context, GetParam(), utils::RtsaStorageFormat::Unorm16x2);
+
+    std::mt19937 generator{ 42 };
+    std::uniform_real_distribution<float> attenuationDistribution{ 0.0f, MagnitudeDbfsRange };
+
+    for (size_t frameIndex = 0; frameIndex < 2 * HistoryBufferCount; ++frameIndex)
+    {
+        std::vector<float> magnitudes(FrequencyCount);
+        for (auto& magnitude : magnitudes)
+        {
+            const auto attenuation = attenuationDistribution(generator);
+            magnitude = ReferenceValue * std::pow(10.0f, -attenuation / 20.0f);
+        }
+
+        cl::Buffer floatMagnitudes{ context, magnitudes.begin(), magnitudes.end(), false };
+        cl::Buffer packedMagnitudes{ context, magnitudes.begin(), magnitudes.end(), false };
+        floatUpdater->process(floatMagnitudes, ReferenceValue);
+        packedUpdater->process(packedMagnitudes, ReferenceValue);
+    }
+
+    // rounding to the nearest 16-bit step
+    const auto tolerance = 0.5f / 65535.0f + 1e-6f;
+    const auto expected = readHeatmap(queue, *floatUpdater);
+    const auto actual = readPackedHeatmap(queue, *packedUpdater);
+    for (size_t i = 0; i < HeatmapValueCount; ++i)
+    {
+        ASSERT_NEAR(actual[i], expected[i], tolerance) << "value " << i;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(AllModes,
+                         RtsaUpdaterPackedStorageTest,
+                         ::testing::Values(RtsaUpdateMode::Gather,
+                                           RtsaUpdateMode::Scatter,
+                                           RtsaUpdateMode::Incremental,
+                                           RtsaUpdateMode::ExponentialDecay));
+}
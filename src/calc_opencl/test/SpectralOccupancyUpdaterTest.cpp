@@ -0,0 +1,89 @@
+#include <spectr/calc_opencl/SpectralOccupancyUpdater.h>
+
+#include <spectr/calc_opencl/OpenclManager.h>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+namespace spectr::calc_opencl::test
+{
+namespace
+{
+constexpr size_t FrequencyCount = 256;
+constexpr size_t DutyCycleFrameCount = 4;
+constexpr float ThresholdDbfs = -48.0f;
+constexpr float Eps = 1e-5f;
+}
+
+TEST(SpectralOccupancyUpdaterTest, MatchesCpuReference)
+{
+    OpenclManager openclManager;
+    auto context = openclManager.getContext();
+
+    SpectralOccupancyUpdater updater{ context, FrequencyCount, ThresholdDbfs, DutyCycleFrameCount };
+    calc_cpu::SpectralOccupancyCalculator reference{
+        FrequencyCount, ThresholdDbfs, DutyCycleFrameCount
+    };
+
+    std::mt19937 generator{ 42 };
+    std::uniform_real_distribution<float> dbfsDistribution{ -96.0f, 0.0f };
+
+    // the duty cycle turns exponential after DutyCycleFrameCount frames, the statistics restart
+    for (size_t frameIndex = 0; frameIndex < 3 * DutyCycleFrameCount; ++frameIndex)
+    {
+        if (frameIndex == 2 * DutyCycleFrameCount)
+        {
+            updater.reset();
+            reference.reset();
+        }
+
+        std::vector<float> dbfsValues(FrequencyCount);
+        for (auto& dbfs : dbfsValues)
+        {
+            dbfs = dbfsDistribution(generator);
+        }
+        dbfsValues[0] = -120.0f; // never seen
+
+        cl::Buffer dbfsBuffer{ context, dbfsValues.begin(), dbfsValues.end(), true };
+        updater.process(dbfsBuffer);
+        reference.update(dbfsValues);
+        ASSERT_EQ(updater.getFrameCount(), reference.getFrameCount());
+
+        const auto& actual = updater.getStatistics();
+        const auto expected = reference.getBins();
+        ASSERT_EQ(actual.size(), expected.size());
+        for (size_t i = 0; i < FrequencyCount; ++i)
+        {
+            ASSERT_NEAR(actual[i].occupancy, expected[i].occupancy, Eps)
+              << "frame " << frameIndex << ", bin " << i;
+            ASSERT_NEAR(actual[i].dutyCycle, expected[i].dutyCycle, Eps)
+              << "frame " << frameIndex << ", bin " << i;
+            ASSERT_EQ(actual[i].framesSinceLastSeen, expected[i].framesSinceLastSeen)
+              << "frame " << frameIndex << ", bin " << i;
+        }
+    }
+
+    EXPECT_EQ(updater.getStatistics()[0].framesSinceLastSeen, calc_cpu::SpectralOccupancyNeverSeen);
+}
+
+TEST(SpectralOccupancyUpdaterTest, ReadsRequestedStatisticsByNextFrame)
+{
+    OpenclManager openclManager;
+    auto context = openclManager.getContext();
+
+    SpectralOccupancyUpdater updater{ context, FrequencyCount, ThresholdDbfs, DutyCycleFrameCount };
+    std::vector<float> dbfsValues(FrequencyCount, 0.0f);
+    cl::Buffer dbfsBuffer{ context, dbfsValues.begin(), dbfsValues.end(), true };
+
+    updater.process(dbfsBuffer);
+    EXPECT_EQ(updater.getLastStatistics()[0].occupancy, 0.0f); // not requested
+
+    updater.requestStatistics();
+    updater.process(dbfsBuffer);
+    const auto statistics = updater.getLastStatistics();
+    EXPECT_EQ(statistics[0].occupancy, 1.0f);
+    EXPECT_EQ(statistics[0].framesSinceLastSeen, 0);
+}
+}
@@ -0,0 +1,75 @@
+#include <spectr/calc_opencl/SpectrumTraceUpdater.h>
+
+#include <spectr/calc_cpu/SpectrumTraces.h>
+#include <spectr/calc_opencl/OpenclManager.h>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+namespace spectr::calc_opencl::test
+{
+namespace
+{
+constexpr size_t FrequencyCount = 256;
+constexpr size_t AverageFrameCount = 4;
+constexpr float Eps = 1e-3f; // dB
+}
+
+class SpectrumTraceUpdaterTest : public ::testing::TestWithParam<calc_cpu::SpectrumAverageMode>
+{
+};
+
+TEST_P(SpectrumTraceUpdaterTest, MatchesCpuReference)
+{
+    OpenclManager openclManager;
+    auto context = openclManager.getContext();
+    cl::CommandQueue queue{ context };
+
+    SpectrumTraceUpdater updater{ context, FrequencyCount, AverageFrameCount, GetParam() };
+    calc_cpu::SpectrumTraceCalculator reference{ FrequencyCount, AverageFrameCount, GetParam() };
+    HostRtsaHeatmapSink sink{ updater.getTracesBufferSize() };
+
+    std::mt19937 generator{ 42 };
+    std::uniform_real_distribution<float> dbfsDistribution{ -96.0f, 0.0f };
+
+    // the average turns exponential after AverageFrameCount frames, the hold traces restart
+    for (size_t frameIndex = 0; frameIndex < 3 * AverageFrameCount; ++frameIndex)
+    {
+        if (frameIndex == 2 * AverageFrameCount)
+        {
+            updater.reset();
+            reference.reset();
+        }
+
+        std::vector<float> dbfsValues(FrequencyCount);
+        for (auto& dbfs : dbfsValues)
+        {
+            dbfs = dbfsDistribution(generator);
+        }
+        dbfsValues[0] = calc_cpu::SpectrumTraceCalculator::MinDbfs; // zero magnitude
+
+        cl::Buffer dbfsBuffer{ context, dbfsValues.begin(), dbfsValues.end(), true };
+        updater.update(dbfsBuffer, sink);
+        reference.update(dbfsValues);
+
+        const auto actual = reinterpret_cast<const float*>(sink.getData().data());
+        for (size_t traceIndex = 0; traceIndex < calc_cpu::SpectrumTraceCount; ++traceIndex)
+        {
+            const auto& expected =
+              reference.getTrace(static_cast<calc_cpu::SpectrumTraceType>(traceIndex));
+            for (size_t i = 0; i < FrequencyCount; ++i)
+            {
+                ASSERT_NEAR(actual[traceIndex * FrequencyCount + i], expected[i], Eps)
+                  << "frame " << frameIndex << ", trace " << traceIndex << ", bin " << i;
+            }
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(AverageModes,
+                         SpectrumTraceUpdaterTest,
+                         ::testing::Values(calc_cpu::SpectrumAverageMode::Rms,
+                                           calc_cpu::SpectrumAverageMode::Linear));
+}
@@ -1,16 +1,22 @@
 #pragma once
 
+#include <spectr/audio_loader/FrameScheduler.h>
+#include <spectr/audio_loader/StreamingSampleBuffer.h>
+#include <spectr/calc_opencl/DeferredRtsaHeatmapSink.h>
 #include <spectr/calc_opencl/FftCooleyTukeyRadix2CL.h>
+#include <spectr/calc_opencl/MultiDeviceFftScheduler.h>
+#include <spectr/calc_opencl/OpenclProfiler.h>
 #include <spectr/calc_opencl/RtsaUpdater.h>
+#include <spectr/calc_opencl/SpectralOccupancyUpdater.h>
+#include <spectr/calc_opencl/SpectrumTraceUpdater.h>
 #include <spectr/render_gl/RtsaContainer.h>
 #include <spectr/render_gl/TimeFrequencyHeatmapContainer.h>
 #include <spectr/real_time_input/RealTimeInput.h>
+#include <spectr/storage/SpectrogramStorageWriter.h>
+#include <spectr/utils/FrameRing.h>
 
 #include <memory>
-#include <mutex>
-#include <queue>
 #include <thread>
-#include <unordered_map>
 #include <vector>
 
 namespace spectr::desktop_app
@@ -18,23 +24,33 @@ namespace spectr::desktop_app
 struct AudioFileTimeFrequencyWorkerSettings
 {
     std::shared_ptr<real_time_input::RealTimeInput> source;
-    audio_loader::SignalData audioData;
+    std::shared_ptr<audio_loader::FrameScheduler> frameScheduler; // decides which frames are cut
     size_t oneFftSampleCount;
-    size_t fftCalculationsInSecond;
+    size_t frameHop;      // samples between the starts of the following frames
+    float framesInSecond; // frame rate by the sample clock
     std::shared_ptr<render_gl::TimeFrequencyHeatmapContainer> heatmapContainer;
     std::shared_ptr<render_gl::RtsaContainer> rtsaHeatmapContainer;
     std::unique_ptr<calc_opencl::FftCooleyTukeyRadix2> fftCalculator;
-    std::unique_ptr<calc_opencl::RtsaUpdater> rtsaUpdater;
+    std::shared_ptr<calc_opencl::MultiDeviceFftScheduler> fftScheduler; // optional, splits frames between devices
+    std::shared_ptr<calc_opencl::RtsaUpdater> rtsaUpdater;
+    std::shared_ptr<calc_opencl::RtsaHeatmapSink> rtsaHeatmapSink; // destination of the RTSA heatmap
+    std::shared_ptr<calc_opencl::SpectrumTraceUpdater> spectrumTraceUpdater; // optional
+    std::shared_ptr<calc_opencl::RtsaHeatmapSink> spectrumTraceSink;
+    std::shared_ptr<calc_opencl::SpectralOccupancyUpdater> spectralOccupancyUpdater; // optional
+    std::shared_ptr<calc_opencl::OpenclProfiler> openclProfiler; // optional
+    std::shared_ptr<storage::SpectrogramStorageWriter> spectrogramWriter; // optional, records the columns
     size_t rtsaBufferSize;
     size_t fftSize;
 };
 
-struct PendingData
-{
-    size_t columnIndex;
-    float* values;
-};
-
+/**
+ * @brief Calculates the waterfall columns and the RTSA of the input signal.
+ * @details Three threads: the worker thread cuts the input into the frames due by the sample
+ * clock of the source, the compute thread runs all OpenCL calculations, update() called from the
+ * OpenGL thread only uploads the results. The frames and the calculated columns are passed
+ * through lock-free rings, the heatmaps through deferred sinks, so neither the frame rate limits
+ * the calculations nor the other way around.
+ */
 class AudioFileTimeFrequencyWorker
 {
 public:
@@ -44,9 +60,34 @@ public:
 
     void startWork();
 
+    /**
+     * @brief Uploads the results calculated since the previous call to OpenGL, must be called
+     * from the OpenGL thread.
+     */
     void update();
 
 private:
+    void computeLoop(std::stop_token stopToken);
+
+    /**
+     * @brief Calculates the next pending frame.
+     * @return False if there is no pending frame or no free column for it.
+     */
+    bool calculate();
+
+    /**
+     * @brief Calculates a batch of the pending frames on all devices.
+     * @return False if there are no pending frames or no free columns.
+     */
+    bool calculateMultiDevice();
+
+    /**
+     * @brief Writes the RTSA heatmap of the last processed frame in its level of detail to the
+     * deferred sink and updates the spectrum traces and the spectral occupancy with its dBFS
+     * values.
+     */
+    void onRtsaProcessed();
+
     void workLoop(std::stop_token stoken);
 
     size_t bufferSize; // temporary quick and dirty fix
@@ -54,9 +95,11 @@ private:
 private:
     AudioFileTimeFrequencyWorkerSettings m_settings;
     std::unique_ptr<std::jthread> m_workerThread;
-    std::queue<PendingData> m_pendingDatas;
-    std::mutex m_mutex;
-    std::unordered_map<size_t, GLuint> m_glBuffers;
-    GLuint m_rtsaGlBuffer;
+    std::unique_ptr<std::jthread> m_computeThread;
+    std::unique_ptr<audio_loader::StreamingSampleBuffer> m_samples; // of the worker thread
+    utils::FrameRing m_pendingFrames;     // views of the samples, read by the compute thread
+    utils::FrameRing m_calculatedColumns; // magnitudes, filled by the compute thread
+    std::shared_ptr<calc_opencl::DeferredRtsaHeatmapSink> m_rtsaHeatmapSink;
+    std::shared_ptr<calc_opencl::DeferredRtsaHeatmapSink> m_spectrumTraceSink; // optional
 };
 }
@@ -1,5 +1,12 @@
 #pragma once
 
+#include <spectr/audio_loader/FrameScheduler.h>
+#include <spectr/calc_cpu/SpectrumTraces.h>
+#include <spectr/calc_opencl/RtsaUpdater.h>
+#include <spectr/storage/SpectrogramStorageFormat.h>
+#include <spectr/utils/DecibelQuantizer.h>
+
+#include <optional>
 #include <string>
 #include <filesystem>
 
@@ -35,8 +42,26 @@ struct DesktopAppSettings
     std::filesystem::path audioFilePath;
     size_t fftSize = 0;
     size_t fftCalculationPerSecond = 0;
+    std::optional<float> overlap; // of the following frames, the hop is given by cps if not set
     BackendEngine backend = BackendEngine::CUDA;
     FrontendEngine frontend = FrontendEngine::OpenGL;
     AudioSource source = AudioSource::BladeRF;
+    std::string openclDevice; // empty - automatic selection by calibration FFT throughput
+    bool useAllOpenclDevices = false;
+    bool enableOpenclProfiling = false;
+    calc_opencl::RtsaUpdateMode rtsaUpdateMode = calc_opencl::RtsaUpdateMode::Incremental;
+    float rtsaPersistenceTime = 4.0f; // seconds
+    size_t rtsaMagnitudeResolution = 1024; // cells of the magnitude axis at full detail
+    utils::RtsaStorageFormat rtsaStorageFormat = utils::RtsaStorageFormat::Unorm16x2;
+    size_t spectrumTraceAverageFrameCount = 16;
+    calc_cpu::SpectrumAverageMode spectrumTraceAverageMode = calc_cpu::SpectrumAverageMode::Rms;
+    float occupancyThresholdDbfs = -60.0f; // a frequency bin above it is occupied
+    size_t occupancyDutyCycleFrameCount = 64; // count of the recent frames in the duty cycle
+    audio_loader::FrameOverloadPolicy frameOverloadPolicy =
+      audio_loader::FrameOverloadPolicy::DropOldest;
+    float maxFrameLatency = 1.0f; // seconds of due frames before the overload policy applies
+    std::filesystem::path recordPath; // empty - the waterfall columns aren't recorded
+    storage::ValueFormat recordValueFormat = storage::ValueFormat::Decibel16;
+    utils::ValueFormat waterfallStorageFormat = utils::ValueFormat::Float32;
 };
 }
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <spectr/audio_loader/FrameScheduler.h>
+#include <spectr/render_gl/RenderContext.h>
+
+#include <memory>
+
+namespace spectr::desktop_app
+{
+/**
+ * @brief Shows counters of the frame scheduler, whether the FFT keeps up with the input.
+ */
+class FrameSchedulerWidget
+{
+public:
+    FrameSchedulerWidget(ImFont* font, std::shared_ptr<audio_loader::FrameScheduler> scheduler);
+
+    void render();
+
+private:
+    ImFont* m_font = nullptr;
+    std::shared_ptr<audio_loader::FrameScheduler> m_scheduler;
+};
+}
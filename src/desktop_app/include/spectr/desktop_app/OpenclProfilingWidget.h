@@ -0,0 +1,24 @@
+#pragma once
+
+#include <spectr/calc_opencl/OpenclProfiler.h>
+#include <spectr/render_gl/RenderContext.h>
+
+#include <memory>
+
+namespace spectr::desktop_app
+{
+/**
+ * @brief Shows per-stage OpenCL execution time statistics of the profiler.
+ */
+class OpenclProfilingWidget
+{
+public:
+    OpenclProfilingWidget(ImFont* font, std::shared_ptr<calc_opencl::OpenclProfiler> profiler);
+
+    void render();
+
+private:
+    ImFont* m_font = nullptr;
+    std::shared_ptr<calc_opencl::OpenclProfiler> m_profiler;
+};
+}
@@ -3,12 +3,19 @@
 #include <spectr/render_gl/TimeFrequencyHeatmapRenderer.h>
 
 #include <functional>
+#include <string>
+#include <vector>
 
 namespace spectr::desktop_app
 {
 struct RtsaViewSettingsWidgetSettings
 {
     std::function<void(render_gl::FrequencyAxisScale)> onFrequencyAxisScaleChanged;
+    std::function<void(float)> onPersistenceTimeChanged; // optional, seconds
+    float persistenceTime = 0.0f;                         // initial value, seconds
+    std::vector<std::string> traceNames;                  // spectrum traces, all visible initially
+    std::function<void(size_t, bool)> onTraceVisibilityChanged;
+    std::function<void()> onTracesReset; // optional
 };
 
 class RtsaViewSettingsWidget
@@ -26,5 +33,7 @@ private:
     ImFont* m_font = nullptr;
     RtsaViewSettingsWidgetSettings m_settings;
     render_gl::FrequencyAxisScale m_frequencyAxisScale = render_gl::FrequencyAxisScale::Linear;
+    float m_persistenceTime = 0.0f;
+    std::vector<bool> m_traceVisibilities;
 };
 }
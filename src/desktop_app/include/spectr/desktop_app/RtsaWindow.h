@@ -12,13 +12,30 @@
 #include <spectr/render_gl/RenderContext.h>
 #include <spectr/render_gl/RtsaContainer.h>
 #include <spectr/render_gl/RtsaRenderer.h>
+#include <spectr/render_gl/SpectrumTraceContainer.h>
+#include <spectr/render_gl/SpectrumTraceRenderer.h>
 
 namespace spectr::desktop_app
 {
 class RtsaWindow : public Window
 {
 public:
-    RtsaWindow(std::shared_ptr<Input> input, std::shared_ptr<render_gl::RtsaContainer> container);
+    /**
+     * @param onPersistenceTimeChanged Optional, if set the persistence time in seconds can be
+     * adjusted in the view settings.
+     * @param persistenceTime Initial persistence time in seconds.
+     * @param spectrumTraces Optional, spectrum traces drawn over the heatmap.
+     * @param onSpectrumTracesReset Optional, if set the traces can be reset in the view settings.
+     * @param onLevelChanged Optional, called with the RTSA level of detail matching the view
+     * when it changes.
+     */
+    RtsaWindow(std::shared_ptr<Input> input,
+               std::shared_ptr<render_gl::RtsaContainer> container,
+               std::function<void(float)> onPersistenceTimeChanged = {},
+               float persistenceTime = 0.0f,
+               std::shared_ptr<render_gl::SpectrumTraceContainer> spectrumTraces = nullptr,
+               std::function<void()> onSpectrumTracesReset = {},
+               std::function<void(size_t)> onLevelChanged = {});
 
     void onMainLoopUpdate() override;
 
@@ -31,17 +48,25 @@ public:
 private:
     void recreateAxis();
 
+    /**
+     * @brief Requests the RTSA level of detail with the magnitude cell closest to one pixel.
+     */
+    void updateLevelOfDetail();
+
 private:
     std::shared_ptr<Input> m_input;
     std::shared_ptr<render_gl::RtsaContainer> m_container;
     std::shared_ptr<render_gl::CheckerGridRenderer> m_checkerGridRenderer;
     std::shared_ptr<render_gl::RtsaRenderer> m_rtsaRenderer;
+    std::shared_ptr<render_gl::SpectrumTraceRenderer> m_spectrumTraceRenderer;
     std::unique_ptr<PanTool> m_panTool;
     std::shared_ptr<HeatmapCursorInfo> m_cursorInfoWidget;
     std::shared_ptr<RtsaViewSettingsWidget> m_rtsaViewSettingsWidget;
     std::shared_ptr<render_gl::Camera> m_camera;
     std::shared_ptr<render_gl::RenderContext> m_renderContext;
     ImFont* m_axisFont = nullptr;
+    std::function<void(size_t)> m_onLevelChanged;
+    size_t m_requestedLevel = 0;
     std::vector<std::shared_ptr<render_gl::AxisRenderer>> m_axes;
 };
 }
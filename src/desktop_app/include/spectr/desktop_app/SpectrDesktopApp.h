@@ -1,13 +1,21 @@
 #pragma once
 
+#include <spectr/calc_opencl/OpenclProfiler.h>
+#include <spectr/calc_opencl/RtsaUpdater.h>
+#include <spectr/calc_opencl/SpectralOccupancyUpdater.h>
+#include <spectr/calc_opencl/SpectrumTraceUpdater.h>
 #include <spectr/desktop_app/DesktopAppSettings.h>
 #include <spectr/desktop_app/Input.h>
+#include <spectr/desktop_app/FrameSchedulerWidget.h>
+#include <spectr/desktop_app/OpenclProfilingWidget.h>
 #include <spectr/desktop_app/RtsaWindow.h>
+#include <spectr/desktop_app/SpectralOccupancyWidget.h>
 #include <spectr/desktop_app/WaterfallWindow.h>
 #include <spectr/desktop_app/SplitWindow.h>
 #include <spectr/render_gl/FpsGuard.h>
 #include <spectr/render_gl/GlfwUtils.h>
 #include <spectr/render_gl/RtsaContainer.h>
+#include <spectr/render_gl/SpectrumTraceContainer.h>
 #include <spectr/render_gl/TimeFrequencyHeatmapContainer.h>
 #include <spectr/real_time_input/RealTimeInput.h>
 
@@ -46,7 +54,19 @@ private:
     std::shared_ptr<render_gl::TimeFrequencyHeatmapContainer> m_timeFrequencyHeatmapContainer;
     std::shared_ptr<render_gl::RtsaContainer> m_rtsaHeatmapContainer;
     std::unique_ptr<render_gl::FpsGuard> m_fpsGuard;
+    std::shared_ptr<calc_opencl::OpenclProfiler> m_openclProfiler;
+    std::shared_ptr<calc_opencl::RtsaUpdater> m_rtsaUpdater;
+    std::shared_ptr<render_gl::SpectrumTraceContainer> m_spectrumTraceContainer;
+    std::shared_ptr<calc_opencl::SpectrumTraceUpdater> m_spectrumTraceUpdater;
+    std::unique_ptr<OpenclProfilingWidget> m_openclProfilingWidget;
+    std::shared_ptr<calc_opencl::SpectralOccupancyUpdater> m_spectralOccupancyUpdater;
+    std::unique_ptr<SpectralOccupancyWidget> m_spectralOccupancyWidget;
+    SpectralOccupancyWidgetSettings m_spectralOccupancyWidgetSettings;
+    std::shared_ptr<audio_loader::FrameScheduler> m_frameScheduler;
+    std::unique_ptr<FrameSchedulerWidget> m_frameSchedulerWidget;
     std::vector<std::function<void()>> m_onMainLoopActions;
     std::shared_ptr<real_time_input::RealTimeInput> m_inputSource;
+    size_t m_frameHop = 0;         // samples between the starts of the following frames
+    float m_framesInSecond = 0.0f; // frame rate by the sample clock of the input
 };
 }
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <spectr/calc_opencl/SpectralOccupancyUpdater.h>
+#include <spectr/render_gl/RenderContext.h>
+#include <spectr/utils/Timer.h>
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace spectr::desktop_app
+{
+struct SpectralOccupancyWidgetSettings
+{
+    float firstBinFrequency; // Hz
+    float binWidth;          // Hz
+    float frameDuration;     // seconds
+    std::filesystem::path csvPath;
+};
+
+/**
+ * @brief Shows the most occupied frequency bins of the spectral occupancy, allows to change the
+ * threshold and to export the statistics of all bins to CSV.
+ */
+class SpectralOccupancyWidget
+{
+public:
+    SpectralOccupancyWidget(ImFont* font,
+                            std::shared_ptr<calc_opencl::SpectralOccupancyUpdater> updater,
+                            SpectralOccupancyWidgetSettings settings);
+
+    void render();
+
+private:
+    void refresh();
+
+    void exportCsv();
+
+private:
+    ImFont* m_font = nullptr;
+    std::shared_ptr<calc_opencl::SpectralOccupancyUpdater> m_updater;
+    SpectralOccupancyWidgetSettings m_settings;
+    float m_thresholdDbfs = 0.0f;
+    utils::Timer m_refreshTimer;
+    bool m_isRefreshed = false;
+    std::vector<calc_cpu::SpectralOccupancyBin> m_bins; // read by the last refresh
+    std::vector<size_t> m_topBinIndices;                 // the most occupied bins, descending
+    std::string m_exportStatus;
+};
+}
@@ -3,6 +3,7 @@
 #include <spectr/calc_cpu/FftCooleyTukeyRadix2.h>
 #include <spectr/calc_cpu/FftCooleyTukeyUtils.h>
 #include <spectr/calc_cuda/FftCooleyTukeyRadix2Cuda.h>
+#include <spectr/render_gl/GraphicsApi.h>
 #include <spectr/utils/Math.h>
 #include <spectr/utils/Timer.h>
 #include <spectr/utils/Assert.h>
@@ -16,6 +17,10 @@ namespace spectr::desktop_app
 {
 namespace
 {
+const auto MagnitudeReferenceValue = std::pow(2.0f, 31.0f);
+constexpr size_t MinPendingFrameCount = 4;
+constexpr auto IdleWaitTime = std::chrono::milliseconds(1); // of the worker and compute threads
+
 std::pair<float, float> minMax(const std::vector<float>& values)
 {
     const auto minEl = std::min_element(values.begin(), values.end());
@@ -26,201 +31,261 @@ std::pair<float, float> minMax(const std::vector<float>& values)
 
 AudioFileTimeFrequencyWorker::AudioFileTimeFrequencyWorker(
   AudioFileTimeFrequencyWorkerSettings settings)
-  : m_settings { std::move(settings) }, m_rtsaGlBuffer(m_settings.rtsaHeatmapContainer->getBuffer()), bufferSize(settings.rtsaBufferSize)
-  // , m_rtsaGlBuffer{ m_settings.fftCalculator->getContext(),
-  //                   CL_MEM_READ_WRITE,
-  //                   m_settings.rtsaHeatmapContainer->getBuffer() }
+  : bufferSize(settings.rtsaBufferSize)
+  , m_settings{ std::move(settings) }
+  , m_pendingFrames{ std::max(m_settings.frameScheduler->getMaxBacklogFrameCount(),
+                              MinPendingFrameCount),
+                     0 }
+  , m_calculatedColumns{ m_pendingFrames.getSlotCount(),
+                         m_settings.heatmapContainer->getSettings().columnHeightElementCount }
 {
+    // the pending frames are views of the sample buffer, so besides the allowed backlog it keeps
+    // the samples of all frames until the FFT releases them
+    m_settings.frameScheduler->setHop(m_settings.frameHop);
+    m_samples = std::make_unique<audio_loader::StreamingSampleBuffer>(
+      m_settings.frameScheduler->getSampleCapacity() +
+      m_settings.frameHop * m_pendingFrames.getSlotCount());
+
+    // the heatmaps are calculated on the compute thread and uploaded to OpenGL by update()
+    const auto context = m_settings.fftCalculator->getContext();
+    m_rtsaHeatmapSink = std::make_shared<calc_opencl::DeferredRtsaHeatmapSink>(
+      context, m_settings.rtsaHeatmapSink, m_settings.openclProfiler);
+    if (m_settings.spectrumTraceUpdater)
+    {
+        m_spectrumTraceSink = std::make_shared<calc_opencl::DeferredRtsaHeatmapSink>(
+          context, m_settings.spectrumTraceSink, m_settings.openclProfiler);
+    }
 }
 
 AudioFileTimeFrequencyWorker::~AudioFileTimeFrequencyWorker()
 {
-    if (m_workerThread)
+    for (auto& thread : { m_workerThread.get(), m_computeThread.get() })
     {
-        ASSERT(m_workerThread->request_stop());
-        m_workerThread->join();
+        if (thread)
+        {
+            ASSERT(thread->request_stop());
+            thread->join();
+        }
     }
 }
 
 void AudioFileTimeFrequencyWorker::update()
 {
-    // get buffer
-    auto buffer = m_settings.heatmapContainer->getOrAllocateBuffer(0);
-
-    utils::Timer timer;
-    PendingData calculationInputData;
+    // stage: upload the columns calculated since the previous frame
+    while (const auto column = m_calculatedColumns.front())
+    {
+        m_settings.heatmapContainer->addColumn(column->frameIndex, column->values);
+        m_settings.heatmapContainer->tryUpdateMaxValue(column->maxValue);
+        m_calculatedColumns.release();
+    }
 
-    // calculate fft
-    for (size_t i = 0; i < m_settings.fftCalculationsInSecond / 3 + 1; ++i)
+    // stage: upload the heatmaps of the last RTSA update, in its level of detail
+    if (const auto level = m_rtsaHeatmapSink->flush())
     {
-        utils::Timer globalFftTimer;
+        m_settings.rtsaHeatmapContainer->setLevel(*level);
+    }
+    if (m_spectrumTraceSink)
+    {
+        m_spectrumTraceSink->flush();
+    }
+}
 
-        // stage: get input data
+void AudioFileTimeFrequencyWorker::computeLoop(std::stop_token stopToken)
+{
+    while (!stopToken.stop_requested())
+    {
+        const auto isCalculated = m_settings.fftScheduler ? calculateMultiDevice() : calculate();
+        if (!isCalculated)
         {
-            std::lock_guard<std::mutex> lock{ m_mutex };
-            if (m_pendingDatas.empty())
-            {
-                break;
-            }
-
-            calculationInputData = std::move(m_pendingDatas.front());
-            m_pendingDatas.pop();
+            std::this_thread::sleep_for(IdleWaitTime);
         }
+    }
+}
+
+bool AudioFileTimeFrequencyWorker::calculate()
+{
+    // stage: get input data, the calculation waits if the rendering doesn't keep up
+    const auto inputFrame = m_pendingFrames.front();
+    const auto column = m_calculatedColumns.tryClaim();
+    if (!inputFrame || !column)
+    {
+        return false;
+    }
+    column->frameIndex = inputFrame->frameIndex;
+
+    utils::Timer globalFftTimer;
+    utils::Timer timer;
 
-        // stage: calculate FFT
-        timer.restart();
-
-        // OpenCL
-        m_settings.fftCalculator->execute(calculationInputData.values);
-        // CUDA
-        // size_t stageCount = utils::Math::getPowerOfTwo(m_settings.fftSize);
-        // 
-        // float* buffer0    = new float[m_settings.audioData.getSampleRate() / m_settings.fftCalculationsInSecond * 2];
-        // float* buffer1    = new float[m_settings.audioData.getSampleRate() / m_settings.fftCalculationsInSecond * 2];
-        // float* magnitudes = new float[m_settings.audioData.getSampleRate() / m_settings.fftCalculationsInSecond];
-        // std::vector<std::complex<float>>* omegas = new std::vector<std::complex<float>>[stageCount];
-        // 
-        // constexpr size_t block_size = 64;
-        // 
-        // for (size_t stageIndex = 0; stageIndex < stageCount; ++stageIndex)
-        // {
-        //     const auto subFftHalfSize = 1 << stageIndex;
-        //     omegas[stageIndex] = calc_cpu::FftCooleyTukeyUtils::getOmegas<float>(stageIndex);
-        // }
-        // 
-        // std::memcpy(buffer0, calculationInputData.values, m_settings.audioData.getSampleRate() / m_settings.fftCalculationsInSecond * sizeof(float));
-        // 
-        // bit_reverse_permutation_wrapper(buffer0, buffer1, m_settings.audioData.getSampleRate() / m_settings.fftCalculationsInSecond, block_size);
-        // 
-        // std::swap(buffer0, buffer1);
-        // 
-        // const auto complexNumberSize = 2 * sizeof(float);
-        // 
-        // for (size_t stageIndex = 0; stageIndex < stageCount; ++stageIndex)
-        // {
-        //     const auto& srcBuffer = buffer0;
-        //     const auto& dstBuffer = buffer1;
-        // 
-        //     const auto subFftSize = 1ull << (stageIndex + 1ull);
-        //     const auto subFftCount = m_settings.fftSize / subFftSize;
-        // 
-        //     const auto omegaBuffer = omegas[stageIndex];
-        // 
-        //     fft_stage_wrapper(srcBuffer,
-        //                       dstBuffer,
-        //                       reinterpret_cast<const float*>(omegaBuffer.data()),
-        //                       static_cast<unsigned int>(subFftSize),
-        //                       static_cast<unsigned int>(subFftCount),
-        //                       static_cast<unsigned int>(stageIndex),
-        //                       m_settings.audioData.getSampleRate() / m_settings.fftCalculationsInSecond,
-        //                       omegaBuffer.size());
-        // 
-        //     std::swap(buffer0, buffer1);
-        // }
-
-        // spdlog::trace("FFT calculation, size: {}, time: {}",
-        //               calculationInputData.values.size(),
-        //               timer.toString());
-
-        std::cout << "FFT calculation, size: " << m_settings.oneFftSampleCount << ", time: " << timer.toString() << std::endl;
-
-        // OpenCL
-        // const auto fftResultGpu = m_settings.fftCalculator->getFffBufferCpu();
-        // const auto magnitudesGPU =
-        //   calc_cpu::FftCooleyTukeyRadix2::getMagnitudesFromFFT(fftResultGpu);
-
-        //// debug stage: calculate on CPU, find max magnitude value
-        // timer.restart();
-        // const auto gpuMinMax = minMax(magnitudesGPU);
-        // const auto maxMagnitudeLocal = gpuMinMax.second;
-        // spdlog::trace("Magnitudes CPU calculation and finding max, time: {}", toString(timer));
-
-        // spdlog::trace("Max magnitude found: {}", toString(timer));
-
-        // constexpr bool CompareWithCpu = false;
-        // if (CompareWithCpu)
-        //{
-        //     const auto fftResultCpu =
-        //       calc_cpu::FftCooleyTukeyRadix2::getFFT(calculationInputData.values);
-        //     const auto magnitudesCPU =
-        //       calc_cpu::FftCooleyTukeyRadix2::getMagnitudesFromFFT(fftResultCpu);
-        //     const auto cpuMinMax = minMax(magnitudesCPU);
-        //     int x = 5;
-        // }
-
-        // stage: calculate and copy magnitudes to output buffer
-        timer.restart();
-
-        auto& heatmapBuffer =
-          m_settings.heatmapContainer->getOrAllocateBuffer(calculationInputData.columnIndex);
-
-        auto bufferIt = m_glBuffers.find(heatmapBuffer.startColumn);
-
-        GLuint openglOpenclBuffer;
-        if (bufferIt == m_glBuffers.end())
+    // stage: calculate FFT
+    // OpenCL
+    m_settings.fftCalculator->execute(inputFrame->sharedValues);
+    m_pendingFrames.release(); // the samples are copied to the device
+    // CUDA
+    // size_t stageCount = utils::Math::getPowerOfTwo(m_settings.fftSize);
+    // 
+    // float* buffer0    = new float[m_settings.audioData.getSampleRate() / m_settings.fftCalculationsInSecond * 2];
+    // float* buffer1    = new float[m_settings.audioData.getSampleRate() / m_settings.fftCalculationsInSecond * 2];
+    // float* magnitudes = new float[m_settings.audioData.getSampleRate() / m_settings.fftCalculationsInSecond];
+    // std::vector<std::complex<float>>* omegas = new std::vector<std::complex<float>>[stageCount];
+    // 
+    // constexpr size_t block_size = 64;
+    // 
+    // for (size_t stageIndex = 0; stageIndex < stageCount; ++stageIndex)
+    // {
+    //     const auto subFftHalfSize = 1 << stageIndex;
+    //     omegas[stageIndex] = calc_cpu::FftCooleyTukeyUtils::getOmegas<float>(stageIndex);
+    // }
+    // 
+    // std::memcpy(buffer0, calculationInputData.values, m_settings.audioData.getSampleRate() / m_settings.fftCalculationsInSecond * sizeof(float));
+    // 
+    // bit_reverse_permutation_wrapper(buffer0, buffer1, m_settings.audioData.getSampleRate() / m_settings.fftCalculationsInSecond, block_size);
+    // 
+    // std::swap(buffer0, buffer1);
+    // 
+    // const auto complexNumberSize = 2 * sizeof(float);
+    // 
+    // for (size_t stageIndex = 0; stageIndex < stageCount; ++stageIndex)
+    // {
+    //     const auto& srcBuffer = buffer0;
+    //     const auto& dstBuffer = buffer1;
+    // 
+    //     const auto subFftSize = 1ull << (stageIndex + 1ull);
+    //     const auto subFftCount = m_settings.fftSize / subFftSize;
+    // 
+    //     const auto omegaBuffer = omegas[stageIndex];
+    // 
+    //     fft_stage_wrapper(srcBuffer,
+    //                       dstBuffer,
+    //                       reinterpret_cast<const float*>(omegaBuffer.data()),
+    //                       static_cast<unsigned int>(subFftSize),
+    //                       static_cast<unsigned int>(subFftCount),
+    //                       static_cast<unsigned int>(stageIndex),
+    //                       m_settings.audioData.getSampleRate() / m_settings.fftCalculationsInSecond,
+    //                       omegaBuffer.size());
+    // 
+    //     std::swap(buffer0, buffer1);
+    // }
+
+
+    std::cout << "FFT calculation, size: " << m_settings.oneFftSampleCount << ", time: " << timer.toString() << std::endl;
+
+    // OpenCL
+    // const auto fftResultGpu = m_settings.fftCalculator->getFffBufferCpu();
+    // const auto magnitudesGPU =
+    //   calc_cpu::FftCooleyTukeyRadix2::getMagnitudesFromFFT(fftResultGpu);
+
+    //// debug stage: calculate on CPU, find max magnitude value
+    // timer.restart();
+    // const auto gpuMinMax = minMax(magnitudesGPU);
+    // const auto maxMagnitudeLocal = gpuMinMax.second;
+    // spdlog::trace("Magnitudes CPU calculation and finding max, time: {}", toString(timer));
+
+    // spdlog::trace("Max magnitude found: {}", toString(timer));
+
+    // constexpr bool CompareWithCpu = false;
+    // if (CompareWithCpu)
+    //{
+    //     const auto fftResultCpu =
+    //       calc_cpu::FftCooleyTukeyRadix2::getFFT(calculationInputData.values);
+    //     const auto magnitudesCPU =
+    //       calc_cpu::FftCooleyTukeyRadix2::getMagnitudesFromFFT(fftResultCpu);
+    //     const auto cpuMinMax = minMax(magnitudesCPU);
+    //     int x = 5;
+    // }
+
+    // stage: calculate magnitudes for the waterfall and dBFS values for the RTSA
+    timer.restart();
+    // OpenCL
+    m_settings.fftCalculator->calculateSpectrum(MagnitudeReferenceValue, true);
+    column->maxValue = m_settings.fftCalculator->findMaxMagnitude();
+    m_settings.fftCalculator->readMagnitudes(column->values);
+    if (m_settings.spectrogramWriter)
+    {
+        m_settings.spectrogramWriter->appendColumns(column->values, 1);
+    }
+    m_calculatedColumns.publish();
+    // CUDA
+    // calculate_magnitudes_wrapper(buffer0, magnitudes, m_settings.audioData.getSampleRate() / m_settings.fftCalculationsInSecond, block_size);
+    // 
+    // float maxMagnitudeLocal = *std::ranges::max(magnitudes, &magnitudes[m_settings.fftCalculationsInSecond * sizeof(float) - 1]);
+
+    std::cout << "Magnitudes calculated: " << timer.toString() << std::endl;
+
+    // stage: apply the calculated values to the RTSA heatmap buffer
+    timer.restart();
+    // OpenCL
+    m_settings.rtsaUpdater->processDbfs(m_settings.fftCalculator->getDbfsBuffer());
+    onRtsaProcessed();
+    // CUDA
+    // -- todo --
+
+    std::cout << "RTSA updated: " << timer.toString() << std::endl;
+    std::cout << "Whole spectrogram stage: " << globalFftTimer.toString() << std::endl;
+
+    return true;
+}
+
+bool AudioFileTimeFrequencyWorker::calculateMultiDevice()
+{
+    // the batch refers to the pending frames directly, they are released after the processing
+    std::vector<calc_opencl::FftFrame> frames;
+    const auto maxBatchSize =
+      std::min(static_cast<size_t>(m_settings.framesInSecond / 3.0f) + 1,
+               m_calculatedColumns.getFreeSlotCount());
+    while (frames.size() < maxBatchSize)
+    {
+        const auto inputFrame = m_pendingFrames.front(frames.size());
+        if (!inputFrame)
         {
-            openglOpenclBuffer = heatmapBuffer.ssbo;
-            m_glBuffers.insert({ heatmapBuffer.startColumn, openglOpenclBuffer });
+            break;
         }
-        else
+        frames.push_back({ inputFrame->frameIndex, inputFrame->sharedValues });
+    }
+
+    if (frames.empty())
+    {
+        return false;
+    }
+
+    const auto results = m_settings.fftScheduler->process(frames);
+    m_pendingFrames.release(frames.size());
+
+    // results are sorted by column index, so columns are filled in order
+    for (const auto& result : results)
+    {
+        const auto column = m_calculatedColumns.tryClaim();
+        ASSERT(column);
+        column->frameIndex = result.columnIndex;
+        column->maxValue = result.maxMagnitude;
+        std::copy(result.magnitudes.begin(), result.magnitudes.end(), column->values);
+        m_calculatedColumns.publish();
+
+        if (m_settings.spectrogramWriter)
         {
-            openglOpenclBuffer = bufferIt->second;
+            m_settings.spectrogramWriter->appendColumns(result.magnitudes.data(), 1);
         }
 
-        const auto columnLocalIndex = calculationInputData.columnIndex - heatmapBuffer.startColumn;
-
-        const auto elementOffsetInBuffer =
-          columnLocalIndex * m_settings.heatmapContainer->getSettings().columnHeightElementCount;
-
-        // stage: calculate magnitudes
-        timer.restart();
-        // OpenCL
-        m_settings.fftCalculator->calculateMagnitudes();
-        float maxMagnitudeLocal = 0;
-        // spdlog::trace("Magnitudes calculated: {}", timer.toString());
-        // CUDA
-        // calculate_magnitudes_wrapper(buffer0, magnitudes, m_settings.audioData.getSampleRate() / m_settings.fftCalculationsInSecond, block_size);
-        // 
-        // float maxMagnitudeLocal = *std::ranges::max(magnitudes, &magnitudes[m_settings.fftCalculationsInSecond * sizeof(float) - 1]);
-
-        std::cout << "Magnitudes calculated: " << timer.toString() << std::endl;
-
-        // OpenCL
-        // stage: copy magnitudes values to final OpenGL buffer
-        m_settings.fftCalculator->copyMagnitudesTo(
-         openglOpenclBuffer, static_cast<cl_uint>(elementOffsetInBuffer), &maxMagnitudeLocal);
-        // spdlog::trace("Magnitudes copied: {}", timer.toString());
-        
-        // CUDA
-        // glBindBuffer(GL_SHADER_STORAGE_BUFFER, openglOpenclBuffer);
-        // glBufferSubData(GL_SHADER_STORAGE_BUFFER, elementOffsetInBuffer * sizeof(float), m_settings.audioData.getSampleRate() / m_settings.fftCalculationsInSecond * sizeof(float), magnitudes);
-        // glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
-
-        std::cout << "Magnitudes copied: " << timer.toString() << std::endl;
-
-        // TODO add mutex?
-        m_settings.heatmapContainer->tryUpdateMaxValue(maxMagnitudeLocal);
-        m_settings.heatmapContainer->setLastFilledColumn(calculationInputData.columnIndex);
-
-        // stage: apply the calculated values to the RTSA heatmap buffer:
-        timer.restart();
-        const auto referenceValue = std::pow(2.0f, 31.0f);
-        // OpenCL
-        m_settings.rtsaUpdater->update(
-          m_settings.fftCalculator->getMagnitudesBuffer(), m_rtsaGlBuffer, referenceValue);
-        // spdlog::trace("RTSA updated: {}", timer.toString());
-        // CUDA
-        // -- todo --
-
-        std::cout << "RTSA updated: " << timer.toString() << std::endl;
-
-        // spdlog::trace("Whole spectrogram stage: {}", globalFftTimer.toString());
-        std::cout << "Whole spectrogram stage: " << globalFftTimer.toString() << std::endl;
-
-        // delete[] buffer0;
-        // delete[] buffer1;
-        // delete[] omegas;
-        // delete[] magnitudes;
+        m_settings.rtsaUpdater->process(result.magnitudes.data(), MagnitudeReferenceValue);
+        onRtsaProcessed();
+    }
+
+    return true;
+}
+
+void AudioFileTimeFrequencyWorker::onRtsaProcessed()
+{
+    m_rtsaHeatmapSink->setTag(m_settings.rtsaUpdater->getLevel());
+    m_settings.rtsaUpdater->write(*m_rtsaHeatmapSink);
+
+    if (m_settings.spectrumTraceUpdater)
+    {
+        m_settings.spectrumTraceUpdater->update(m_settings.rtsaUpdater->getDbfsBuffer(),
+                                                *m_spectrumTraceSink);
+    }
+
+    if (m_settings.spectralOccupancyUpdater)
+    {
+        m_settings.spectralOccupancyUpdater->process(m_settings.rtsaUpdater->getDbfsBuffer());
     }
 }
 
@@ -228,52 +293,107 @@ void AudioFileTimeFrequencyWorker::startWork()
 {
     m_workerThread =
       std::make_unique<std::jthread>([this](std::stop_token stopToken) { workLoop(stopToken); });
+    m_computeThread =
+      std::make_unique<std::jthread>([this](std::stop_token stopToken) { computeLoop(stopToken); });
 }
 
-// todo: This is function is not thread safe
 void AudioFileTimeFrequencyWorker::workLoop(std::stop_token stopToken)
 {
-    const auto sleepTime = 1.0f / m_settings.fftCalculationsInSecond;
-    size_t columnIndex = 0;
-    size_t globalSamplesOffset = 0;
+    auto& scheduler = *m_settings.frameScheduler;
+    auto& samples = *m_samples;
+    const auto pendingSlotCount = m_pendingFrames.getSlotCount();
+    std::vector<size_t> pendingFrameStarts(pendingSlotCount);
+    size_t publishedFrameCount = 0;
+
+    // the latest chunk of the input, it's moved to the sample buffer as the frames consume it
+    audio_loader::SignalData inputChunk;
+    size_t inputChunkOffset = 0;
 
     while (!stopToken.stop_requested())
     {
-        std::this_thread::sleep_for(std::chrono::duration<float>(sleepTime));
-
-        // load new data
-        m_settings.audioData += m_settings.source->getSignalData();
+        // load new data only after the previous chunk is consumed, so with the blocking policy
+        // the source waits while the backlog is being produced
+        if (inputChunk.getChannelCount() == 0 || inputChunkOffset == inputChunk.getSampleCount())
+        {
+            inputChunk = m_settings.source->getSignalData();
+            inputChunkOffset = 0;
+        }
 
-        if (m_settings.audioData.getChannelCount() == 0) {
+        if (inputChunk.getChannelCount() == 0)
+        {
+            std::this_thread::sleep_for(IdleWaitTime);
             continue;
         }
 
-        const auto oneFftSamplesOffset =
-            m_settings.audioData.getSampleRate() / m_settings.fftCalculationsInSecond;
-        const auto& sampleData = m_settings.audioData.getChannelSampleData(0);
+        // produce all due frames, the scheduler skips the ones above the backlog limit
+        bool isProduced = false;
+        while (!stopToken.stop_requested())
+        {
+            // samples are needed from the oldest frame which is not released by the FFT yet
+            const auto pendingFrameCount = pendingSlotCount - m_pendingFrames.getFreeSlotCount();
+            auto neededStart = scheduler.getNextFrameStart();
+            if (pendingFrameCount > 0)
+            {
+                const auto oldestFrame = publishedFrameCount - pendingFrameCount;
+                neededStart =
+                  std::min(neededStart, pendingFrameStarts[oldestFrame % pendingSlotCount]);
+            }
+            samples.discardBefore(neededStart);
 
-        if (globalSamplesOffset + m_settings.oneFftSampleCount > std::visit([](auto&& sampleData) -> size_t { return sampleData.size(); }, sampleData)) {
-            continue;
-        }
+            // samples before the next frame are never read: between the frames without overlap
+            // or of the skipped frames
+            const auto storedEnd = samples.getEndPosition();
+            const auto chunkRemainder = inputChunk.getSampleCount() - inputChunkOffset;
+            if (storedEnd < scheduler.getNextFrameStart())
+            {
+                inputChunkOffset +=
+                  samples.skip(std::min(scheduler.getNextFrameStart() - storedEnd, chunkRemainder));
+            }
+            inputChunkOffset +=
+              samples.append(inputChunk.getChannelSampleData(0), inputChunkOffset);
+
+            const auto arrivedEnd =
+              samples.getEndPosition() + inputChunk.getSampleCount() - inputChunkOffset;
+            // frames waiting for the FFT or for the heatmap are a part of the backlog
+            const auto frame = scheduler.getNextFrame(
+              arrivedEnd, pendingFrameCount + m_calculatedColumns.getQueuedSlotCount());
+            if (!frame)
+            {
+                break;
+            }
 
-        // create input data for FFT
-        float* inputData = new float[m_settings.oneFftSampleCount];
-        size_t globalIndex = globalSamplesOffset;
+            if (samples.getEndPosition() < frame->startPosition + m_settings.oneFftSampleCount)
+            {
+                // wait for the FFT to release the samples if the buffer is full
+                if (samples.getEndPosition() == storedEnd)
+                {
+                    break;
+                }
+                continue;
+            }
 
-        std::visit([&](auto&& sampleData) {
-            for (size_t i = 0; i < m_settings.oneFftSampleCount; ++i)
+            // the frame stays in the backlog if the FFT doesn't keep up
+            const auto inputFrame = m_pendingFrames.tryClaim();
+            if (!inputFrame)
             {
-                inputData[i] = (float)sampleData[globalIndex++];
+                break;
             }
-        }, sampleData);
 
-        {
-            std::lock_guard lock{ m_mutex };
-            m_pendingDatas.push(PendingData{ columnIndex, inputData });
+            inputFrame->frameIndex = frame->index;
+            inputFrame->sharedValues =
+              samples.getView(frame->startPosition, m_settings.oneFftSampleCount).data();
+            pendingFrameStarts[publishedFrameCount % pendingSlotCount] = frame->startPosition;
+            m_pendingFrames.publish();
+            ++publishedFrameCount;
+
+            scheduler.onFrameProduced();
+            isProduced = true;
         }
 
-        ++columnIndex;
-        globalSamplesOffset += oneFftSamplesOffset;
+        if (!isProduced)
+        {
+            std::this_thread::sleep_for(IdleWaitTime);
+        }
     }
 }
 }
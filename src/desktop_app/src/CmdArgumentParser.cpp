@@ -7,6 +7,7 @@
 #include <format>
 #include <string>
 #include <cstring>
+#include <cstdlib>
 
 #include <stdarg.hpp>
 
@@ -17,11 +18,111 @@ constexpr const char* fft_power_options[]  = { "--fft-size-power", "-p" };
 constexpr const char* cps_options[]        = { "--cps",            "-c" };
 constexpr const char* backend_options[]    = { "--backend",        "-b" };
 constexpr const char* frontend_options[]   = { "--frontend",       "-f" };
+constexpr const char* device_options[]     = { "--device",         "-d" };
+constexpr const char* multi_device_options[] = { "--multi-device", "-m" };
+constexpr const char* profile_options[]    = { "--profile",        "-r" };
+constexpr const char* rtsa_mode_options[]  = { "--rtsa-mode",      "-a" };
+constexpr const char* rtsa_storage_options[] = { "--rtsa-storage", "-s" };
+constexpr const char* trace_average_options[] = { "--trace-average", "-t" };
+constexpr const char* rtsa_resolution_options[] = { "--rtsa-resolution", "-g" };
+constexpr const char* occupancy_threshold_options[] = { "--occupancy-threshold", "-o" };
+constexpr const char* overload_policy_options[] = { "--overload-policy", "-w" };
+constexpr const char* max_latency_options[] = { "--max-latency", "-l" };
+constexpr const char* overlap_options[] = { "--overlap", "-e" };
+constexpr const char* record_options[] = { "--record", "-k" };
+constexpr const char* waterfall_storage_options[] = { "--waterfall-storage", "-q" };
 
 namespace spectr::desktop_app
 {
 namespace
 {
+calc_opencl::RtsaUpdateMode parseRtsaUpdateMode(const std::string& str)
+{
+    if (str == "gather")
+    {
+        return calc_opencl::RtsaUpdateMode::Gather;
+    }
+    if (str == "scatter")
+    {
+        return calc_opencl::RtsaUpdateMode::Scatter;
+    }
+    if (str == "incremental")
+    {
+        return calc_opencl::RtsaUpdateMode::Incremental;
+    }
+    if (str == "decay")
+    {
+        return calc_opencl::RtsaUpdateMode::ExponentialDecay;
+    }
+    throw utils::Exception("Unknown RTSA mode: {}, expected gather, scatter, incremental or decay.", str);
+}
+
+utils::RtsaStorageFormat parseRtsaStorageFormat(const std::string& str)
+{
+    if (str == "float2")
+    {
+        return utils::RtsaStorageFormat::Float2;
+    }
+    if (str == "unorm16")
+    {
+        return utils::RtsaStorageFormat::Unorm16x2;
+    }
+    throw utils::Exception("Unknown RTSA storage format: {}, expected float2 or unorm16.", str);
+}
+
+utils::ValueFormat parseWaterfallStorageFormat(const std::string& str)
+{
+    if (str == "float")
+    {
+        return utils::ValueFormat::Float32;
+    }
+    if (str == "db16")
+    {
+        return utils::ValueFormat::Decibel16;
+    }
+    if (str == "db8")
+    {
+        return utils::ValueFormat::Decibel8;
+    }
+    throw utils::Exception("Unknown waterfall storage format: {}, expected float, db16 or db8.", str);
+}
+
+audio_loader::FrameOverloadPolicy parseFrameOverloadPolicy(const std::string& str)
+{
+    if (str == "drop")
+    {
+        return audio_loader::FrameOverloadPolicy::DropOldest;
+    }
+    if (str == "decimate")
+    {
+        return audio_loader::FrameOverloadPolicy::Decimate;
+    }
+    if (str == "block")
+    {
+        return audio_loader::FrameOverloadPolicy::BlockSource;
+    }
+    throw utils::Exception("Unknown overload policy: {}, expected drop, decimate or block.", str);
+}
+
+float parseOverlap(const std::string& str)
+{
+    char* parsedEnd = nullptr;
+    const auto value = std::strtof(str.c_str(), &parsedEnd);
+
+    if (parsedEnd != str.c_str() + str.size())
+    {
+        throw utils::Exception("Failed to parse the frame overlap: {}", str);
+    }
+
+    // NaN fails the comparisons as well
+    if (!(value >= 0.0f && value < 1.0f))
+    {
+        throw utils::Exception("Frame overlap must be in [0, 1), got {}.", str);
+    }
+
+    return value;
+}
+
 size_t parseNumber(const char* str)
 {
     const char* fftPowerOfTwoStrEnd = str + std::strlen(str);
@@ -53,18 +154,58 @@ DesktopAppSettings CmdArgumentParser::parse(int argc, const char* argv[])
     stdarg::arg_parser parser({ (size_t)argc, argv }, "Spectr tool for signal spectrum analysis");
 
     std::string path;
+    std::string rtsaMode;
+    std::string rtsaStorage;
+    std::string overloadPolicy;
+    std::string recordPath;
+    std::string waterfallStorage;
+    std::string overlap;
     
     parser << stdarg::option<void()>({        help_options[0],       help_options[1]       }, "show help message", [parser]() { stdarg::arg_parser::help(parser); })
            << stdarg::option<void()>({        version_options[0],    version_options[1]    }, "show tool version", [&]() { settings.command = Command::PrintVersion; })
            << stdarg::argument<std::string>({ input_path_options[0], input_path_options[1] }, "path of input signal WAV audio file", "path", path)
            << stdarg::argument<size_t>({      fft_power_options[0],  fft_power_options[1]  }, "power P of 2 of the FFT size - 2^P.", "P", fftSizePowerOfTwo)
            << stdarg::argument<size_t>({      cps_options[0],        cps_options[1]        }, "FFT calculations per second", "cps", settings.fftCalculationPerSecond)
+           << stdarg::argument<std::string>({ overlap_options[0],    overlap_options[1]    }, "share of a frame overlapped by the next one, in [0, 1), sets the frame rate instead of --cps", "overlap", overlap)
+           << stdarg::argument<std::string>({ device_options[0],     device_options[1]     }, "OpenCL device: platform:device indices, type (gpu/cpu) or a part of the name", "device", settings.openclDevice)
+           << stdarg::option<void()>({        multi_device_options[0], multi_device_options[1] }, "split FFT calculations between all OpenCL devices", [&]() { settings.useAllOpenclDevices = true; })
+           << stdarg::option<void()>({        profile_options[0],    profile_options[1]    }, "show execution times of OpenCL kernels and transfers", [&]() { settings.enableOpenclProfiling = true; })
+           << stdarg::argument<std::string>({ rtsa_mode_options[0],  rtsa_mode_options[1]  }, "RTSA persistence mode (gather/scatter/incremental/decay)", "mode", rtsaMode)
+           << stdarg::argument<std::string>({ rtsa_storage_options[0], rtsa_storage_options[1] }, "RTSA heatmap cell format (float2/unorm16)", "format", rtsaStorage)
+           << stdarg::argument<size_t>({      trace_average_options[0], trace_average_options[1] }, "count of frames in the average spectrum trace", "N", settings.spectrumTraceAverageFrameCount)
+           << stdarg::argument<size_t>({      rtsa_resolution_options[0], rtsa_resolution_options[1] }, "RTSA magnitude axis cells at full detail, coarser levels are used when zoomed out", "N", settings.rtsaMagnitudeResolution)
+           << stdarg::argument<float>({       occupancy_threshold_options[0], occupancy_threshold_options[1] }, "spectral occupancy threshold in dBFS, a frequency bin above it is occupied", "dBFS", settings.occupancyThresholdDbfs)
+           << stdarg::argument<std::string>({ overload_policy_options[0], overload_policy_options[1] }, "what to do with frames the FFT doesn't keep up with (drop/decimate/block)", "policy", overloadPolicy)
+           << stdarg::argument<float>({       max_latency_options[0], max_latency_options[1] }, "seconds of frames the FFT may lag behind the input before the overload policy applies", "seconds", settings.maxFrameLatency)
+           << stdarg::argument<std::string>({ record_options[0],     record_options[1]     }, "path of a spectrogram storage file to record the waterfall to", "path", recordPath)
+           << stdarg::argument<std::string>({ waterfall_storage_options[0], waterfall_storage_options[1] }, "waterfall value format (float/db16/db8), the decibel formats keep 2-4 times longer history", "format", waterfallStorage)
            /*<< stdarg::argument<std::string>({ backend_options[0],    backend_options[1]    }, "chooses a backend to use (cpu/cuda/opencl)", "backend", settings.backend)*/
            /*<< stdarg::argument<std::string>({ frontend_options[0],   frontend_options[1]   }, "chooses a frontend to use (opengl)", "frontend", settings.frontend)*/;
 
     parser();
 
     if (path != "") settings.audioFilePath = path;
+    if (rtsaMode != "") settings.rtsaUpdateMode = parseRtsaUpdateMode(rtsaMode);
+    if (rtsaStorage != "") settings.rtsaStorageFormat = parseRtsaStorageFormat(rtsaStorage);
+    if (overloadPolicy != "") settings.frameOverloadPolicy = parseFrameOverloadPolicy(overloadPolicy);
+    if (recordPath != "") settings.recordPath = recordPath;
+    if (waterfallStorage != "") settings.waterfallStorageFormat = parseWaterfallStorageFormat(waterfallStorage);
+    if (overlap != "") settings.overlap = parseOverlap(overlap);
+
+    if (settings.rtsaMagnitudeResolution == 0)
+    {
+        throw utils::Exception("RTSA magnitude resolution can't be zero.");
+    }
+
+    if (settings.maxFrameLatency <= 0.0f)
+    {
+        throw utils::Exception("Max frame latency must be positive.");
+    }
+
+    if (settings.spectrumTraceAverageFrameCount == 0)
+    {
+        throw utils::Exception("Count of frames in the average spectrum trace can't be zero.");
+    }
 
     settings.helpDescription = parser.getDescription();
 
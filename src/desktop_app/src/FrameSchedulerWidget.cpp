@@ -0,0 +1,60 @@
+#include <spectr/desktop_app/FrameSchedulerWidget.h>
+
+#include <spectr/render_gl/GraphicsApi.h>
+
+#include <format>
+
+namespace spectr::desktop_app
+{
+namespace
+{
+const char* toString(audio_loader::FrameOverloadPolicy policy)
+{
+    switch (policy)
+    {
+    case audio_loader::FrameOverloadPolicy::DropOldest:
+        return "drop oldest";
+    case audio_loader::FrameOverloadPolicy::Decimate:
+        return "decimate";
+    case audio_loader::FrameOverloadPolicy::BlockSource:
+        return "block source";
+    }
+    return "unknown";
+}
+}
+
+FrameSchedulerWidget::FrameSchedulerWidget(
+  ImFont* font,
+  std::shared_ptr<audio_loader::FrameScheduler> scheduler)
+  : m_font{ font }
+  , m_scheduler{ std::move(scheduler) }
+{
+}
+
+void FrameSchedulerWidget::render()
+{
+    const auto statistics = m_scheduler->getStatistics();
+    const auto dueFrameCount = statistics.producedFrameCount + statistics.droppedFrameCount;
+    const auto droppedShare =
+      dueFrameCount > 0 ? static_cast<double>(statistics.droppedFrameCount) / dueFrameCount : 0.0;
+
+    ImGui::PushFont(m_font);
+
+    ImGui::Begin("Frame scheduling:", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
+    ImGui::TextUnformatted(std::format("Overload policy: {}", toString(m_scheduler->getPolicy()))
+                             .c_str());
+    ImGui::TextUnformatted(std::format("Produced: {}", statistics.producedFrameCount).c_str());
+    ImGui::TextUnformatted(std::format("Dropped: {} ({:.1f}%)",
+                                       statistics.droppedFrameCount,
+                                       droppedShare * 100.0)
+                             .c_str());
+    ImGui::TextUnformatted(std::format("Late: {}", statistics.lateFrameCount).c_str());
+    ImGui::TextUnformatted(std::format("Backlog: {} / {}",
+                                       statistics.backlogFrameCount,
+                                       m_scheduler->getMaxBacklogFrameCount())
+                             .c_str());
+    ImGui::End();
+
+    ImGui::PopFont();
+}
+}
@@ -2,6 +2,7 @@
 
 #include <spectr/utils/Assert.h>
 
+#include <algorithm>
 #include <chrono>
 #include <thread>
 #include <vector>
@@ -75,26 +76,11 @@ void MockTimeFrequencyWorker::addNextColumn(const std::vector<float>& values)
 {
     ASSERT(values.size() == m_settings.columnHeight);
 
-    // TODO use OpenGL wrapper/adapter ?
     auto container = m_settings.heatmapContainer;
-    auto buffer = container->getOrAllocateBuffer(m_nextColumnIndex);
-
-    const auto columnSizeBytes = m_settings.columnHeight * sizeof(float);
-    const auto offsetColumns = m_nextColumnIndex - buffer.startColumn;
-    const auto offsetBytes = offsetColumns * columnSizeBytes;
-
-    const auto dataSize = values.size() * sizeof(float);
-
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer.ssbo);
-    GLvoid* p = glMapBufferRange(GL_SHADER_STORAGE_BUFFER, offsetBytes, dataSize, GL_MAP_WRITE_BIT);
-    memcpy(p, values.data(), dataSize);
-    glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
-
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    container->addColumn(m_nextColumnIndex, values.data());
 
     const auto maxValue = std::max_element(values.begin(), values.end());
     container->tryUpdateMaxValue(*maxValue);
-    container->setLastFilledColumn(m_nextColumnIndex);
 
     // apply values to RTSA density heatmap 
     
@@ -0,0 +1,62 @@
+#include <spectr/desktop_app/OpenclProfilingWidget.h>
+
+#include <spectr/render_gl/GraphicsApi.h>
+
+#include <format>
+
+namespace spectr::desktop_app
+{
+namespace
+{
+constexpr int ColumnCount = 6;
+}
+
+OpenclProfilingWidget::OpenclProfilingWidget(ImFont* font,
+                                             std::shared_ptr<calc_opencl::OpenclProfiler> profiler)
+  : m_font{ font }
+  , m_profiler{ std::move(profiler) }
+{
+}
+
+void OpenclProfilingWidget::render()
+{
+    const auto statistics = m_profiler->getStatistics();
+
+    ImGui::PushFont(m_font);
+
+    ImGui::Begin("OpenCL profiling:", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
+    if (ImGui::BeginTable("##OpenclStages", ColumnCount, ImGuiTableFlags_Borders))
+    {
+        ImGui::TableSetupColumn("Stage");
+        ImGui::TableSetupColumn("Last, ms");
+        ImGui::TableSetupColumn("Avg, ms");
+        ImGui::TableSetupColumn("Min, ms");
+        ImGui::TableSetupColumn("Max, ms");
+        ImGui::TableSetupColumn("Share");
+        ImGui::TableHeadersRow();
+
+        for (const auto& stage : statistics)
+        {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(stage.name.c_str());
+            for (const auto value : { stage.lastMs, stage.averageMs, stage.minMs, stage.maxMs })
+            {
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(std::format("{:.3f}", value).c_str());
+            }
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(std::format("{:.1f}%", stage.fractionOfTotal * 100.0).c_str());
+        }
+        ImGui::EndTable();
+    }
+
+    if (ImGui::Button("Reset"))
+    {
+        m_profiler->reset();
+    }
+    ImGui::End();
+
+    ImGui::PopFont();
+}
+}
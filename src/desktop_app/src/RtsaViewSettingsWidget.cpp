@@ -2,10 +2,18 @@
 
 namespace spectr::desktop_app
 {
+namespace
+{
+constexpr float MinPersistenceTime = 0.05f;
+constexpr float MaxPersistenceTime = 60.0f;
+}
+
 RtsaViewSettingsWidget::RtsaViewSettingsWidget(ImFont* font,
                                                RtsaViewSettingsWidgetSettings settings)
   : m_font{ font }
   , m_settings{ std::move(settings) }
+  , m_persistenceTime{ m_settings.persistenceTime }
+  , m_traceVisibilities(m_settings.traceNames.size(), true)
 {
 }
 
@@ -14,7 +22,43 @@ void RtsaViewSettingsWidget::render(const render_gl::RenderContext& renderContex
     ImGui::PushFont(m_font);
     ImGui::Begin("Signal density view settings", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
 
-    ImGui::Text("Placeholder.");
+    if (m_settings.onPersistenceTimeChanged)
+    {
+        ImGui::Text("Persistence, s");
+        ImGui::SameLine();
+        if (ImGui::SliderFloat("##Persistence",
+                               &m_persistenceTime,
+                               MinPersistenceTime,
+                               MaxPersistenceTime,
+                               "%.2f",
+                               ImGuiSliderFlags_Logarithmic))
+        {
+            m_settings.onPersistenceTimeChanged(m_persistenceTime);
+        }
+    }
+    else if (m_settings.traceNames.empty())
+    {
+        ImGui::Text("Placeholder.");
+    }
+
+    if (!m_settings.traceNames.empty())
+    {
+        ImGui::Text("Spectrum traces");
+        for (size_t i = 0; i < m_settings.traceNames.size(); ++i)
+        {
+            bool isVisible = m_traceVisibilities[i];
+            if (ImGui::Checkbox(m_settings.traceNames[i].c_str(), &isVisible))
+            {
+                m_traceVisibilities[i] = isVisible;
+                m_settings.onTraceVisibilityChanged(i, isVisible);
+            }
+        }
+
+        if (m_settings.onTracesReset && ImGui::Button("Reset traces"))
+        {
+            m_settings.onTracesReset();
+        }
+    }
 
     /*renderComboBox("Frequency axis scale:",
                    FrequencyAxisScales,
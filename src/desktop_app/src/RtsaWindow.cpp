@@ -2,8 +2,10 @@
 
 #include <spectr/desktop_app/CameraBoundsController.h>
 #include <spectr/desktop_app/RtsaViewSettingsWidget.h>
+#include <spectr/calc_cpu/SpectrumTraces.h>
 #include <spectr/utils/Asset.h>
 
+#include <cmath>
 #include <format>
 
 using namespace std::placeholders;
@@ -11,9 +13,15 @@ using namespace std::placeholders;
 namespace spectr::desktop_app
 {
 RtsaWindow::RtsaWindow(std::shared_ptr<Input> input,
-                       std::shared_ptr<render_gl::RtsaContainer> container)
+                       std::shared_ptr<render_gl::RtsaContainer> container,
+                       std::function<void(float)> onPersistenceTimeChanged,
+                       float persistenceTime,
+                       std::shared_ptr<render_gl::SpectrumTraceContainer> spectrumTraces,
+                       std::function<void()> onSpectrumTracesReset,
+                       std::function<void(size_t)> onLevelChanged)
   : m_input{ input }
   , m_container{ container }
+  , m_onLevelChanged{ std::move(onLevelChanged) }
 {
     // create fonts
     ImGuiIO& io = ImGui::GetIO();
@@ -41,6 +49,21 @@ RtsaWindow::RtsaWindow(std::shared_ptr<Input> input,
     m_rtsaRenderer = std::make_shared<render_gl::RtsaRenderer>(m_container);
     m_onRenderActions.push_back(std::bind(&render_gl::RtsaRenderer::render, m_rtsaRenderer, _1));
 
+    std::vector<std::string> traceNames;
+    if (spectrumTraces)
+    {
+        m_spectrumTraceRenderer =
+          std::make_shared<render_gl::SpectrumTraceRenderer>(spectrumTraces);
+        m_onRenderActions.push_back(
+          std::bind(&render_gl::SpectrumTraceRenderer::render, m_spectrumTraceRenderer, _1));
+
+        for (size_t i = 0; i < spectrumTraces->getSettings().traceCount; ++i)
+        {
+            const auto type = static_cast<calc_cpu::SpectrumTraceType>(i);
+            traceNames.emplace_back(calc_cpu::getSpectrumTraceName(type));
+        }
+    }
+
     // create axis
     recreateAxis();
 
@@ -90,7 +113,14 @@ RtsaWindow::RtsaWindow(std::shared_ptr<Input> input,
             // TODO implement
             // m_rtsaRenderer->setFrequencyAxisScale(frequencyAxisScale);
             // recreateAxis();
-        }
+        },
+        .onPersistenceTimeChanged = std::move(onPersistenceTimeChanged),
+        .persistenceTime = persistenceTime,
+        .traceNames = std::move(traceNames),
+        .onTraceVisibilityChanged =
+          [this](size_t traceIndex, bool isVisible)
+        { m_spectrumTraceRenderer->setTraceVisible(traceIndex, isVisible); },
+        .onTracesReset = std::move(onSpectrumTracesReset),
     };
 
     m_rtsaViewSettingsWidget =
@@ -149,6 +179,8 @@ void RtsaWindow::onMainLoopUpdate()
     {
         action();
     }
+
+    updateLevelOfDetail();
 }
 
 void RtsaWindow::onBeforeRender()
@@ -173,6 +205,30 @@ void RtsaWindow::onAfterRender()
     m_panTool->update();
 }
 
+void RtsaWindow::updateLevelOfDetail()
+{
+    if (!m_onLevelChanged)
+    {
+        return;
+    }
+
+    const auto viewportHeight = static_cast<float>(getHeight());
+    const auto top = m_renderContext->pixelToWorld({ 0, 0 });
+    const auto bottom = m_renderContext->pixelToWorld({ 0, getHeight() });
+    const auto visibleDecibelRange = std::abs(top.y - bottom.y);
+
+    const auto& settings = m_container->getSettings();
+    const auto level = render_gl::selectRtsaLevel(settings.magnitudeRangeValuesCount,
+                                                  settings.magnitudeDecibelRange,
+                                                  visibleDecibelRange,
+                                                  viewportHeight);
+    if (level != m_requestedLevel)
+    {
+        m_requestedLevel = level;
+        m_onLevelChanged(level);
+    }
+}
+
 void RtsaWindow::recreateAxis()
 {
     m_axes.clear();
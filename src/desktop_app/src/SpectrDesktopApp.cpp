@@ -3,8 +3,10 @@
 #include <spectr/audio_loader/AudioLoader.h>
 #include <spectr/audio_loader/SignalDataGenerator.h>
 #include <spectr/calc_opencl/FftCooleyTukeyRadix2CL.h>
+#include <spectr/calc_opencl/MultiDeviceFftScheduler.h>
 #include <spectr/calc_opencl/OpenclApi.h>
 #include <spectr/calc_opencl/OpenclManager.h>
+#include <spectr/calc_opencl/OpenglRtsaHeatmapSink.h>
 #include <spectr/calc_opencl/RtsaUpdater.h>
 #include <spectr/desktop_app/AudioFileTimeFrequencyWorker.h>
 #include <spectr/desktop_app/CmdArgumentParser.h>
@@ -13,6 +15,7 @@
 #include <spectr/utils/Asset.h>
 #include <spectr/utils/Assert.h>
 #include <spectr/utils/Exception.h>
+#include <spectr/storage/SpectrogramStorageWriter.h>
 #include <spectr/utils/Version.h>
 #include <spectr/real_time_input/FileInput.h>
 #include <spectr/real_time_input/RealTimeInputPortAudio.h>
@@ -20,6 +23,8 @@
 
 // #include <spdlog/spdlog.h>
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <limits>
 
@@ -30,6 +35,7 @@ namespace
 constexpr auto DefaultWindowWidth = 1920;
 constexpr auto DefaultWindowHeight = 1080;
 const auto WindowTitle = "Spectrogram renderer";
+constexpr size_t HeatmapLevelCount = 10; // the coarsest level has 2^9 times less columns
 
 std::vector<cl_context_properties> getOpenCLContextProperties(GLFWwindow* window)
 {
@@ -51,6 +57,21 @@ std::vector<cl_context_properties> getOpenCLContextProperties(GLFWwindow* window
     return openclContextProperties;
 }
 
+/**
+ * @brief Returns count of samples between the starts of the following frames, given by the
+ * overlap of the frames if it's set, otherwise by the FFT calculations per second.
+ */
+size_t getFrameHop(const DesktopAppSettings& settings, size_t sampleRate)
+{
+    if (settings.overlap)
+    {
+        const auto hop = std::round(settings.fftSize * (1.0f - *settings.overlap));
+        return std::max<size_t>(static_cast<size_t>(hop), 1);
+    }
+
+    return std::max<size_t>(sampleRate / settings.fftCalculationPerSecond, 1);
+}
+
 DesktopAppSettings parseCommandLineArguments(int argc, const char* argv[])
 {
     constexpr bool HardcodeInput = true;
@@ -161,10 +182,44 @@ int SpectrDesktopApp::mainImpl(int argc, const char* argv[])
             break;
     }
 
+    m_frameHop = getFrameHop(settings, m_inputSource->getSampleRate());
+    m_framesInSecond =
+      static_cast<float>(m_inputSource->getSampleRate()) / static_cast<float>(m_frameHop);
+    std::cout << "Frame hop: " << m_frameHop << " samples, " << m_framesInSecond
+              << " frames per second" << std::endl;
+
     initGraphics();
     initFftCalculator(settings);
     m_waterfallWindow = std::make_unique<WaterfallWindow>(m_input, m_timeFrequencyHeatmapContainer, m_inputSource->getFrequencyOffset());
-    m_rtsaWindow = std::make_unique<RtsaWindow>(m_input, m_rtsaHeatmapContainer);
+    std::function<void()> onSpectrumTracesReset;
+    if (m_spectrumTraceUpdater)
+    {
+        onSpectrumTracesReset = [spectrumTraceUpdater = m_spectrumTraceUpdater]()
+        { spectrumTraceUpdater->reset(); };
+    }
+
+    std::function<void(float)> onPersistenceTimeChanged;
+    if (m_rtsaUpdater && m_rtsaUpdater->getMode() == calc_opencl::RtsaUpdateMode::ExponentialDecay)
+    {
+        const auto framesInSecond = m_framesInSecond;
+        onPersistenceTimeChanged = [rtsaUpdater = m_rtsaUpdater, framesInSecond](float time)
+        { rtsaUpdater->setPersistence(time * framesInSecond); };
+    }
+
+    std::function<void(size_t)> onRtsaLevelChanged;
+    if (m_rtsaUpdater)
+    {
+        onRtsaLevelChanged = [rtsaUpdater = m_rtsaUpdater](size_t level)
+        { rtsaUpdater->setLevel(level); };
+    }
+
+    m_rtsaWindow = std::make_unique<RtsaWindow>(m_input,
+                                                m_rtsaHeatmapContainer,
+                                                std::move(onPersistenceTimeChanged),
+                                                settings.rtsaPersistenceTime,
+                                                m_spectrumTraceContainer,
+                                                std::move(onSpectrumTracesReset),
+                                                std::move(onRtsaLevelChanged));
     m_splitWindow = std::make_unique<SplitWindow>(m_input, m_timeFrequencyHeatmapContainer, m_rtsaHeatmapContainer);
     m_currentWindow = m_waterfallWindow;
 
@@ -173,6 +228,19 @@ int SpectrDesktopApp::mainImpl(int argc, const char* argv[])
     const auto uiFontPath = utils::Asset::getPath(UIFontAssetPath).string();
     auto uiFont = io.Fonts->AddFontFromFileTTF(uiFontPath.c_str(), 20.0f);
     m_fpsGuard = std::make_unique<render_gl::FpsGuard>(uiFont);
+    if (m_openclProfiler)
+    {
+        m_openclProfilingWidget = std::make_unique<OpenclProfilingWidget>(uiFont, m_openclProfiler);
+    }
+    if (m_spectralOccupancyUpdater)
+    {
+        m_spectralOccupancyWidget = std::make_unique<SpectralOccupancyWidget>(
+          uiFont, m_spectralOccupancyUpdater, m_spectralOccupancyWidgetSettings);
+    }
+    if (m_frameScheduler)
+    {
+        m_frameSchedulerWidget = std::make_unique<FrameSchedulerWidget>(uiFont, m_frameScheduler);
+    }
 
     glfwShowWindow(m_window);
     while (!glfwWindowShouldClose(m_window))
@@ -207,6 +275,18 @@ int SpectrDesktopApp::mainImpl(int argc, const char* argv[])
         m_currentWindow->onRender();
 
         m_fpsGuard->onRender();
+        if (m_openclProfilingWidget)
+        {
+            m_openclProfilingWidget->render();
+        }
+        if (m_spectralOccupancyWidget)
+        {
+            m_spectralOccupancyWidget->render();
+        }
+        if (m_frameSchedulerWidget)
+        {
+            m_frameSchedulerWidget->render();
+        }
 
         ImGui::Render();
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
@@ -275,10 +355,12 @@ void SpectrDesktopApp::initFftCalculator(const DesktopAppSettings& settings)
 {
     auto frequenciesCount = settings.fftSize / 2;
 
-    const auto waterfallHistoryTime = 300.0f; // 5 minutes
+    // 5 minutes of float magnitudes, the decibel formats keep longer history in the same memory
+    const auto waterfallHistoryTime =
+      300.0f * sizeof(float) / utils::getValueSize(settings.waterfallStorageFormat);
     const auto singleBufferColumnCount = 10;
     const auto maxBufferCount = static_cast<size_t>(
-      (waterfallHistoryTime * settings.fftCalculationPerSecond) / singleBufferColumnCount);
+      (waterfallHistoryTime * m_framesInSecond) / singleBufferColumnCount);
 
     constexpr bool UseMockDataWorker = false;
     if (UseMockDataWorker)
@@ -294,6 +376,11 @@ void SpectrDesktopApp::initFftCalculator(const DesktopAppSettings& settings)
             .columnHeightElementCount = frequencyRangeSize,
             .singleBufferColumnCount = singleBufferColumnCount,
             .maxBuffersCount = 1000,
+            .levelCount = HeatmapLevelCount,
+            .storageFormat = settings.waterfallStorageFormat,
+            .minDecibels = 0.0f,
+            // the mock magnitudes are below twice the column height
+            .maxDecibels = 20.0f * std::log10(2.0f * frequencyRangeSize),
         };
         m_timeFrequencyHeatmapContainer =
           std::make_shared<render_gl::TimeFrequencyHeatmapContainer>(heatmapContainerSettings);
@@ -315,7 +402,12 @@ void SpectrDesktopApp::initFftCalculator(const DesktopAppSettings& settings)
     else
     {
         const auto openglContextProperties = getOpenCLContextProperties(m_window);
-        auto openclManager = std::make_shared<calc_opencl::OpenclManager>(openglContextProperties);
+        const calc_opencl::OpenclDeviceSelectionSettings deviceSelectionSettings{
+            .calibrationFftSize = settings.fftSize,
+            .deviceOverride = settings.openclDevice,
+        };
+        auto openclManager = std::make_shared<calc_opencl::OpenclManager>(
+          openglContextProperties, deviceSelectionSettings);
 
         // const auto audioData =
         //   //
@@ -338,7 +430,7 @@ void SpectrDesktopApp::initFftCalculator(const DesktopAppSettings& settings)
         // 
         // ASSERT(audioData.getSampleDataType() == audio_loader::SampleDataType::Int16);
 
-        const auto columnsInOneSecond = settings.fftCalculationPerSecond;
+        const auto columnsInOneSecond = m_framesInSecond;
 
         const auto fftFrequencyRatio =
           static_cast<float>(m_inputSource->getSampleRate()) / settings.fftSize;
@@ -347,55 +439,155 @@ void SpectrDesktopApp::initFftCalculator(const DesktopAppSettings& settings)
 
         const auto frequencyOffset = -fftFrequencyRatio / 2.0f;
 
+        if (settings.enableOpenclProfiling)
+        {
+            m_openclProfiler = std::make_shared<calc_opencl::OpenclProfiler>();
+        }
+
         auto fftCalculator = std::make_unique<calc_opencl::FftCooleyTukeyRadix2>(
-          openclManager->getContext(), settings.fftSize);
+          openclManager->getContext(), settings.fftSize, m_openclProfiler);
+
+        std::shared_ptr<calc_opencl::MultiDeviceFftScheduler> fftScheduler;
+        if (settings.useAllOpenclDevices && openclManager->getRankedDevices().size() > 1)
+        {
+            fftScheduler = std::make_shared<calc_opencl::MultiDeviceFftScheduler>(
+              openclManager->getRankedDevices(), settings.fftSize, m_openclProfiler);
+        }
+
+        // decibel range of the quantized waterfall and recording: from the magnitude of one
+        // sample unit to the full scale magnitude of 32-bit samples
+        const auto minMagnitudeDecibels = 0.0f;
+        const auto maxMagnitudeDecibels =
+          20.0f * std::log10(std::pow(2.0f, 31.0f) * settings.fftSize);
 
         // create spectrogram container
         render_gl::TimeFrequencyHeatmapContainerSettings heatmapContainerSettings{
             .frequencyOffset = frequencyOffset,
             .valuesInOneHertz = valuesPerHertzUnit,
-            .columnsInOneSecond = static_cast<float>(columnsInOneSecond),
+            .columnsInOneSecond = columnsInOneSecond,
             .columnHeightElementCount = frequenciesCount,
             .singleBufferColumnCount = singleBufferColumnCount,
             .maxBuffersCount = maxBufferCount,
+            .levelCount = HeatmapLevelCount,
+            .storageFormat = settings.waterfallStorageFormat,
+            .minDecibels = minMagnitudeDecibels,
+            .maxDecibels = maxMagnitudeDecibels,
         };
         m_timeFrequencyHeatmapContainer =
           std::make_shared<render_gl::TimeFrequencyHeatmapContainer>(heatmapContainerSettings);
 
-        const auto magnitudeDbfsRange = 96.0f;       // for 16-bit signal
-        const auto magnitudeRangeValuesCount = 1024; // empiric arbitrary value;
-         
+        const auto magnitudeDbfsRange = 96.0f; // for 16-bit signal
+
         // RTSA
         const render_gl::RtsaContainerSettings rtsaContainerSettings{
             .frequencyValuesCount = frequenciesCount,
             .magnitudeDecibelRange = magnitudeDbfsRange,
-            .magnitudeRangeValuesCount = magnitudeRangeValuesCount,
+            .magnitudeRangeValuesCount = settings.rtsaMagnitudeResolution,
             .valuesInOneHertz = valuesPerHertzUnit,
+            .storageFormat = settings.rtsaStorageFormat,
         };
         m_rtsaHeatmapContainer = std::make_shared<render_gl::RtsaContainer>(rtsaContainerSettings);
 
-        const auto rtsaHistoryDuration = 4.0f; // hardcoded empiric value, can be changed
         const auto rtsaHistoryBufferCount =
-          static_cast<size_t>(settings.fftCalculationPerSecond * rtsaHistoryDuration);
+          static_cast<size_t>(m_framesInSecond * settings.rtsaPersistenceTime);
 
-        auto rtsaUpdater = std::make_unique<calc_opencl::RtsaUpdater>(
+        m_rtsaUpdater = std::make_shared<calc_opencl::RtsaUpdater>(
           openclManager->getContext(),
           rtsaContainerSettings.frequencyValuesCount,
           rtsaContainerSettings.magnitudeRangeValuesCount,
           rtsaHistoryBufferCount,
           magnitudeDbfsRange,
-          rtsaContainerSettings.frequencyValuesCount * rtsaContainerSettings.magnitudeRangeValuesCount * sizeof(float) * 2);
+          rtsaContainerSettings.getBufferSize(),
+          settings.rtsaUpdateMode,
+          rtsaContainerSettings.storageFormat,
+          m_openclProfiler);
+
+        // the heatmap stays on the device if OpenCL shares the OpenGL context
+        auto rtsaHeatmapSink =
+          calc_opencl::createOpenglRtsaHeatmapSink(openclManager->getContext(),
+                                                   openclManager->hasAdditionalProperties(),
+                                                   m_rtsaHeatmapContainer->getBuffer(),
+                                                   rtsaContainerSettings.getBufferSize());
+
+        // spectrum traces over the RTSA view, calculated from the dBFS values of the RTSA
+        const render_gl::SpectrumTraceContainerSettings spectrumTraceContainerSettings{
+            .frequencyValuesCount = frequenciesCount,
+            .traceCount = calc_cpu::SpectrumTraceCount,
+            .valuesInOneHertz = valuesPerHertzUnit,
+            .magnitudeDecibelRange = magnitudeDbfsRange,
+        };
+        m_spectrumTraceContainer =
+          std::make_shared<render_gl::SpectrumTraceContainer>(spectrumTraceContainerSettings);
+        m_spectrumTraceUpdater = std::make_shared<calc_opencl::SpectrumTraceUpdater>(
+          openclManager->getContext(),
+          frequenciesCount,
+          settings.spectrumTraceAverageFrameCount,
+          settings.spectrumTraceAverageMode,
+          m_openclProfiler);
+        auto spectrumTraceSink =
+          calc_opencl::createOpenglRtsaHeatmapSink(openclManager->getContext(),
+                                                   openclManager->hasAdditionalProperties(),
+                                                   m_spectrumTraceContainer->getBuffer(),
+                                                   spectrumTraceContainerSettings.getBufferSize());
+
+        // spectral occupancy statistics, updated from the dBFS values of the RTSA
+        m_spectralOccupancyUpdater = std::make_shared<calc_opencl::SpectralOccupancyUpdater>(
+          openclManager->getContext(),
+          frequenciesCount,
+          settings.occupancyThresholdDbfs,
+          settings.occupancyDutyCycleFrameCount,
+          m_openclProfiler);
+        // the frequency offset of the heatmaps only centers the bins when drawn
+        m_spectralOccupancyWidgetSettings = SpectralOccupancyWidgetSettings{
+            .firstBinFrequency = static_cast<float>(m_inputSource->getFrequencyOffset()),
+            .binWidth = fftFrequencyRatio,
+            .frameDuration = 1.0f / m_framesInSecond,
+            .csvPath = "spectral_occupancy.csv",
+        };
+
+        // frames are cut by the sample clock, the backlog above the max latency is handled by
+        // the overload policy
+        const auto maxBacklogFrameCount = std::max<size_t>(
+          static_cast<size_t>(settings.maxFrameLatency * m_framesInSecond), 1);
+        m_frameScheduler = std::make_shared<audio_loader::FrameScheduler>(
+          settings.fftSize, maxBacklogFrameCount, settings.frameOverloadPolicy);
+
+        // the calculated columns are recorded as they come, the waterfall keeps only the latest
+        std::shared_ptr<storage::SpectrogramStorageWriter> spectrogramWriter;
+        if (!settings.recordPath.empty())
+        {
+            spectrogramWriter = std::make_shared<storage::SpectrogramStorageWriter>(
+              settings.recordPath,
+              storage::SpectrogramStorageSettings{
+                .binCount = settings.fftSize / 2,
+                .fftSize = settings.fftSize,
+                .hop = m_frameHop,
+                .sampleRate = static_cast<size_t>(m_inputSource->getSampleRate()),
+                .valueFormat = settings.recordValueFormat,
+                .minDecibels = minMagnitudeDecibels,
+                .maxDecibels = maxMagnitudeDecibels,
+              });
+        }
 
         // worker
         AudioFileTimeFrequencyWorkerSettings audioFileWorkerSettings{
             .source = m_inputSource,
+            .frameScheduler = m_frameScheduler,
             .oneFftSampleCount = settings.fftSize,
-            .fftCalculationsInSecond = settings.fftCalculationPerSecond,
+            .frameHop = m_frameHop,
+            .framesInSecond = m_framesInSecond,
             .heatmapContainer = m_timeFrequencyHeatmapContainer,
             .rtsaHeatmapContainer = m_rtsaHeatmapContainer,
             .fftCalculator = std::move(fftCalculator),
-            .rtsaUpdater = std::move(rtsaUpdater),
-            .rtsaBufferSize = rtsaContainerSettings.frequencyValuesCount * rtsaContainerSettings.magnitudeRangeValuesCount * sizeof(float) * 2,
+            .fftScheduler = std::move(fftScheduler),
+            .rtsaUpdater = m_rtsaUpdater,
+            .rtsaHeatmapSink = std::move(rtsaHeatmapSink),
+            .spectrumTraceUpdater = m_spectrumTraceUpdater,
+            .spectrumTraceSink = std::move(spectrumTraceSink),
+            .spectralOccupancyUpdater = m_spectralOccupancyUpdater,
+            .openclProfiler = m_openclProfiler,
+            .spectrogramWriter = std::move(spectrogramWriter),
+            .rtsaBufferSize = rtsaContainerSettings.getBufferSize(),
             .fftSize = settings.fftSize
         };
 
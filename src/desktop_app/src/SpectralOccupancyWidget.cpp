@@ -0,0 +1,143 @@
+#include <spectr/desktop_app/SpectralOccupancyWidget.h>
+
+#include <spectr/render_gl/GraphicsApi.h>
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+
+namespace spectr::desktop_app
+{
+namespace
+{
+constexpr int ColumnCount = 4;
+constexpr size_t TopBinCount = 16;
+constexpr float RefreshPeriod = 0.5f; // seconds, the statistics are read by the next frame
+constexpr float MinThresholdDbfs = -96.0f;
+constexpr float MaxThresholdDbfs = 0.0f;
+}
+
+SpectralOccupancyWidget::SpectralOccupancyWidget(
+  ImFont* font,
+  std::shared_ptr<calc_opencl::SpectralOccupancyUpdater> updater,
+  SpectralOccupancyWidgetSettings settings)
+  : m_font{ font }
+  , m_updater{ std::move(updater) }
+  , m_settings{ std::move(settings) }
+  , m_thresholdDbfs{ m_updater->getThreshold() }
+{
+}
+
+void SpectralOccupancyWidget::render()
+{
+    if (!m_isRefreshed || m_refreshTimer.getTime() >= RefreshPeriod)
+    {
+        refresh();
+    }
+
+    ImGui::PushFont(m_font);
+
+    ImGui::Begin("Spectral occupancy:", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
+    if (ImGui::SliderFloat(
+          "Threshold, dBFS", &m_thresholdDbfs, MinThresholdDbfs, MaxThresholdDbfs, "%.1f"))
+    {
+        m_updater->setThreshold(m_thresholdDbfs);
+    }
+
+    const auto observationTime =
+      static_cast<float>(m_updater->getFrameCount()) * m_settings.frameDuration;
+    ImGui::TextUnformatted(std::format("Observed: {:.1f} s", observationTime).c_str());
+
+    if (ImGui::BeginTable("##OccupiedBins", ColumnCount, ImGuiTableFlags_Borders))
+    {
+        ImGui::TableSetupColumn("Frequency, Hz");
+        ImGui::TableSetupColumn("Occupancy");
+        ImGui::TableSetupColumn("Duty cycle");
+        ImGui::TableSetupColumn("Last seen, s");
+        ImGui::TableHeadersRow();
+
+        for (const auto binIndex : m_topBinIndices)
+        {
+            const auto& bin = m_bins[binIndex];
+            const auto frequency =
+              m_settings.firstBinFrequency + static_cast<float>(binIndex) * m_settings.binWidth;
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(std::format("{:.1f}", frequency).c_str());
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(std::format("{:.1f}%", bin.occupancy * 100.0f).c_str());
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(std::format("{:.1f}%", bin.dutyCycle * 100.0f).c_str());
+            ImGui::TableNextColumn();
+            const auto lastSeen = static_cast<float>(bin.framesSinceLastSeen) *
+                                  m_settings.frameDuration;
+            ImGui::TextUnformatted(std::format("{:.2f}", lastSeen).c_str());
+        }
+        ImGui::EndTable();
+    }
+
+    if (ImGui::Button("Export CSV"))
+    {
+        exportCsv();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Reset"))
+    {
+        m_updater->reset();
+    }
+    if (!m_exportStatus.empty())
+    {
+        ImGui::TextUnformatted(m_exportStatus.c_str());
+    }
+    ImGui::End();
+
+    ImGui::PopFont();
+}
+
+void SpectralOccupancyWidget::refresh()
+{
+    // the statistics requested by the previous refresh, the rendering never waits for the device
+    m_updater->requestStatistics();
+    m_bins = m_updater->getLastStatistics();
+    const auto& bins = m_bins;
+
+    // bins never seen are not occupied
+    m_topBinIndices.clear();
+    for (size_t i = 0; i < bins.size(); ++i)
+    {
+        if (bins[i].framesSinceLastSeen != calc_cpu::SpectralOccupancyNeverSeen)
+        {
+            m_topBinIndices.push_back(i);
+        }
+    }
+
+    const auto topBinCount = std::min(TopBinCount, m_topBinIndices.size());
+    std::partial_sort(m_topBinIndices.begin(),
+                      m_topBinIndices.begin() + topBinCount,
+                      m_topBinIndices.end(),
+                      [&bins](size_t left, size_t right)
+                      { return bins[left].occupancy > bins[right].occupancy; });
+    m_topBinIndices.resize(topBinCount);
+
+    m_refreshTimer.restart();
+    m_isRefreshed = true;
+}
+
+void SpectralOccupancyWidget::exportCsv()
+{
+    std::ofstream stream{ m_settings.csvPath };
+    if (!stream)
+    {
+        m_exportStatus = std::format("Failed to open {}", m_settings.csvPath.string());
+        return;
+    }
+
+    calc_cpu::writeSpectralOccupancyCsv(stream,
+                                        m_updater->getStatistics(),
+                                        m_settings.firstBinFrequency,
+                                        m_settings.binWidth,
+                                        m_settings.frameDuration);
+    m_exportStatus = std::format("Exported to {}", m_settings.csvPath.string());
+}
+}
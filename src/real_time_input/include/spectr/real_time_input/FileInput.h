@@ -1,21 +1,22 @@
 #pragma once
 #include <spectr/real_time_input/RealTimeInput.h>
 
-#pragma once
-#include <spectr/real_time_input/RealTimeInput.h>
-
+#include <chrono>
 #include <filesystem>
+#include <optional>
 
 namespace spectr::real_time_input {
     /**
-      * This class reads data from a file.
+      * This class reads data from a file. The samples are returned at the sample rate of the file
+      * since the first call of getSignalData(), as if they were recorded in real time.
       *
       * @see SampledData
       */
     class FileInput : public RealTimeInput {
     private:
         audio_loader::SignalData data;
-        bool read = false;
+        size_t position = 0; // count of the samples already returned
+        std::optional<std::chrono::steady_clock::time_point> start;
 
     public:
         FileInput(const std::filesystem::path& audioFilePath);
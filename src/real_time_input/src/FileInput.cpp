@@ -1,6 +1,9 @@
 #include <spectr/real_time_input/FileInput.h>
 #include <spectr/audio_loader/AudioLoader.h>
 
+#include <algorithm>
+#include <variant>
+
 namespace spectr::real_time_input {
     FileInput::FileInput(const std::filesystem::path& audioFilePath) : data(audio_loader::AudioLoader::load(audioFilePath)) { }
 
@@ -9,13 +12,31 @@ namespace spectr::real_time_input {
     }
 
     audio_loader::SignalData FileInput::getSignalData() noexcept(true) {
-        if (read) {
+        const auto now = std::chrono::steady_clock::now();
+        if (!start) {
+            start = now;
+        }
+
+        // samples "recorded" since the first call
+        const std::chrono::duration<double> elapsed = now - *start;
+        const auto end = std::min(static_cast<size_t>(elapsed.count() * data.getSampleRate()),
+                                  data.getSampleCount());
+        if (end <= position) {
             return { };
         }
 
-        read = true;
+        std::vector<audio_loader::SampleDataVariant> channelsDatas;
+        for (size_t channelIndex = 0; channelIndex < data.getChannelCount(); ++channelIndex) {
+            channelsDatas.push_back(std::visit(
+                [this, end](const auto& samples) -> audio_loader::SampleDataVariant {
+                    using Samples = std::decay_t<decltype(samples)>;
+                    return Samples(samples.begin() + position, samples.begin() + end);
+                },
+                data.getChannelSampleData(channelIndex)));
+        }
+        position = end;
 
-        return data;
+        return { data.getSampleRate(), std::move(channelsDatas) };
     }
 
     int FileInput::getSampleRate() const noexcept(true) {
@@ -2,6 +2,8 @@
 
 #include <spectr/render_gl/GraphicsApi.h>
 #include <spectr/render_gl/OpenGlUtils.h>
+#include <spectr/render_gl/RtsaLevelOfDetail.h>
+#include <spectr/utils/RtsaStorageFormat.h>
 
 namespace spectr::render_gl
 {
@@ -23,13 +25,26 @@ public:
     float magnitudeDecibelRange;
 
     /**
-     * @brief Resolution of the view by height (y coordinate - magnitude axis).
+     * @brief Resolution of the view by height (y coordinate - magnitude axis) at level of
+     * detail 0, see RtsaLevelOfDetail.h.
      */
     size_t magnitudeRangeValuesCount;
 
     float valuesInOneHertz;
 
+    utils::RtsaStorageFormat storageFormat = utils::RtsaStorageFormat::Float2;
+
     float getMaxFrequency() const;
+
+    /**
+     * @brief Returns size of one heatmap cell in bytes.
+     */
+    size_t getCellSize() const;
+
+    /**
+     * @brief Returns size of the heatmap buffer in bytes, enough for every level of detail.
+     */
+    size_t getBufferSize() const;
 };
 
 /**
@@ -47,8 +62,22 @@ public:
 
     const RtsaContainerSettings& getSettings() const;
 
+    /**
+     * @brief Sets level of detail of the values in the buffer: at level L the buffer starts with
+     * frequency count x (resolution >> L) cells.
+     */
+    void setLevel(size_t level);
+
+    size_t getLevel() const;
+
+    /**
+     * @brief Returns count of the magnitude cells of a frequency at the current level.
+     */
+    size_t getLevelResolution() const;
+
 private:
     RtsaContainerSettings m_settings;
+    size_t m_level = 0;
     GLuint m_rtsaHeatmapSsbo = NoBuffer;
 };
 }
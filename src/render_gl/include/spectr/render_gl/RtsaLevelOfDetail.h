@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+
+namespace spectr::render_gl
+{
+/**
+ * @brief Levels of detail of the RTSA magnitude axis. Level 0 has the full magnitude resolution,
+ * every next level halves it while the resolution stays even and not less than
+ * MinRtsaLevelResolution.
+ */
+constexpr size_t MinRtsaLevelResolution = 64;
+
+size_t getRtsaLevelCount(size_t magnitudeResolution);
+
+/**
+ * @brief Returns count of the magnitude cells of a frequency at the level.
+ */
+size_t getRtsaLevelResolution(size_t magnitudeResolution, size_t level);
+
+/**
+ * @brief Returns the level with the magnitude cell height closest to one pixel.
+ * @param visibleDecibelRange Height of the visible part of the view in dB.
+ * @param viewportHeight Height of the view in pixels.
+ */
+size_t selectRtsaLevel(size_t magnitudeResolution,
+                       float magnitudeDecibelRange,
+                       float visibleDecibelRange,
+                       float viewportHeight);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <spectr/render_gl/GraphicsApi.h>
+#include <spectr/render_gl/OpenGlUtils.h>
+
+namespace spectr::render_gl
+{
+class SpectrumTraceContainerSettings
+{
+public:
+    /**
+     * @brief Count of values in a trace, the same as the frequency count of the RTSA view.
+     */
+    size_t frequencyValuesCount;
+
+    size_t traceCount;
+
+    float valuesInOneHertz;
+
+    /**
+     * @brief Traces are clamped to [-range; 0] dBFS.
+     */
+    float magnitudeDecibelRange;
+
+    /**
+     * @brief Returns size of the buffer in bytes.
+     */
+    size_t getBufferSize() const;
+};
+
+/**
+ * @brief OpenGL buffer of the spectrum traces: trace count arrays of frequency count float dBFS
+ * values, one after another.
+ */
+class SpectrumTraceContainer
+{
+public:
+    SpectrumTraceContainer(SpectrumTraceContainerSettings settings);
+
+    ~SpectrumTraceContainer();
+
+    GLuint getBuffer() const;
+
+    const SpectrumTraceContainerSettings& getSettings() const;
+
+private:
+    SpectrumTraceContainerSettings m_settings;
+    GLuint m_tracesSsbo = NoBuffer;
+};
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <spectr/render_gl/GraphicsApi.h>
+#include <spectr/render_gl/RenderContext.h>
+#include <spectr/render_gl/SpectrumTraceContainer.h>
+
+#include <memory>
+#include <vector>
+
+namespace spectr::render_gl
+{
+/**
+ * @brief Renders the spectrum traces as polylines in the RTSA view coordinates: x - frequency in
+ * Hz, y - dBFS. Values are read from the container buffer in the vertex shader, so the traces
+ * don't need vertex buffers or host copies.
+ */
+class SpectrumTraceRenderer
+{
+public:
+    SpectrumTraceRenderer(std::shared_ptr<SpectrumTraceContainer> container);
+
+    ~SpectrumTraceRenderer();
+
+    void render(const render_gl::RenderContext& renderContext);
+
+    void setTraceColor(size_t traceIndex, const Color& color);
+
+    void setTraceVisible(size_t traceIndex, bool isVisible);
+
+    bool isTraceVisible(size_t traceIndex) const;
+
+private:
+    struct TraceStyle
+    {
+        Color color;
+        bool isVisible = true;
+    };
+
+    std::shared_ptr<SpectrumTraceContainer> m_container;
+    std::vector<TraceStyle> m_traceStyles;
+    GLuint m_vao = NoBuffer; // empty, required by the core profile for drawing
+    GLuint m_shaderProgram = NoShaderProgram;
+    GLint m_worldToClipIndex = NoUniform;
+    GLint m_traceOffsetIndex = NoUniform;
+    GLint m_binWidthIndex = NoUniform;
+    GLint m_minDbfsIndex = NoUniform;
+    GLint m_lineColorIndex = NoUniform;
+};
+}
@@ -2,7 +2,11 @@
 
 #include <spectr/render_gl/GraphicsApi.h>
 #include <spectr/render_gl/OpenGlUtils.h>
+#include <spectr/utils/DecibelQuantizer.h>
 
+#include <cstddef>
+#include <limits>
+#include <optional>
 #include <vector>
 
 namespace spectr::render_gl
@@ -63,6 +67,25 @@ struct TimeFrequencyHeatmapContainerSettings
      * @details When
      */
     size_t maxBuffersCount;
+
+    /**
+     * @brief Count of the levels of detail, including the full resolution level 0. Every next
+     * level has 2 times less columns and 2 times less values in a column.
+     */
+    size_t levelCount = 1;
+
+    /**
+     * @brief Format of the values in the buffers, the decibel formats take 2 or 4 times less
+     * memory and upload bandwidth.
+     */
+    utils::ValueFormat storageFormat = utils::ValueFormat::Float32;
+
+    /**
+     * @brief Quantization range of the decibel formats, the magnitudes out of it are clamped:
+     * with the default range the magnitudes below 1 are stored as 1.
+     */
+    float minDecibels = 0.0f;
+    float maxDecibels = 200.0f;
 };
 
 /**
@@ -75,12 +98,18 @@ struct TimeFrequencyHeatmapContainerSettings
  * the spectrogram.
  *
  * Spectrogram can viewed as many columns of values stored in container. Container stores these
- * columns in buffers, one buffer may contain several columns.
+ * columns in buffers, one buffer may contain several columns. The buffers are a ring, a buffer is
+ * found by its index and the storage of the oldest one is reused for the newest one.
  *
  * A column of values = frequencies range at specific point of time.
  * Container = set of OpenGL buffers.
  * Element count in buffer = ColumnCountInBuffer * ValuesCountInColumn.
  * Container element count = BufferCountInContainer * ColumnCountInBuffer * ValuesCountInColumn.
+ *
+ * The columns are also stored in coarser levels of detail, every value of level L + 1 is the max of
+ * 2x2 values of level L. The levels are reduced as the columns are added, so a zoomed out view
+ * renders about as many values as it has pixels regardless of the history length. A level buffer
+ * has the same column count, so it covers 2^L times more time than a buffer of level 0.
  */
 class TimeFrequencyHeatmapContainer
 {
@@ -91,12 +120,42 @@ public:
 
     const TimeFrequencyHeatmapContainerSettings& getSettings();
 
-    const std::vector<TimeFrequencyHeatmapBuffer>& getBuffers() const;
+    /**
+     * @brief Gets the buffers of the level which have any of the level 0 columns in the range,
+     * from the oldest one.
+     * @details Columns of the buffers are the columns of the level. Reusing the vector doesn't
+     * allocate memory once it has grown to the count of the visible buffers.
+     */
+    void getVisibleBuffers(size_t startColumn,
+                           size_t endColumn,
+                           size_t level,
+                           std::vector<TimeFrequencyHeatmapBuffer>& visibleBuffers) const;
+
+    /**
+     * @brief Uploads the column values and reduces them to the coarser levels.
+     * @param values Column height element count values.
+     */
+    void addColumn(size_t columnIndex, const float* values);
+
+    size_t getLevelCount() const;
+
+    /**
+     * @brief Returns count of values in a column of the level.
+     */
+    size_t getLevelColumnHeight(size_t level) const;
 
-    TimeFrequencyHeatmapBuffer& getOrAllocateBuffer(size_t columnIndex);
+    /**
+     * @brief Returns count of the level columns filled with data, the coarser levels lag behind
+     * level 0 by the columns waiting for their pair.
+     */
+    size_t getLevelFilledColumnCount(size_t level) const;
 
-    std::vector<TimeFrequencyHeatmapBuffer> getVisibleBuffers(size_t startColumn,
-                                                              size_t endColumn) const;
+    /**
+     * @brief Returns the coarsest level which still has at least one value per pixel.
+     * @param columnsInPixel Count of level 0 columns shown on one pixel.
+     * @param valuesInPixel Count of level 0 column values shown on one pixel.
+     */
+    size_t selectLevel(float columnsInPixel, float valuesInPixel) const;
 
     /**
      * @brief Update the global maximum value stored in the container.
@@ -133,9 +192,49 @@ public:
      */
     glm::vec2 getColumnSize() const;
 
+private:
+    struct Level
+    {
+        size_t columnHeight = 0;
+        std::vector<TimeFrequencyHeatmapBuffer> buffers; // ring by the buffer index
+        size_t firstBufferIndex = std::numeric_limits<size_t>::max(); // ever stored
+        size_t bufferEndIndex = 0; // after the newest buffer
+        size_t filledColumnCount = 0;
+        std::vector<float> pendingColumn; // even column waiting for its pair to be reduced
+        std::optional<size_t> pendingColumnIndex;
+        std::vector<float> reducedColumn; // column pushed to the next level
+    };
+
+    /**
+     * @brief Returns the buffer of the column, the ring slot of the buffer is recycled for it if
+     * the slot keeps older columns.
+     * @param columnIndex Column of the level, level L has 2^L times less columns than level 0.
+     */
+    TimeFrequencyHeatmapBuffer& getOrAllocateBuffer(size_t columnIndex, size_t levelIndex);
+
+    void pushColumn(size_t levelIndex, size_t columnIndex, const float* values);
+
+    /**
+     * @brief Reduces the pending column of the level with the given column, or the only one of them
+     * which exists, and pushes the result to the next level.
+     */
+    void reduceToNextLevel(size_t levelIndex, size_t columnIndex, const float* values);
+
+    /**
+     * @brief Returns index of the oldest buffer which may be still stored in the ring.
+     */
+    size_t getOldestBufferIndex(const Level& level) const;
+
+    /**
+     * @brief Returns the column values in the storage format.
+     */
+    const void* encodeColumn(const float* values, size_t count);
+
 private:
     TimeFrequencyHeatmapContainerSettings m_settings;
-    std::vector<TimeFrequencyHeatmapBuffer> m_buffers;
+    std::vector<Level> m_levels;
+    utils::DecibelQuantizer m_quantizer;
+    std::vector<std::byte> m_encodedColumn; // column values in a decibel format
     float m_globalMaxValue = 0;
     size_t m_lastFilledColumn = 0;
 };
@@ -83,10 +83,19 @@ public:
     glm::mat3 getRotationMatrix() const;
 
 private:
+    /**
+     * @brief Renders the buffers of the level which have any of the level 0 columns in the range.
+     */
+    void renderLevel(const RenderContext& renderContext,
+                     size_t level,
+                     size_t startColumn,
+                     size_t endColumn);
+
     void recreateRenderProgram();
 
 private:
     std::shared_ptr<TimeFrequencyHeatmapContainer> m_container;
+    std::vector<TimeFrequencyHeatmapBuffer> m_visibleBuffers; // reused by every render
     GLuint m_quadVbo = NoBuffer;
     GLuint m_quadVao = NoBuffer;
     GLuint m_heatmapShaderProgram = NoShaderProgram;
@@ -106,8 +115,11 @@ private:
     GLint m_columnWidthUnitsIdx = NoUniform;
     GLint m_valueHeightUnitsIdx = NoUniform;
     GLint m_columnHeightValuesIdx = NoUniform;
+    GLint m_filledColumnCountIdx = NoUniform;
     GLint m_minValueIdx = NoUniform;
     GLint m_maxValueIdx = NoUniform;
+    GLint m_minDecibelsIdx = NoUniform;
+    GLint m_maxDecibelsIdx = NoUniform;
     // GLint m_Idx = NoUniform;
 };
 }
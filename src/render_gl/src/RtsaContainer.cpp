@@ -1,5 +1,7 @@
 #include <spectr/render_gl/RtsaContainer.h>
 
+#include <spectr/utils/Exception.h>
+
 namespace spectr::render_gl
 {
 float RtsaContainerSettings::getMaxFrequency() const
@@ -7,15 +9,24 @@ float RtsaContainerSettings::getMaxFrequency() const
     return frequencyValuesCount / valuesInOneHertz;
 }
 
+size_t RtsaContainerSettings::getCellSize() const
+{
+    return storageFormat == utils::RtsaStorageFormat::Unorm16x2 ? sizeof(uint32_t)
+                                                                  : sizeof(float) * 2;
+}
+
+size_t RtsaContainerSettings::getBufferSize() const
+{
+    return frequencyValuesCount * magnitudeRangeValuesCount * getCellSize();
+}
+
 RtsaContainer::RtsaContainer(RtsaContainerSettings settings)
   : m_settings{ settings }
 {
     glGenBuffers(1, &m_rtsaHeatmapSsbo);
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_rtsaHeatmapSsbo);
 
-    const auto bufferSize =
-      settings.frequencyValuesCount * settings.magnitudeRangeValuesCount * sizeof(float) * 2;
-    glBufferData(GL_SHADER_STORAGE_BUFFER, bufferSize, nullptr, GL_STREAM_DRAW);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, settings.getBufferSize(), nullptr, GL_STREAM_DRAW);
     
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 }
@@ -34,4 +45,24 @@ const RtsaContainerSettings& RtsaContainer::getSettings() const
 {
     return m_settings;
 }
+
+void RtsaContainer::setLevel(size_t level)
+{
+    const auto levelCount = getRtsaLevelCount(m_settings.magnitudeRangeValuesCount);
+    if (level >= levelCount)
+    {
+        throw utils::Exception("RTSA level {} is out of range, level count: {}", level, levelCount);
+    }
+    m_level = level;
+}
+
+size_t RtsaContainer::getLevel() const
+{
+    return m_level;
+}
+
+size_t RtsaContainer::getLevelResolution() const
+{
+    return getRtsaLevelResolution(m_settings.magnitudeRangeValuesCount, m_level);
+}
 }
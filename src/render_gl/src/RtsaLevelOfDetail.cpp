@@ -0,0 +1,47 @@
+#include <spectr/render_gl/RtsaLevelOfDetail.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace spectr::render_gl
+{
+size_t getRtsaLevelCount(size_t magnitudeResolution)
+{
+    size_t levelCount = 1;
+    auto resolution = magnitudeResolution;
+    while (resolution % 2 == 0 && resolution / 2 >= MinRtsaLevelResolution)
+    {
+        resolution /= 2;
+        ++levelCount;
+    }
+    return levelCount;
+}
+
+size_t getRtsaLevelResolution(size_t magnitudeResolution, size_t level)
+{
+    return magnitudeResolution >> level;
+}
+
+size_t selectRtsaLevel(size_t magnitudeResolution,
+                       float magnitudeDecibelRange,
+                       float visibleDecibelRange,
+                       float viewportHeight)
+{
+    if (!(viewportHeight > 0.0f) || !(visibleDecibelRange > 0.0f))
+    {
+        return 0;
+    }
+
+    // cells per pixel at level 0, every level halves it
+    const auto cellsInPixel = static_cast<float>(magnitudeResolution) / magnitudeDecibelRange *
+                              visibleDecibelRange / viewportHeight;
+    const auto level = std::round(std::log2(cellsInPixel));
+    if (!(level > 0.0f))
+    {
+        return 0;
+    }
+
+    const auto maxLevel = getRtsaLevelCount(magnitudeResolution) - 1;
+    return std::min(static_cast<size_t>(level), maxLevel);
+}
+}
@@ -41,6 +41,10 @@ RtsaRenderer::RtsaRenderer(std::shared_ptr<RtsaContainer> container)
       utils::File::read(utils::Asset::getPath(IntensityScaleShaderPath));
 
     fragmentSources.push_back("#version 430 core\n");
+    if (m_container->getSettings().storageFormat == utils::RtsaStorageFormat::Unorm16x2)
+    {
+        fragmentSources.push_back("#define RTSA_PACKED\n");
+    }
     fragmentSources.push_back(intensityScaleSource);
     fragmentSources.push_back(fragmentSource);
 
@@ -107,11 +111,11 @@ void RtsaRenderer::render(const render_gl::RenderContext& renderContext)
     // set OpenGL uniform/SSBO buffer
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, m_container->getBuffer());
 
-    glUniform1ui(m_columnSizeIndex,
-                 static_cast<GLuint>(m_container->getSettings().magnitudeRangeValuesCount));
+    // the buffer holds the cells of the current level of detail
+    const auto levelResolution = m_container->getLevelResolution();
+    glUniform1ui(m_columnSizeIndex, static_cast<GLuint>(levelResolution));
 
-    const auto dbfsToMagnitudeCellCoeff =
-      settings.magnitudeRangeValuesCount / settings.magnitudeDecibelRange;
+    const auto dbfsToMagnitudeCellCoeff = levelResolution / settings.magnitudeDecibelRange;
     glUniform1f(m_dbfsToMagnitudeCellCoeffIndex, dbfsToMagnitudeCellCoeff);
 
     // draw quad
@@ -0,0 +1,42 @@
+#include <spectr/render_gl/SpectrumTraceContainer.h>
+
+#include <vector>
+
+namespace spectr::render_gl
+{
+size_t SpectrumTraceContainerSettings::getBufferSize() const
+{
+    return frequencyValuesCount * traceCount * sizeof(float);
+}
+
+SpectrumTraceContainer::SpectrumTraceContainer(SpectrumTraceContainerSettings settings)
+  : m_settings{ settings }
+{
+    // traces start below the visible range until the first frame is written
+    const std::vector<float> initialValues(
+      m_settings.frequencyValuesCount * m_settings.traceCount, -m_settings.magnitudeDecibelRange);
+
+    glGenBuffers(1, &m_tracesSsbo);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_tracesSsbo);
+    glBufferData(GL_SHADER_STORAGE_BUFFER,
+                 m_settings.getBufferSize(),
+                 initialValues.data(),
+                 GL_STREAM_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+SpectrumTraceContainer::~SpectrumTraceContainer()
+{
+    glDeleteBuffers(1, &m_tracesSsbo);
+}
+
+GLuint SpectrumTraceContainer::getBuffer() const
+{
+    return m_tracesSsbo;
+}
+
+const SpectrumTraceContainerSettings& SpectrumTraceContainer::getSettings() const
+{
+    return m_settings;
+}
+}
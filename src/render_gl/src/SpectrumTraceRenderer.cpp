@@ -0,0 +1,98 @@
+#include <spectr/render_gl/SpectrumTraceRenderer.h>
+
+#include <spectr/render_gl/OpenGlUtils.h>
+#include <spectr/utils/Asset.h>
+#include <spectr/utils/File.h>
+
+#include <glm/gtc/type_ptr.hpp>
+
+namespace spectr::render_gl
+{
+namespace
+{
+const auto TraceVertexShaderPath = "shaders/spectrum_trace/Vertex.glsl";
+const auto LineFragmentShaderPath = "shaders/line/Fragment.glsl";
+
+const Color DefaultTraceColors[]{
+    makeColor(255, 255, 0),  // live
+    makeColor(255, 64, 64),  // max hold
+    makeColor(64, 160, 255), // min hold
+    makeColor(64, 255, 64),  // average
+};
+}
+
+SpectrumTraceRenderer::SpectrumTraceRenderer(std::shared_ptr<SpectrumTraceContainer> container)
+  : m_container{ container }
+{
+    const auto traceCount = m_container->getSettings().traceCount;
+    m_traceStyles.resize(traceCount);
+    for (size_t i = 0; i < traceCount; ++i)
+    {
+        m_traceStyles[i].color = DefaultTraceColors[i % std::size(DefaultTraceColors)];
+    }
+
+    const auto vertexSource = utils::File::read(utils::Asset::getPath(TraceVertexShaderPath));
+    const auto fragmentSource = utils::File::read(utils::Asset::getPath(LineFragmentShaderPath));
+    m_shaderProgram = OpenGlUtils::createShaderProgram(vertexSource, fragmentSource);
+
+    m_worldToClipIndex = glGetUniformLocation(m_shaderProgram, "worldToClip");
+    m_traceOffsetIndex = glGetUniformLocation(m_shaderProgram, "traceOffset");
+    m_binWidthIndex = glGetUniformLocation(m_shaderProgram, "binWidth");
+    m_minDbfsIndex = glGetUniformLocation(m_shaderProgram, "minDbfs");
+    m_lineColorIndex = glGetUniformLocation(m_shaderProgram, "lineColor");
+
+    glGenVertexArrays(1, &m_vao);
+}
+
+SpectrumTraceRenderer::~SpectrumTraceRenderer()
+{
+    glDeleteVertexArrays(1, &m_vao);
+    glDeleteProgram(m_shaderProgram);
+}
+
+void SpectrumTraceRenderer::render(const render_gl::RenderContext& renderContext)
+{
+    const auto& settings = m_container->getSettings();
+
+    glUseProgram(m_shaderProgram);
+
+    const auto worldToClipMatrix = renderContext.camera->getViewProjection();
+    glUniformMatrix3fv(m_worldToClipIndex, 1, GL_FALSE, glm::value_ptr(worldToClipMatrix));
+    glUniform1f(m_binWidthIndex, 1.0f / settings.valuesInOneHertz);
+    glUniform1f(m_minDbfsIndex, -settings.magnitudeDecibelRange);
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, m_container->getBuffer());
+    glBindVertexArray(m_vao);
+
+    for (size_t traceIndex = 0; traceIndex < m_traceStyles.size(); ++traceIndex)
+    {
+        const auto& style = m_traceStyles[traceIndex];
+        if (!style.isVisible)
+        {
+            continue;
+        }
+
+        glUniform1ui(m_traceOffsetIndex,
+                     static_cast<GLuint>(traceIndex * settings.frequencyValuesCount));
+        glUniform4fv(m_lineColorIndex, 1, glm::value_ptr(style.color));
+        glDrawArrays(GL_LINE_STRIP, 0, static_cast<GLsizei>(settings.frequencyValuesCount));
+    }
+
+    glBindVertexArray(NoBuffer);
+}
+
+void SpectrumTraceRenderer::setTraceColor(size_t traceIndex, const Color& color)
+{
+    m_traceStyles.at(traceIndex).color = color;
+}
+
+void SpectrumTraceRenderer::setTraceVisible(size_t traceIndex, bool isVisible)
+{
+    m_traceStyles.at(traceIndex).isVisible = isVisible;
+}
+
+bool SpectrumTraceRenderer::isTraceVisible(size_t traceIndex) const
+{
+    return m_traceStyles.at(traceIndex).isVisible;
+}
+}
@@ -1,82 +1,119 @@
 #include <spectr/render_gl/TimeFrequencyHeatmapContainer.h>
 
 #include <spectr/utils/Assert.h>
-#include <spectr/utils/Exception.h>
+
+#include <algorithm>
+#include <cmath>
 
 namespace spectr::render_gl
 {
 TimeFrequencyHeatmapContainer::TimeFrequencyHeatmapContainer(
   TimeFrequencyHeatmapContainerSettings settings)
   : m_settings{ std::move(settings) }
+  , m_quantizer{ m_settings.storageFormat, m_settings.minDecibels, m_settings.maxDecibels }
 {
+    ASSERT(m_settings.columnHeightElementCount > 0);
+    m_encodedColumn.resize(m_settings.columnHeightElementCount *
+                           utils::getValueSize(m_settings.storageFormat));
+
+    // the levels are added while a column has values to reduce
+    auto columnHeight = m_settings.columnHeightElementCount;
+    auto maxBuffersCount = m_settings.maxBuffersCount;
+    do
+    {
+        Level level;
+        level.columnHeight = columnHeight;
+        // the partially filled buffer of a level doesn't cover all its time
+        level.buffers.resize(std::max<size_t>(maxBuffersCount, 1) + (m_levels.empty() ? 0 : 1));
+        level.pendingColumn.resize(columnHeight);
+        level.reducedColumn.resize((columnHeight + 1) / 2);
+        m_levels.push_back(std::move(level));
+
+        columnHeight = (columnHeight + 1) / 2;
+        maxBuffersCount /= 2;
+    } while (m_levels.size() < m_settings.levelCount && m_levels.back().columnHeight > 1);
 }
 
-TimeFrequencyHeatmapContainer::~TimeFrequencyHeatmapContainer() {}
+TimeFrequencyHeatmapContainer::~TimeFrequencyHeatmapContainer()
+{
+    for (auto& level : m_levels)
+    {
+        for (auto& buffer : level.buffers)
+        {
+            if (buffer.ssbo != NoBuffer)
+            {
+                glDeleteBuffers(1, &buffer.ssbo);
+            }
+        }
+    }
+}
 
 const TimeFrequencyHeatmapContainerSettings& TimeFrequencyHeatmapContainer::getSettings()
 {
     return m_settings;
 }
 
-const std::vector<TimeFrequencyHeatmapBuffer>& TimeFrequencyHeatmapContainer::getBuffers() const
+void TimeFrequencyHeatmapContainer::getVisibleBuffers(
+  size_t startColumn,
+  size_t endColumn,
+  size_t levelIndex,
+  std::vector<TimeFrequencyHeatmapBuffer>& visibleBuffers) const
 {
-    return m_buffers;
-}
+    visibleBuffers.clear();
 
-TimeFrequencyHeatmapBuffer& TimeFrequencyHeatmapContainer::getOrAllocateBuffer(size_t columnIndex)
-{
-    // TODO binary search
-    for (auto& buffer : m_buffers)
+    const auto& level = m_levels.at(levelIndex);
+    if (level.bufferEndIndex == 0)
     {
-        if (columnIndex >= buffer.startColumn && columnIndex <= buffer.endColumn)
-        {
-            return buffer;
-        }
+        return;
     }
 
-    // buffer not found, it means it's not created yet, so create new buffer
-    const auto bufferGlobalIndex = columnIndex / m_settings.singleBufferColumnCount;
-    const auto bufferStartColumn = bufferGlobalIndex * m_settings.singleBufferColumnCount;
-    const auto bufferEndColumn = bufferStartColumn + m_settings.singleBufferColumnCount - 1;
-
-    GLuint ssbo = 0;
-    glGenBuffers(1, &ssbo);
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssbo);
+    const auto bufferColumnCount = m_settings.singleBufferColumnCount;
+    const auto firstBufferIndex =
+      std::max((startColumn >> levelIndex) / bufferColumnCount, getOldestBufferIndex(level));
+    const auto lastBufferIndex =
+      std::min((endColumn >> levelIndex) / bufferColumnCount, level.bufferEndIndex - 1);
 
-    const auto columnSizeBytes = sizeof(float) * m_settings.columnHeightElementCount;
-    const auto bufferSizeBytes = columnSizeBytes * m_settings.singleBufferColumnCount;
+    for (auto i = firstBufferIndex; i <= lastBufferIndex; ++i)
+    {
+        // a slot of a skipped buffer may still keep an older one
+        const auto& buffer = level.buffers[i % level.buffers.size()];
+        if (buffer.ssbo != NoBuffer && buffer.startColumn == i * bufferColumnCount)
+        {
+            visibleBuffers.push_back(buffer);
+        }
+    }
+}
 
-    // std::vector<float> vals;
-    // vals.resize(200, 5);
-    // glBufferData(GL_SHADER_STORAGE_BUFFER, bufferSizeBytes, vals.data(), GL_DYNAMIC_COPY);
-    glBufferData(GL_SHADER_STORAGE_BUFFER, bufferSizeBytes, nullptr, GL_DYNAMIC_COPY);
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+void TimeFrequencyHeatmapContainer::addColumn(size_t columnIndex, const float* values)
+{
+    pushColumn(0, columnIndex, values);
+    setLastFilledColumn(columnIndex);
+}
 
-    TimeFrequencyHeatmapBuffer buffer{ bufferStartColumn, bufferEndColumn, ssbo };
-    m_buffers.push_back(buffer);
+size_t TimeFrequencyHeatmapContainer::getLevelCount() const
+{
+    return m_levels.size();
+}
 
-    if (m_buffers.size() > m_settings.maxBuffersCount)
-    {
-        m_buffers.erase(m_buffers.begin());
-    }
+size_t TimeFrequencyHeatmapContainer::getLevelColumnHeight(size_t level) const
+{
+    return m_levels.at(level).columnHeight;
+}
 
-    return m_buffers.back();
+size_t TimeFrequencyHeatmapContainer::getLevelFilledColumnCount(size_t level) const
+{
+    return m_levels.at(level).filledColumnCount;
 }
 
-std::vector<TimeFrequencyHeatmapBuffer> TimeFrequencyHeatmapContainer::getVisibleBuffers(
-  size_t startColumn,
-  size_t endColumn) const
+size_t TimeFrequencyHeatmapContainer::selectLevel(float columnsInPixel, float valuesInPixel) const
 {
-    std::vector<TimeFrequencyHeatmapBuffer> visibleBuffers;
-    for (const auto& buffer : m_buffers)
+    // level L has 2^L times less columns and values, it mustn't get coarser than pixels on any axis
+    const auto level = std::floor(std::log2(std::min(columnsInPixel, valuesInPixel)));
+    if (!(level > 0.0f))
     {
-        if (buffer.endColumn >= startColumn && buffer.startColumn <= endColumn)
-            {
-            visibleBuffers.push_back(buffer);
-        }
+        return 0;
     }
-
-    return visibleBuffers;
+    return std::min(static_cast<size_t>(level), m_levels.size() - 1);
 }
 
 void TimeFrequencyHeatmapContainer::tryUpdateMaxValue(float value)
@@ -99,15 +136,16 @@ float TimeFrequencyHeatmapContainer::getMaxValue() const
 
 Range TimeFrequencyHeatmapContainer::getTimeRange() const
 {
-    if (m_buffers.empty())
+    const auto& level = m_levels.front();
+    if (level.bufferEndIndex == 0)
     {
         return { 0, 0 };
     }
 
     const auto columnWidth = 1.0f / m_settings.columnsInOneSecond;
 
-    const auto& firstBuffer = m_buffers.front();
-    const auto minX = firstBuffer.startColumn * columnWidth;
+    const auto firstColumn = getOldestBufferIndex(level) * m_settings.singleBufferColumnCount;
+    const auto minX = firstColumn * columnWidth;
 
     const auto maxX = m_lastFilledColumn * columnWidth;
 
@@ -130,4 +168,128 @@ glm::vec2 TimeFrequencyHeatmapContainer::getColumnSize() const
     const auto columnHeight = m_settings.columnHeightElementCount / m_settings.valuesInOneHertz;
     return { columnWidth, columnHeight };
 }
+
+TimeFrequencyHeatmapBuffer& TimeFrequencyHeatmapContainer::getOrAllocateBuffer(size_t columnIndex,
+                                                                              size_t levelIndex)
+{
+    auto& level = m_levels.at(levelIndex);
+
+    const auto bufferGlobalIndex = columnIndex / m_settings.singleBufferColumnCount;
+    const auto bufferStartColumn = bufferGlobalIndex * m_settings.singleBufferColumnCount;
+    const auto bufferEndColumn = bufferStartColumn + m_settings.singleBufferColumnCount - 1;
+
+    auto& buffer = level.buffers[bufferGlobalIndex % level.buffers.size()];
+    if (buffer.ssbo != NoBuffer && buffer.startColumn == bufferStartColumn)
+    {
+        return buffer;
+    }
+
+    // the ring slot is used for the first time, later its storage is recycled in place
+    if (buffer.ssbo == NoBuffer)
+    {
+        glGenBuffers(1, &buffer.ssbo);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer.ssbo);
+
+        // the shader reads the packed decibel codes by whole uints
+        const auto columnSizeBytes =
+          utils::getValueSize(m_settings.storageFormat) * level.columnHeight;
+        const auto bufferSizeBytes =
+          (columnSizeBytes * m_settings.singleBufferColumnCount + sizeof(uint32_t) - 1) /
+          sizeof(uint32_t) * sizeof(uint32_t);
+
+        glBufferData(GL_SHADER_STORAGE_BUFFER, bufferSizeBytes, nullptr, GL_DYNAMIC_COPY);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    }
+
+    buffer.startColumn = bufferStartColumn;
+    buffer.endColumn = bufferEndColumn;
+    level.firstBufferIndex = std::min(level.firstBufferIndex, bufferGlobalIndex);
+    level.bufferEndIndex = std::max(level.bufferEndIndex, bufferGlobalIndex + 1);
+
+    return buffer;
+}
+
+void TimeFrequencyHeatmapContainer::pushColumn(size_t levelIndex,
+                                               size_t columnIndex,
+                                               const float* values)
+{
+    auto& level = m_levels[levelIndex];
+
+    // the ring has already recycled the buffer of the column for the newer ones
+    const auto bufferIndex = columnIndex / m_settings.singleBufferColumnCount;
+    if (bufferIndex + level.buffers.size() < level.bufferEndIndex)
+    {
+        return;
+    }
+
+    const auto& buffer = getOrAllocateBuffer(columnIndex, levelIndex);
+    const auto columnSizeBytes = level.columnHeight * utils::getValueSize(m_settings.storageFormat);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer.ssbo);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER,
+                    (columnIndex - buffer.startColumn) * columnSizeBytes,
+                    columnSizeBytes,
+                    encodeColumn(values, level.columnHeight));
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    level.filledColumnCount = std::max(level.filledColumnCount, columnIndex + 1);
+
+    if (levelIndex + 1 == m_levels.size())
+    {
+        return;
+    }
+
+    // the pair of the pending column was skipped, e.g. the frame was dropped
+    if (level.pendingColumnIndex && *level.pendingColumnIndex + 1 != columnIndex)
+    {
+        reduceToNextLevel(levelIndex, *level.pendingColumnIndex, nullptr);
+    }
+
+    if (columnIndex % 2 == 0)
+    {
+        std::copy_n(values, level.columnHeight, level.pendingColumn.begin());
+        level.pendingColumnIndex = columnIndex;
+        return;
+    }
+
+    reduceToNextLevel(levelIndex, columnIndex, values);
+}
+
+void TimeFrequencyHeatmapContainer::reduceToNextLevel(size_t levelIndex,
+                                                      size_t columnIndex,
+                                                      const float* values)
+{
+    auto& level = m_levels[levelIndex];
+    const auto* first = level.pendingColumnIndex ? level.pendingColumn.data() : values;
+    const auto* second = values ? values : first;
+
+    // 2x2 max pooling, the last value of an odd height column is reduced alone
+    for (size_t i = 0; i < level.reducedColumn.size(); ++i)
+    {
+        const auto lower = i * 2;
+        const auto upper = std::min(lower + 1, level.columnHeight - 1);
+        level.reducedColumn[i] =
+          std::max({ first[lower], first[upper], second[lower], second[upper] });
+    }
+
+    level.pendingColumnIndex.reset();
+    pushColumn(levelIndex + 1, columnIndex / 2, level.reducedColumn.data());
+}
+
+size_t TimeFrequencyHeatmapContainer::getOldestBufferIndex(const Level& level) const
+{
+    const auto ringSize = std::min(level.bufferEndIndex, level.buffers.size());
+    return std::max(level.firstBufferIndex, level.bufferEndIndex - ringSize);
+}
+
+const void* TimeFrequencyHeatmapContainer::encodeColumn(const float* values, size_t count)
+{
+    // the float values are uploaded as they are
+    if (m_settings.storageFormat == utils::ValueFormat::Float32)
+    {
+        return values;
+    }
+
+    m_quantizer.encode(values, count, m_encodedColumn.data());
+    return m_encodedColumn.data();
+}
 }
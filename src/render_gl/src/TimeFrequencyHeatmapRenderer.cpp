@@ -150,66 +150,39 @@ void TimeFrequencyHeatmapRenderer::render(const RenderContext& renderContext)
     auto startColumn = startX * contSettings.columnsInOneSecond;
     auto endColumn = endX * contSettings.columnsInOneSecond;
 
-    const auto visibleHeatmapBuffers =
-      m_container->getVisibleBuffers(static_cast<size_t>(std::max(0.0f, startColumn)),
-                                     static_cast<size_t>(std::max(0.0f, endColumn)));
-
-    const auto bufferWidthSeconds =
-      contSettings.singleBufferColumnCount / contSettings.columnsInOneSecond;
-    const auto bufferHeightHertz =
-      contSettings.columnHeightElementCount / contSettings.valuesInOneHertz;
-
-    const auto constantHeightOffset = contSettings.frequencyOffset;
-
-    for (const auto& heatmapBuffer : visibleHeatmapBuffers)
+    // pick the level of detail by the count of columns and values shown on one pixel
+    const auto startY =
+      m_waterfallDirection == WaterfallDirection::Horizontal ? lowerLeft.y : lowerLeft.x;
+    const auto endY =
+      m_waterfallDirection == WaterfallDirection::Horizontal ? upperRight.y : upperRight.x;
+    const auto pixelsAlongTime = m_waterfallDirection == WaterfallDirection::Horizontal
+                                   ? renderContext.viewportSize.x
+                                   : renderContext.viewportSize.y;
+    const auto pixelsAlongFrequency = m_waterfallDirection == WaterfallDirection::Horizontal
+                                        ? renderContext.viewportSize.y
+                                        : renderContext.viewportSize.x;
+    const auto columnsInPixel = (endColumn - startColumn) / std::max(pixelsAlongTime, 1);
+    const auto valuesInPixel =
+      (endY - startY) * contSettings.valuesInOneHertz / std::max(pixelsAlongFrequency, 1);
+    const auto selectedLevel = m_container->selectLevel(columnsInPixel, valuesInPixel);
+
+    const auto visibleStartColumn = static_cast<size_t>(std::max(0.0f, startColumn));
+    const auto visibleEndColumn = static_cast<size_t>(std::max(0.0f, endColumn));
+
+    // the coarse levels lag behind the newest columns, the finer levels render the rest
+    auto levelStartColumn = visibleStartColumn;
+    for (auto level = selectedLevel + 1; level-- > 0;)
     {
-        // render heatmap chunk:
-        const auto columnWidthSeconds = 1.0f / contSettings.columnsInOneSecond;
-        const auto bufferStartSeconds = heatmapBuffer.startColumn * columnWidthSeconds;
-
-        const auto cosA = m_waterfallDirection == WaterfallDirection::Horizontal ? 1.0f : 0.0f;
-        const auto sinA = m_waterfallDirection == WaterfallDirection::Horizontal ? 0.0f : -1.0f;
-
-        const glm::mat3 localToWorldMat{ { bufferWidthSeconds, 0, 0 },
-                                         { 0, bufferHeightHertz, 0 },
-                                         { bufferStartSeconds + bufferWidthSeconds / 2.0f,
-                                           contSettings.frequencyOffset + bufferHeightHertz / 2.0f,
-                                           1 } };
-
-        // set rendering parameters
-        glUseProgram(m_heatmapShaderProgram);
-
-        // set local to clip matrix
-        const auto localToClipMat =
-          renderContext.camera->getViewProjection() * getRotationMatrix() * localToWorldMat;
-        glUniformMatrix3fv(m_localToClipIdx, 1, GL_FALSE, glm::value_ptr(localToClipMat));
-
-        // set local to world matrix
-        glUniformMatrix3fv(m_localToWorldIdx, 1, GL_FALSE, glm::value_ptr(localToWorldMat));
-
-        // set OpenGL uniform/SSBO buffer
-        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, heatmapBuffer.ssbo);
-
-        const auto bufferLeftEdgeOffsetX = heatmapBuffer.startColumn * columnWidthSeconds;
-        glUniform2f(m_lowerLeftIdx, bufferLeftEdgeOffsetX, constantHeightOffset);
-
-        glUniform1f(m_columnWidthUnitsIdx, columnWidthSeconds);
-
-        const auto singleColumnElementHeight = 1.0f / contSettings.valuesInOneHertz;
-        glUniform1f(m_valueHeightUnitsIdx, singleColumnElementHeight);
-
-        glUniform1ui(m_columnHeightValuesIdx,
-                     static_cast<GLuint>(contSettings.columnHeightElementCount));
-
-        glUniform1f(m_minValueIdx, m_scaleMinValue);
-        glUniform1f(m_maxValueIdx, m_scaleMaxValue);
-
-        // draw quad
-        glBindVertexArray(m_quadVao);
-        glBindBuffer(GL_ARRAY_BUFFER, m_quadVbo);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-        glBindBuffer(GL_ARRAY_BUFFER, NoBuffer);
-        glBindVertexArray(NoBuffer);
+        const auto levelEndColumn = m_container->getLevelFilledColumnCount(level) << level;
+        if (levelEndColumn > levelStartColumn)
+        {
+            renderLevel(renderContext, level, levelStartColumn, visibleEndColumn);
+            levelStartColumn = levelEndColumn;
+        }
+        if (levelStartColumn > visibleEndColumn)
+        {
+            break;
+        }
     }
 }
 
@@ -285,6 +258,81 @@ void TimeFrequencyHeatmapRenderer::setWaterfallDirectionMode(WaterfallDirection
     }
 }
 
+void TimeFrequencyHeatmapRenderer::renderLevel(const RenderContext& renderContext,
+                                               size_t level,
+                                               size_t startColumn,
+                                               size_t endColumn)
+{
+    const auto contSettings = m_container->getSettings();
+
+    m_container->getVisibleBuffers(startColumn, endColumn, level, m_visibleBuffers);
+
+    // a column of the level covers 2^L columns and its value covers 2^L values of level 0
+    const auto levelScale = static_cast<float>(size_t{ 1 } << level);
+    const auto columnHeightValues = m_container->getLevelColumnHeight(level);
+    const auto filledColumnCount = m_container->getLevelFilledColumnCount(level);
+
+    const auto columnWidthSeconds = levelScale / contSettings.columnsInOneSecond;
+    const auto singleColumnElementHeight = levelScale / contSettings.valuesInOneHertz;
+    const auto bufferWidthSeconds = contSettings.singleBufferColumnCount * columnWidthSeconds;
+    const auto bufferHeightHertz = columnHeightValues * singleColumnElementHeight;
+
+    const auto constantHeightOffset = contSettings.frequencyOffset;
+
+    for (const auto& heatmapBuffer : m_visibleBuffers)
+    {
+        // render heatmap chunk:
+        const auto bufferStartSeconds = heatmapBuffer.startColumn * columnWidthSeconds;
+
+        const glm::mat3 localToWorldMat{ { bufferWidthSeconds, 0, 0 },
+                                         { 0, bufferHeightHertz, 0 },
+                                         { bufferStartSeconds + bufferWidthSeconds / 2.0f,
+                                           contSettings.frequencyOffset + bufferHeightHertz / 2.0f,
+                                           1 } };
+
+        // set rendering parameters
+        glUseProgram(m_heatmapShaderProgram);
+
+        // set local to clip matrix
+        const auto localToClipMat =
+          renderContext.camera->getViewProjection() * getRotationMatrix() * localToWorldMat;
+        glUniformMatrix3fv(m_localToClipIdx, 1, GL_FALSE, glm::value_ptr(localToClipMat));
+
+        // set local to world matrix
+        glUniformMatrix3fv(m_localToWorldIdx, 1, GL_FALSE, glm::value_ptr(localToWorldMat));
+
+        // set OpenGL uniform/SSBO buffer
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, heatmapBuffer.ssbo);
+
+        const auto bufferLeftEdgeOffsetX = heatmapBuffer.startColumn * columnWidthSeconds;
+        glUniform2f(m_lowerLeftIdx, bufferLeftEdgeOffsetX, constantHeightOffset);
+
+        glUniform1f(m_columnWidthUnitsIdx, columnWidthSeconds);
+
+        glUniform1f(m_valueHeightUnitsIdx, singleColumnElementHeight);
+
+        glUniform1ui(m_columnHeightValuesIdx, static_cast<GLuint>(columnHeightValues));
+
+        const auto bufferFilledColumnCount = filledColumnCount > heatmapBuffer.startColumn
+                                               ? filledColumnCount - heatmapBuffer.startColumn
+                                               : 0;
+        glUniform1ui(m_filledColumnCountIdx, static_cast<GLuint>(bufferFilledColumnCount));
+
+        glUniform1f(m_minValueIdx, m_scaleMinValue);
+        glUniform1f(m_maxValueIdx, m_scaleMaxValue);
+
+        glUniform1f(m_minDecibelsIdx, contSettings.minDecibels);
+        glUniform1f(m_maxDecibelsIdx, contSettings.maxDecibels);
+
+        // draw quad
+        glBindVertexArray(m_quadVao);
+        glBindBuffer(GL_ARRAY_BUFFER, m_quadVbo);
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+        glBindBuffer(GL_ARRAY_BUFFER, NoBuffer);
+        glBindVertexArray(NoBuffer);
+    }
+}
+
 glm::mat3 TimeFrequencyHeatmapRenderer::getRotationMatrix() const
 {
     const auto cosA = m_waterfallDirection == WaterfallDirection::Horizontal ? 1.0f : 0.0f;
@@ -307,6 +355,17 @@ void TimeFrequencyHeatmapRenderer::recreateRenderProgram()
     std::vector<std::string> fragmentShaderSources;
     fragmentShaderSources.push_back("#version 430 core\n");
 
+    switch (m_container->getSettings().storageFormat)
+    {
+        case utils::ValueFormat::Decibel16:
+            fragmentShaderSources.push_back("#define HEATMAP_DECIBEL16\n");
+            break;
+        case utils::ValueFormat::Decibel8:
+            fragmentShaderSources.push_back("#define HEATMAP_DECIBEL8\n");
+            break;
+        default: break;
+    }
+
     switch (m_magnitudeColorMode)
     {
         case MagnitudeColorMode::Grayscale:
@@ -385,7 +444,10 @@ void TimeFrequencyHeatmapRenderer::recreateRenderProgram()
     m_columnWidthUnitsIdx = glGetUniformLocation(m_heatmapShaderProgram, "columnWidthUnits");
     m_valueHeightUnitsIdx = glGetUniformLocation(m_heatmapShaderProgram, "valueHeightUnits");
     m_columnHeightValuesIdx = glGetUniformLocation(m_heatmapShaderProgram, "columnHeightValues");
+    m_filledColumnCountIdx = glGetUniformLocation(m_heatmapShaderProgram, "filledColumnCount");
     m_minValueIdx = glGetUniformLocation(m_heatmapShaderProgram, "minValue");
     m_maxValueIdx = glGetUniformLocation(m_heatmapShaderProgram, "maxValue");
+    m_minDecibelsIdx = glGetUniformLocation(m_heatmapShaderProgram, "minDecibels");
+    m_maxDecibelsIdx = glGetUniformLocation(m_heatmapShaderProgram, "maxDecibels");
 }
 }
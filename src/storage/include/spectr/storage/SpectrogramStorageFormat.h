@@ -0,0 +1,78 @@
+#pragma once
+
+#include <spectr/utils/DecibelQuantizer.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace spectr::storage
+{
+using utils::getValueSize;
+using utils::ValueFormat; // of the tile values
+
+/**
+ * @brief Which reduction of the finer level a tile holds, level 0 has only the Max plane which
+ * holds the original values.
+ */
+enum class TilePlane : uint32_t
+{
+    Max,
+    Mean,
+};
+
+/**
+ * @brief Header at the beginning of a spectrogram storage file.
+ * @details The file is a sequence of tiles of the pyramid levels in the order they were filled,
+ * every tile has tile column count x tile bin count values, column after column, the values
+ * outside the level are zeros. Level L+1 halves the columns of level L and the bins too while
+ * level L is wider than one tile, every value of it is the max or the mean of the values it
+ * covers. The index of all tiles is written after the last tile when the file is closed, the
+ * tiles of a file which wasn't closed are found by their headers.
+ */
+struct StorageFileHeader
+{
+    static constexpr char Magic[8] = { 'S', 'P', 'E', 'C', 'T', 'R', 'S', '\0' };
+    static constexpr uint32_t CurrentVersion = 1;
+
+    char magic[8] = {};
+    uint32_t version = 0;
+    ValueFormat valueFormat = ValueFormat::Float32;
+    uint32_t binCount = 0; // of level 0
+    uint32_t tileColumnCount = 0;
+    uint32_t tileBinCount = 0;
+    uint32_t levelCount = 0;
+    uint32_t fftSize = 0;
+    uint32_t hop = 0;
+    uint32_t sampleRate = 0;
+    uint32_t reserved = 0;
+    float minDecibels = 0.0f; // quantization range of the decibel formats
+    float maxDecibels = 0.0f;
+    uint64_t columnCount = 0; // of level 0, written when the file is closed
+    uint64_t indexOffset = 0; // zero - the file wasn't closed
+    uint64_t tileCount = 0;   // entries of the index
+};
+
+struct TileHeader
+{
+    uint32_t level = 0;
+    TilePlane plane = TilePlane::Max;
+    uint32_t binTileIndex = 0;
+    uint32_t columnCount = 0; // filled columns, the last tile of a level may be partial
+    uint64_t timeTileIndex = 0;
+};
+
+struct TileIndexEntry
+{
+    TileHeader tile;
+    uint64_t offset = 0; // of the tile values in the file
+};
+
+static_assert(sizeof(StorageFileHeader) % 8 == 0 && sizeof(TileHeader) % 8 == 0,
+              "Tile values must stay aligned in the mapped file.");
+
+/**
+ * @brief Returns count of bins of a pyramid level.
+ * @param binCount Count of bins of level 0.
+ */
+size_t getLevelBinCount(size_t binCount, size_t tileBinCount, size_t level);
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <spectr/storage/SpectrogramStorageFormat.h>
+#include <spectr/utils/MappedFile.h>
+
+#include <filesystem>
+#include <vector>
+
+namespace spectr::storage
+{
+/**
+ * @brief Reads a spectrogram storage file mapped to memory.
+ * @details Opening reads only the header and the index, the tiles are loaded by the OS when they
+ * are accessed, so a coarse level of a long spectrogram is read without touching the tiles of
+ * the finer levels. A file which wasn't closed by the writer is opened too, its tiles are found
+ * by scanning the tile headers.
+ */
+class SpectrogramStorageReader
+{
+public:
+    explicit SpectrogramStorageReader(const std::filesystem::path& path);
+
+    const StorageFileHeader& getHeader() const;
+
+    /**
+     * @brief Returns false if the file wasn't closed by the writer.
+     */
+    bool isComplete() const;
+
+    size_t getLevelCount() const;
+
+    size_t getColumnCount(size_t level) const;
+
+    size_t getBinCount(size_t level) const;
+
+    /**
+     * @brief Returns the finest level which has at most the given count of columns per one
+     * column of level 0 shown on a pixel, so zooming out uses the coarser levels.
+     * @param columnsPerPixel Count of level 0 columns covered by one pixel.
+     */
+    size_t chooseLevel(float columnsPerPixel) const;
+
+    /**
+     * @brief Returns the stored values of a tile in the value format of the file, tile column
+     * count columns of tile bin count values.
+     * @return Null if the tile isn't stored.
+     */
+    const std::byte* getTileValues(size_t level,
+                                   TilePlane plane,
+                                   size_t timeTileIndex,
+                                   size_t binTileIndex) const;
+
+    /**
+     * @brief Reads columns of a level as linear magnitudes.
+     * @param values Destination of column count * level bin count values, column after column.
+     */
+    void readColumns(size_t level,
+                     TilePlane plane,
+                     size_t firstColumn,
+                     size_t columnCount,
+                     float* values) const;
+
+private:
+    /**
+     * @brief Tile offsets of one plane of a level, by time tile and bin tile.
+     */
+    struct PlaneIndex
+    {
+        size_t binTileCount = 0;
+        std::vector<uint64_t> tileOffsets; // zero - the tile isn't stored
+    };
+
+    void readIndex();
+
+    void scanTiles();
+
+    void addTile(const TileHeader& tile, uint64_t offset);
+
+    const PlaneIndex& getPlaneIndex(size_t level, TilePlane plane) const;
+
+    size_t getTileByteCount() const;
+
+private:
+    utils::MappedFile m_file;
+    StorageFileHeader m_header;
+    std::vector<PlaneIndex> m_planes;   // max and mean plane of every level
+    std::vector<size_t> m_columnCounts; // of every level
+    utils::DecibelQuantizer m_quantizer;
+};
+}
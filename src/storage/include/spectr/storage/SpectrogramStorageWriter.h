@@ -0,0 +1,103 @@
+#pragma once
+
+#include <spectr/storage/SpectrogramStorageFormat.h>
+
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace spectr::storage
+{
+struct SpectrogramStorageSettings
+{
+    size_t binCount = 0;
+    size_t fftSize = 0;
+    size_t hop = 0;
+    size_t sampleRate = 0;
+    ValueFormat valueFormat = ValueFormat::Float32;
+    size_t tileColumnCount = 256; // power of 2
+    size_t tileBinCount = 256;    // power of 2
+    size_t levelCount = 12;       // the coarsest level has 2^11 times less columns
+    // quantization range of the decibel formats, the magnitudes out of it are clamped: with the
+    // default range the magnitudes below 1 are stored as 1
+    float minDecibels = 0.0f;
+    float maxDecibels = 200.0f;
+};
+
+/**
+ * @brief Writes spectrogram columns to a tiled storage file as they are calculated.
+ * @details The file is only appended, a tile is written as soon as all its columns are known, the
+ * coarser levels of the pyramid are reduced on the fly, so the memory usage doesn't depend on the
+ * length of the spectrogram. The index is written when the file is closed. Not thread-safe.
+ */
+class SpectrogramStorageWriter
+{
+public:
+    SpectrogramStorageWriter(const std::filesystem::path& path,
+                             SpectrogramStorageSettings settings);
+
+    ~SpectrogramStorageWriter();
+
+    SpectrogramStorageWriter(const SpectrogramStorageWriter&) = delete;
+    SpectrogramStorageWriter& operator=(const SpectrogramStorageWriter&) = delete;
+
+    /**
+     * @param magnitudes Column count * bin count linear magnitudes, column after column.
+     */
+    void appendColumns(const float* magnitudes, size_t columnCount);
+
+    /**
+     * @brief Writes the partially filled tiles and the index and closes the file.
+     */
+    void close();
+
+    size_t getBinCount() const;
+
+    /**
+     * @brief Returns count of the appended columns.
+     */
+    size_t getColumnCount() const;
+
+    /**
+     * @brief Returns count of bytes written to the file so far.
+     */
+    size_t getWrittenByteCount() const;
+
+private:
+    struct Level
+    {
+        size_t binCount = 0;
+        size_t columnCount = 0;         // pushed to the level
+        size_t bufferedColumnCount = 0; // columns of the tiles being filled
+        std::vector<float> maxColumns;  // of the tiles being filled, tile column count columns
+        std::vector<float> meanColumns;
+        std::vector<float> pendingMax; // column waiting for its pair to be reduced
+        std::vector<float> pendingMean;
+        bool hasPendingColumn = false;
+        std::vector<float> reducedMax; // column pushed to the next level
+        std::vector<float> reducedMean;
+    };
+
+    void pushColumn(size_t levelIndex, const float* maxValues, const float* meanValues);
+
+    /**
+     * @brief Reduces the pending column of the level with the next column, or alone if the
+     * next column is null, and pushes the result to the next level.
+     */
+    void reduceToNextLevel(size_t levelIndex, const float* maxValues, const float* meanValues);
+
+    void writeTiles(size_t levelIndex);
+
+    void writeTile(const TileHeader& tile, const std::vector<float>& columns, size_t binCount);
+
+private:
+    std::filesystem::path m_path;
+    std::ofstream m_file;
+    utils::DecibelQuantizer m_quantizer;
+    StorageFileHeader m_header;
+    std::vector<Level> m_levels;
+    std::vector<TileIndexEntry> m_index;
+    std::vector<std::byte> m_tileValues; // encoded values of the tile being written
+    size_t m_writtenByteCount = 0;
+};
+}
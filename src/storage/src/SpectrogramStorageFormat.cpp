@@ -0,0 +1,14 @@
+#include <spectr/storage/SpectrogramStorageFormat.h>
+
+namespace spectr::storage
+{
+size_t getLevelBinCount(size_t binCount, size_t tileBinCount, size_t level)
+{
+    // the bins are halved only while the level is wider than one tile
+    for (size_t i = 0; i < level && binCount > tileBinCount; ++i)
+    {
+        binCount = (binCount + 1) / 2;
+    }
+    return binCount;
+}
+}
@@ -0,0 +1,250 @@
+#include <spectr/storage/SpectrogramStorageReader.h>
+
+#include <spectr/utils/Exception.h>
+#include <spectr/utils/Math.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace spectr::storage
+{
+namespace
+{
+constexpr size_t MaxLevelCount = 64;
+}
+
+SpectrogramStorageReader::SpectrogramStorageReader(const std::filesystem::path& path)
+  : m_file{ path }
+{
+    if (m_file.getSize() < sizeof(StorageFileHeader))
+    {
+        throw utils::Exception("Spectrogram storage file is too small: {}", path.string());
+    }
+
+    std::memcpy(&m_header, m_file.getData(), sizeof(m_header));
+    if (!std::equal(std::begin(StorageFileHeader::Magic),
+                    std::end(StorageFileHeader::Magic),
+                    m_header.magic))
+    {
+        throw utils::Exception("Not a spectrogram storage file: {}", path.string());
+    }
+    if (m_header.version != StorageFileHeader::CurrentVersion)
+    {
+        throw utils::Exception("Unsupported spectrogram storage version {}: {}",
+                               m_header.version,
+                               path.string());
+    }
+
+    size_t powerOfTwo = 0;
+    if (!utils::Math::isPowerOfTwo(m_header.tileColumnCount, powerOfTwo) ||
+        !utils::Math::isPowerOfTwo(m_header.tileBinCount, powerOfTwo) ||
+        m_header.levelCount == 0 || m_header.levelCount > MaxLevelCount || m_header.binCount == 0)
+    {
+        throw utils::Exception("Corrupted spectrogram storage header: {}", path.string());
+    }
+
+    m_planes.resize(m_header.levelCount * 2);
+    m_columnCounts.resize(m_header.levelCount, 0);
+    for (size_t i = 0; i < m_planes.size(); ++i)
+    {
+        const auto binCount = getBinCount(i / 2);
+        m_planes[i].binTileCount = (binCount + m_header.tileBinCount - 1) / m_header.tileBinCount;
+    }
+
+    m_quantizer =
+      utils::DecibelQuantizer{ m_header.valueFormat, m_header.minDecibels, m_header.maxDecibels };
+
+    if (isComplete())
+    {
+        readIndex();
+    }
+    else
+    {
+        scanTiles();
+    }
+}
+
+const StorageFileHeader& SpectrogramStorageReader::getHeader() const
+{
+    return m_header;
+}
+
+bool SpectrogramStorageReader::isComplete() const
+{
+    return m_header.indexOffset != 0;
+}
+
+size_t SpectrogramStorageReader::getLevelCount() const
+{
+    return m_header.levelCount;
+}
+
+size_t SpectrogramStorageReader::getColumnCount(size_t level) const
+{
+    return m_columnCounts.at(level);
+}
+
+size_t SpectrogramStorageReader::getBinCount(size_t level) const
+{
+    return getLevelBinCount(m_header.binCount, m_header.tileBinCount, level);
+}
+
+size_t SpectrogramStorageReader::chooseLevel(float columnsPerPixel) const
+{
+    // level L has 2^L times less columns than level 0
+    auto level = static_cast<size_t>(std::max(0.0f, std::floor(std::log2(columnsPerPixel))));
+    level = std::min(level, getLevelCount() - 1);
+
+    while (level > 0 && m_columnCounts[level] == 0)
+    {
+        --level;
+    }
+    return level;
+}
+
+const std::byte* SpectrogramStorageReader::getTileValues(size_t level,
+                                                         TilePlane plane,
+                                                         size_t timeTileIndex,
+                                                         size_t binTileIndex) const
+{
+    if (level >= getLevelCount())
+    {
+        return nullptr;
+    }
+
+    const auto& planeIndex = getPlaneIndex(level, plane);
+    const auto tileIndex = timeTileIndex * planeIndex.binTileCount + binTileIndex;
+    if (binTileIndex >= planeIndex.binTileCount || tileIndex >= planeIndex.tileOffsets.size())
+    {
+        return nullptr;
+    }
+
+    const auto offset = planeIndex.tileOffsets[tileIndex];
+    return offset != 0 ? m_file.getData() + offset : nullptr;
+}
+
+void SpectrogramStorageReader::readColumns(size_t level,
+                                           TilePlane plane,
+                                           size_t firstColumn,
+                                           size_t columnCount,
+                                           float* values) const
+{
+    if (firstColumn + columnCount > getColumnCount(level))
+    {
+        throw utils::Exception("Columns [{}, {}) are out of level {} of {} columns.",
+                               firstColumn,
+                               firstColumn + columnCount,
+                               level,
+                               getColumnCount(level));
+    }
+
+    const size_t tileColumnCount = m_header.tileColumnCount;
+    const size_t tileBinCount = m_header.tileBinCount;
+    const auto binCount = getBinCount(level);
+    const auto binTileCount = getPlaneIndex(level, plane).binTileCount;
+    const auto valueSize = getValueSize(m_header.valueFormat);
+
+    for (size_t i = 0; i < columnCount; ++i)
+    {
+        const auto column = firstColumn + i;
+        const auto timeTileIndex = column / tileColumnCount;
+        const auto tileColumn = column % tileColumnCount;
+
+        for (size_t binTileIndex = 0; binTileIndex < binTileCount; ++binTileIndex)
+        {
+            const auto firstBin = binTileIndex * tileBinCount;
+            const auto count = std::min(tileBinCount, binCount - firstBin);
+            auto* out = values + i * binCount + firstBin;
+
+            const auto* tileValues = getTileValues(level, plane, timeTileIndex, binTileIndex);
+            if (!tileValues)
+            {
+                std::fill_n(out, count, 0.0f);
+                continue;
+            }
+
+            m_quantizer.decode(tileValues + tileColumn * tileBinCount * valueSize, count, out);
+        }
+    }
+}
+
+void SpectrogramStorageReader::readIndex()
+{
+    // the sizes come from the file, so they are checked without overflowing
+    if (m_header.indexOffset > m_file.getSize() ||
+        m_header.tileCount > (m_file.getSize() - m_header.indexOffset) / sizeof(TileIndexEntry))
+    {
+        throw utils::Exception("Spectrogram storage index is out of the file.");
+    }
+
+    for (size_t i = 0; i < m_header.tileCount; ++i)
+    {
+        TileIndexEntry entry;
+        std::memcpy(&entry,
+                    m_file.getData() + m_header.indexOffset + i * sizeof(TileIndexEntry),
+                    sizeof(entry));
+        if (entry.offset > m_header.indexOffset ||
+            getTileByteCount() > m_header.indexOffset - entry.offset)
+        {
+            throw utils::Exception("Spectrogram storage tile {} is out of the file.", i);
+        }
+        addTile(entry.tile, entry.offset);
+    }
+}
+
+void SpectrogramStorageReader::scanTiles()
+{
+    // the last tile may be partially written, only the whole tiles are taken
+    auto position = sizeof(StorageFileHeader);
+    while (position + sizeof(TileHeader) + getTileByteCount() <= m_file.getSize())
+    {
+        TileHeader tile;
+        std::memcpy(&tile, m_file.getData() + position, sizeof(tile));
+        addTile(tile, position + sizeof(TileHeader));
+        position += sizeof(TileHeader) + getTileByteCount();
+    }
+}
+
+void SpectrogramStorageReader::addTile(const TileHeader& tile, uint64_t offset)
+{
+    if (tile.level >= getLevelCount() || tile.plane > TilePlane::Mean ||
+        tile.columnCount > m_header.tileColumnCount)
+    {
+        throw utils::Exception("Corrupted spectrogram storage tile at offset {}.", offset);
+    }
+
+    auto& planeIndex = m_planes[tile.level * 2 + static_cast<size_t>(tile.plane)];
+    // a file can't hold more tiles than fit into it, it bounds the index size below
+    if (tile.binTileIndex >= planeIndex.binTileCount ||
+        tile.timeTileIndex > m_file.getSize() / getTileByteCount())
+    {
+        throw utils::Exception("Corrupted spectrogram storage tile at offset {}.", offset);
+    }
+
+    const auto tileIndex = tile.timeTileIndex * planeIndex.binTileCount + tile.binTileIndex;
+    if (tileIndex >= planeIndex.tileOffsets.size())
+    {
+        planeIndex.tileOffsets.resize(tileIndex + 1, 0);
+    }
+    planeIndex.tileOffsets[tileIndex] = offset;
+
+    const auto tileEndColumn = tile.timeTileIndex * m_header.tileColumnCount + tile.columnCount;
+    m_columnCounts[tile.level] = std::max<size_t>(m_columnCounts[tile.level], tileEndColumn);
+}
+
+const SpectrogramStorageReader::PlaneIndex& SpectrogramStorageReader::getPlaneIndex(
+  size_t level,
+  TilePlane plane) const
+{
+    // level 0 isn't reduced, so its only plane is both the max and the mean
+    const auto planeIndex = level > 0 ? static_cast<size_t>(plane) : 0;
+    return m_planes[level * 2 + planeIndex];
+}
+
+size_t SpectrogramStorageReader::getTileByteCount() const
+{
+    return size_t{ m_header.tileColumnCount } * m_header.tileBinCount *
+           getValueSize(m_header.valueFormat);
+}
+}
@@ -0,0 +1,284 @@
+#include <spectr/storage/SpectrogramStorageWriter.h>
+
+#include <spectr/utils/Exception.h>
+#include <spectr/utils/Math.h>
+
+#include <algorithm>
+#include <iostream>
+
+namespace spectr::storage
+{
+SpectrogramStorageWriter::SpectrogramStorageWriter(const std::filesystem::path& path,
+                                                   SpectrogramStorageSettings settings)
+  : m_path{ path }
+  , m_quantizer{ settings.valueFormat, settings.minDecibels, settings.maxDecibels }
+{
+    size_t powerOfTwo = 0;
+    if (settings.binCount == 0)
+    {
+        throw utils::Exception("Spectrogram bin count can't be zero.");
+    }
+    if (!utils::Math::isPowerOfTwo(settings.tileColumnCount, powerOfTwo) ||
+        !utils::Math::isPowerOfTwo(settings.tileBinCount, powerOfTwo) ||
+        settings.tileColumnCount < 4 || settings.tileBinCount < 4)
+    {
+        throw utils::Exception("Tile size must be powers of 2, at least 4, got {} x {}.",
+                               settings.tileColumnCount,
+                               settings.tileBinCount);
+    }
+    if (settings.levelCount == 0)
+    {
+        throw utils::Exception("Spectrogram storage needs at least one level.");
+    }
+    m_file.open(path, std::ios_base::binary | std::ios_base::trunc);
+    if (!m_file)
+    {
+        throw utils::Exception("Failed to create the spectrogram storage file: {}", path.string());
+    }
+
+    std::copy(std::begin(StorageFileHeader::Magic),
+              std::end(StorageFileHeader::Magic),
+              m_header.magic);
+    m_header.version = StorageFileHeader::CurrentVersion;
+    m_header.valueFormat = settings.valueFormat;
+    m_header.binCount = static_cast<uint32_t>(settings.binCount);
+    m_header.tileColumnCount = static_cast<uint32_t>(settings.tileColumnCount);
+    m_header.tileBinCount = static_cast<uint32_t>(settings.tileBinCount);
+    m_header.levelCount = static_cast<uint32_t>(settings.levelCount);
+    m_header.fftSize = static_cast<uint32_t>(settings.fftSize);
+    m_header.hop = static_cast<uint32_t>(settings.hop);
+    m_header.sampleRate = static_cast<uint32_t>(settings.sampleRate);
+    m_header.minDecibels = settings.minDecibels;
+    m_header.maxDecibels = settings.maxDecibels;
+
+    m_file.write(reinterpret_cast<const char*>(&m_header), sizeof(m_header));
+    m_writtenByteCount = sizeof(m_header);
+
+    m_levels.resize(settings.levelCount);
+    for (size_t i = 0; i < m_levels.size(); ++i)
+    {
+        auto& level = m_levels[i];
+        level.binCount = getLevelBinCount(settings.binCount, settings.tileBinCount, i);
+        level.maxColumns.resize(settings.tileColumnCount * level.binCount);
+        level.meanColumns.resize(i > 0 ? settings.tileColumnCount * level.binCount : 0);
+        level.pendingMax.resize(level.binCount);
+        level.pendingMean.resize(level.binCount);
+
+        const auto nextBinCount = getLevelBinCount(settings.binCount, settings.tileBinCount, i + 1);
+        level.reducedMax.resize(nextBinCount);
+        level.reducedMean.resize(nextBinCount);
+    }
+
+    m_tileValues.resize(settings.tileColumnCount * settings.tileBinCount *
+                        getValueSize(settings.valueFormat));
+}
+
+SpectrogramStorageWriter::~SpectrogramStorageWriter()
+{
+    try
+    {
+        close();
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << "Failed to close the spectrogram storage file: " << ex.what() << std::endl;
+    }
+}
+
+void SpectrogramStorageWriter::appendColumns(const float* magnitudes, size_t columnCount)
+{
+    if (!m_file.is_open())
+    {
+        throw utils::Exception("Spectrogram storage file is closed: {}", m_path.string());
+    }
+
+    for (size_t i = 0; i < columnCount; ++i)
+    {
+        const auto* column = magnitudes + i * m_header.binCount;
+        pushColumn(0, column, column);
+    }
+
+    if (!m_file)
+    {
+        throw utils::Exception("Failed to write the spectrogram storage file: {}", m_path.string());
+    }
+}
+
+void SpectrogramStorageWriter::close()
+{
+    if (!m_file.is_open())
+    {
+        return;
+    }
+
+    // the columns of a level are complete once the finer level has pushed its last column
+    for (size_t i = 0; i < m_levels.size(); ++i)
+    {
+        if (m_levels[i].bufferedColumnCount > 0)
+        {
+            writeTiles(i);
+        }
+        if (m_levels[i].hasPendingColumn && i + 1 < m_levels.size())
+        {
+            reduceToNextLevel(i, nullptr, nullptr);
+        }
+    }
+
+    m_header.columnCount = m_levels.front().columnCount;
+    m_header.indexOffset = m_writtenByteCount;
+    m_header.tileCount = m_index.size();
+
+    m_file.write(reinterpret_cast<const char*>(m_index.data()),
+                 m_index.size() * sizeof(TileIndexEntry));
+    m_writtenByteCount += m_index.size() * sizeof(TileIndexEntry);
+
+    m_file.seekp(0);
+    m_file.write(reinterpret_cast<const char*>(&m_header), sizeof(m_header));
+    m_file.close();
+    if (!m_file)
+    {
+        throw utils::Exception("Failed to finish the spectrogram storage file: {}",
+                               m_path.string());
+    }
+}
+
+size_t SpectrogramStorageWriter::getBinCount() const
+{
+    return m_header.binCount;
+}
+
+size_t SpectrogramStorageWriter::getColumnCount() const
+{
+    return m_levels.front().columnCount;
+}
+
+size_t SpectrogramStorageWriter::getWrittenByteCount() const
+{
+    return m_writtenByteCount;
+}
+
+void SpectrogramStorageWriter::pushColumn(size_t levelIndex,
+                                          const float* maxValues,
+                                          const float* meanValues)
+{
+    auto& level = m_levels[levelIndex];
+
+    const auto columnOffset = level.bufferedColumnCount * level.binCount;
+    std::copy_n(maxValues, level.binCount, level.maxColumns.begin() + columnOffset);
+    if (levelIndex > 0)
+    {
+        std::copy_n(meanValues, level.binCount, level.meanColumns.begin() + columnOffset);
+    }
+
+    ++level.columnCount;
+    ++level.bufferedColumnCount;
+    if (level.bufferedColumnCount == m_header.tileColumnCount)
+    {
+        writeTiles(levelIndex);
+    }
+
+    if (levelIndex + 1 == m_levels.size())
+    {
+        return;
+    }
+
+    if (!level.hasPendingColumn)
+    {
+        std::copy_n(maxValues, level.binCount, level.pendingMax.begin());
+        std::copy_n(meanValues, level.binCount, level.pendingMean.begin());
+        level.hasPendingColumn = true;
+        return;
+    }
+
+    reduceToNextLevel(levelIndex, maxValues, meanValues);
+}
+
+void SpectrogramStorageWriter::reduceToNextLevel(size_t levelIndex,
+                                                 const float* maxValues,
+                                                 const float* meanValues)
+{
+    auto& level = m_levels[levelIndex];
+    const auto nextBinCount = level.reducedMax.size();
+    const auto binsPerValue = nextBinCount < level.binCount ? 2 : 1;
+
+    for (size_t i = 0; i < nextBinCount; ++i)
+    {
+        const auto first = i * binsPerValue;
+        const auto last = std::min(first + binsPerValue, level.binCount);
+
+        auto maxValue = level.pendingMax[first];
+        auto sum = 0.0f;
+        size_t count = 0;
+        for (auto bin = first; bin < last; ++bin)
+        {
+            maxValue = std::max(maxValue, level.pendingMax[bin]);
+            sum += level.pendingMean[bin];
+            ++count;
+            if (maxValues)
+            {
+                maxValue = std::max(maxValue, maxValues[bin]);
+                sum += meanValues[bin];
+                ++count;
+            }
+        }
+
+        level.reducedMax[i] = maxValue;
+        level.reducedMean[i] = sum / count;
+    }
+
+    level.hasPendingColumn = false;
+    pushColumn(levelIndex + 1, level.reducedMax.data(), level.reducedMean.data());
+}
+
+void SpectrogramStorageWriter::writeTiles(size_t levelIndex)
+{
+    auto& level = m_levels[levelIndex];
+
+    TileHeader tile;
+    tile.level = static_cast<uint32_t>(levelIndex);
+    tile.columnCount = static_cast<uint32_t>(level.bufferedColumnCount);
+    tile.timeTileIndex = (level.columnCount - level.bufferedColumnCount) / m_header.tileColumnCount;
+
+    const auto binTileCount = (level.binCount + m_header.tileBinCount - 1) / m_header.tileBinCount;
+    for (size_t i = 0; i < binTileCount; ++i)
+    {
+        tile.binTileIndex = static_cast<uint32_t>(i);
+
+        tile.plane = TilePlane::Max;
+        writeTile(tile, level.maxColumns, level.binCount);
+
+        // the values of level 0 aren't reduced, their mean is the same
+        if (levelIndex > 0)
+        {
+            tile.plane = TilePlane::Mean;
+            writeTile(tile, level.meanColumns, level.binCount);
+        }
+    }
+
+    level.bufferedColumnCount = 0;
+}
+
+void SpectrogramStorageWriter::writeTile(const TileHeader& tile,
+                                         const std::vector<float>& columns,
+                                         size_t binCount)
+{
+    const size_t tileBinCount = m_header.tileBinCount;
+    const auto firstBin = tile.binTileIndex * tileBinCount;
+    const auto tileValueCount = std::min(tileBinCount, binCount - firstBin);
+    const auto valueSize = getValueSize(m_header.valueFormat);
+
+    // the values outside the level stay zeros
+    std::fill(m_tileValues.begin(), m_tileValues.end(), std::byte{ 0 });
+    for (size_t i = 0; i < tile.columnCount; ++i)
+    {
+        const auto* values = columns.data() + i * binCount + firstBin;
+        m_quantizer.encode(
+          values, tileValueCount, m_tileValues.data() + i * tileBinCount * valueSize);
+    }
+
+    m_file.write(reinterpret_cast<const char*>(&tile), sizeof(tile));
+    m_index.push_back(TileIndexEntry{ .tile = tile, .offset = m_writtenByteCount + sizeof(tile) });
+    m_file.write(reinterpret_cast<const char*>(m_tileValues.data()), m_tileValues.size());
+    m_writtenByteCount += sizeof(tile) + m_tileValues.size();
+}
+}
@@ -0,0 +1,201 @@
+#include <spectr/storage/SpectrogramStorageReader.h>
+#include <spectr/storage/SpectrogramStorageWriter.h>
+#include <spectr/utils/Exception.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace spectr::storage::test
+{
+namespace
+{
+constexpr size_t BinCount = 20;
+constexpr size_t ColumnCount = 37;
+
+std::filesystem::path getTempPath(const std::string& name)
+{
+    return std::filesystem::temp_directory_path() / name;
+}
+
+SpectrogramStorageSettings getSettings(ValueFormat format)
+{
+    SpectrogramStorageSettings settings;
+    settings.binCount = BinCount;
+    settings.fftSize = BinCount * 2;
+    settings.hop = BinCount;
+    settings.sampleRate = 1000;
+    settings.valueFormat = format;
+    settings.tileColumnCount = 8;
+    settings.tileBinCount = 8;
+    settings.levelCount = 4;
+    settings.minDecibels = -20.0f;
+    settings.maxDecibels = 80.0f;
+    return settings;
+}
+
+std::vector<float> getMagnitudes()
+{
+    std::vector<float> magnitudes(ColumnCount * BinCount);
+    for (size_t column = 0; column < ColumnCount; ++column)
+    {
+        for (size_t bin = 0; bin < BinCount; ++bin)
+        {
+            magnitudes[column * BinCount + bin] = 1.0f + column + (bin % 7) * 10.0f;
+        }
+    }
+    return magnitudes;
+}
+
+void write(const std::filesystem::path& path, ValueFormat format)
+{
+    const auto magnitudes = getMagnitudes();
+    SpectrogramStorageWriter writer{ path, getSettings(format) };
+
+    // the columns come in uneven chunks like from a capture
+    writer.appendColumns(magnitudes.data(), 5);
+    writer.appendColumns(magnitudes.data() + 5 * BinCount, ColumnCount - 5);
+    EXPECT_EQ(writer.getColumnCount(), ColumnCount);
+    writer.close();
+}
+}
+
+TEST(SpectrogramStorage, ReadsWrittenColumns)
+{
+    const auto path = getTempPath("spectr_storage_float.spectr");
+    write(path, ValueFormat::Float32);
+
+    const SpectrogramStorageReader reader{ path };
+    EXPECT_TRUE(reader.isComplete());
+    EXPECT_EQ(reader.getHeader().columnCount, ColumnCount);
+    EXPECT_EQ(reader.getColumnCount(0), ColumnCount);
+    EXPECT_EQ(reader.getBinCount(0), BinCount);
+
+    std::vector<float> values(ColumnCount * BinCount);
+    reader.readColumns(0, TilePlane::Max, 0, ColumnCount, values.data());
+    EXPECT_EQ(values, getMagnitudes());
+
+    std::vector<float> column(BinCount);
+    reader.readColumns(0, TilePlane::Mean, 33, 1, column.data());
+    EXPECT_TRUE(std::equal(column.begin(), column.end(), getMagnitudes().begin() + 33 * BinCount));
+
+    EXPECT_THROW(reader.readColumns(0, TilePlane::Max, ColumnCount, 1, column.data()),
+                 std::exception);
+}
+
+TEST(SpectrogramStorage, ReducesPyramidLevels)
+{
+    const auto path = getTempPath("spectr_storage_pyramid.spectr");
+    write(path, ValueFormat::Float32);
+    const SpectrogramStorageReader reader{ path };
+    const auto magnitudes = getMagnitudes();
+
+    // the bins are halved while the finer level is wider than one tile of 8 bins
+    EXPECT_EQ(reader.getColumnCount(1), 19);
+    EXPECT_EQ(reader.getBinCount(1), 10);
+    EXPECT_EQ(reader.getColumnCount(2), 10);
+    EXPECT_EQ(reader.getBinCount(2), 5);
+    EXPECT_EQ(reader.getColumnCount(3), 5);
+    EXPECT_EQ(reader.getBinCount(3), 5);
+
+    std::vector<float> maxValues(reader.getColumnCount(1) * reader.getBinCount(1));
+    std::vector<float> meanValues(maxValues.size());
+    reader.readColumns(1, TilePlane::Max, 0, reader.getColumnCount(1), maxValues.data());
+    reader.readColumns(1, TilePlane::Mean, 0, reader.getColumnCount(1), meanValues.data());
+
+    const auto at = [&](size_t column, size_t bin) { return magnitudes[column * BinCount + bin]; };
+    EXPECT_FLOAT_EQ(maxValues[3 * 10 + 2], std::max({ at(6, 4), at(6, 5), at(7, 4), at(7, 5) }));
+    EXPECT_FLOAT_EQ(meanValues[3 * 10 + 2], (at(6, 4) + at(6, 5) + at(7, 4) + at(7, 5)) / 4.0f);
+
+    // the last odd column is reduced alone
+    EXPECT_FLOAT_EQ(maxValues[18 * 10], std::max(at(36, 0), at(36, 1)));
+
+    EXPECT_EQ(reader.chooseLevel(0.5f), 0);
+    EXPECT_EQ(reader.chooseLevel(2.5f), 1);
+    EXPECT_EQ(reader.chooseLevel(1000.0f), 3);
+}
+
+TEST(SpectrogramStorage, QuantizesDecibels)
+{
+    const auto path = getTempPath("spectr_storage_db16.spectr");
+    write(path, ValueFormat::Decibel16);
+
+    const SpectrogramStorageReader reader{ path };
+    std::vector<float> values(ColumnCount * BinCount);
+    reader.readColumns(0, TilePlane::Max, 0, ColumnCount, values.data());
+
+    const auto magnitudes = getMagnitudes();
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        // 100 dB in 65535 steps
+        EXPECT_NEAR(values[i], magnitudes[i], magnitudes[i] * 2e-4f);
+    }
+}
+
+TEST(SpectrogramStorage, OpensUnclosedFile)
+{
+    const auto path = getTempPath("spectr_storage_unclosed.spectr");
+    write(path, ValueFormat::Float32);
+
+    // drop the index and the header fields written on close, like after a crash
+    StorageFileHeader header;
+    {
+        std::ifstream file{ path, std::ios_base::binary };
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    }
+    std::filesystem::resize_file(path, header.indexOffset);
+    header.columnCount = 0;
+    header.indexOffset = 0;
+    header.tileCount = 0;
+    {
+        std::fstream file{ path, std::ios_base::binary | std::ios_base::in | std::ios_base::out };
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+
+    const SpectrogramStorageReader reader{ path };
+    EXPECT_FALSE(reader.isComplete());
+    EXPECT_EQ(reader.getColumnCount(0), ColumnCount);
+
+    std::vector<float> values(ColumnCount * BinCount);
+    reader.readColumns(0, TilePlane::Max, 0, ColumnCount, values.data());
+    EXPECT_EQ(values, getMagnitudes());
+}
+
+TEST(SpectrogramStorage, RejectsCorruptedIndex)
+{
+    const auto path = getTempPath("spectr_storage_corrupted.spectr");
+    write(path, ValueFormat::Float32);
+
+    StorageFileHeader header;
+    {
+        std::ifstream file{ path, std::ios_base::binary };
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    }
+    const auto indexOffset = header.indexOffset;
+
+    // the tile count wraps the index size around, the time tile index is far out of the file
+    header.tileCount = UINT64_MAX / sizeof(TileIndexEntry) + 2;
+    {
+        std::fstream file{ path, std::ios_base::binary | std::ios_base::in | std::ios_base::out };
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+    EXPECT_THROW(SpectrogramStorageReader{ path }, utils::Exception);
+
+    header.tileCount = 1;
+    TileIndexEntry entry;
+    {
+        std::fstream file{ path, std::ios_base::binary | std::ios_base::in | std::ios_base::out };
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.seekg(indexOffset);
+        file.read(reinterpret_cast<char*>(&entry), sizeof(entry));
+        entry.tile.timeTileIndex = UINT64_MAX / 2;
+        file.seekp(indexOffset);
+        file.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+    }
+    EXPECT_THROW(SpectrogramStorageReader{ path }, utils::Exception);
+}
+}
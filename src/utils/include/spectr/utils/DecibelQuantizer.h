@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace spectr::utils
+{
+/**
+ * @brief How the magnitudes are stored, e.g. in a file or in a GPU buffer.
+ */
+enum class ValueFormat : uint32_t
+{
+    Float32,   // linear magnitudes as they are
+    Decibel8,  // decibels in [min, max] quantized to uint8
+    Decibel16, // decibels in [min, max] quantized to uint16
+};
+
+/**
+ * @brief Returns size of a stored value in bytes.
+ */
+size_t getValueSize(ValueFormat format);
+
+/**
+ * @brief Converts the linear magnitudes to the values of a format and back.
+ * @details The decibel formats map [min, max] decibels evenly to the codes, the magnitudes
+ * outside the range are clamped to it, zero magnitudes are stored as the min decibels.
+ */
+class DecibelQuantizer
+{
+public:
+    /**
+     * @param minDecibels Ignored by Float32, the decibel formats throw utils::Exception unless it
+     * is below maxDecibels.
+     */
+    DecibelQuantizer(ValueFormat format = ValueFormat::Float32,
+                     float minDecibels = 0.0f,
+                     float maxDecibels = 0.0f);
+
+    /**
+     * @param out Count x getValueSize(format) bytes.
+     */
+    void encode(const float* magnitudes, size_t count, std::byte* out) const;
+
+    /**
+     * @param values Count x getValueSize(format) bytes.
+     */
+    void decode(const std::byte* values, size_t count, float* magnitudes) const;
+
+    ValueFormat getFormat() const;
+
+private:
+    ValueFormat m_format;
+    float m_minDecibels;
+    float m_maxDecibels;
+    std::vector<float> m_magnitudeTable; // magnitudes of the decibel codes
+};
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace spectr::utils
+{
+/**
+ * @brief Preallocated frame of the ring, owned by the producer after tryClaim() until publish()
+ * and by the consumer after it's returned by front() until release().
+ */
+struct FrameRingSlot
+{
+    size_t frameIndex = 0;
+    float* values = nullptr; // frame value count floats, aligned to FrameRing::Alignment
+    const float* sharedValues = nullptr; // values kept by the producer, valid until release()
+    float maxValue = 0.0f;   // optional, e.g. for the normalization of the values
+};
+
+/**
+ * @brief Bounded lock-free single-producer single-consumer queue of fixed size float frames.
+ * @details All frames are allocated once in the constructor and reused, so passing a frame
+ * doesn't allocate. Publishing and releasing use release/acquire ordering of the slot indices:
+ * the consumer sees the frame values written before publish(), the producer reuses a slot only
+ * after the consumer has released it. Only one thread may call the producer methods and only one
+ * thread may call the consumer methods. A ring with zero frame value count owns no values, the
+ * producer passes its own memory through the shared values of the slots and may reuse it once
+ * the slot is released.
+ */
+class FrameRing
+{
+public:
+    static constexpr size_t Alignment = 64; // cache line, enough for any SIMD loads
+
+    FrameRing(size_t slotCount, size_t frameValueCount);
+
+    FrameRing(const FrameRing&) = delete;
+    FrameRing& operator=(const FrameRing&) = delete;
+
+    /**
+     * @brief Producer: returns the next free slot to fill, or nullptr if the ring is full.
+     * Repeated calls return the same slot until it's published.
+     */
+    FrameRingSlot* tryClaim();
+
+    /**
+     * @brief Producer: makes the claimed slot visible to the consumer.
+     */
+    void publish();
+
+    /**
+     * @brief Producer: returns count of the slots which can be claimed and published in a row.
+     */
+    size_t getFreeSlotCount() const;
+
+    /**
+     * @brief Consumer: returns the published slot at the offset from the oldest one, or nullptr
+     * if there are not so many published slots.
+     */
+    const FrameRingSlot* front(size_t offset = 0);
+
+    /**
+     * @brief Consumer: returns the oldest published slots to the producer.
+     */
+    void release(size_t count = 1);
+
+    /**
+     * @brief Any thread: returns count of the published slots which aren't released yet, an
+     * estimate if the producer or the consumer runs meanwhile.
+     */
+    size_t getQueuedSlotCount() const;
+
+    size_t getSlotCount() const;
+
+    size_t getFrameValueCount() const;
+
+private:
+    struct AlignedDeleter
+    {
+        void operator()(float* values) const;
+    };
+
+private:
+    const size_t m_slotCount;
+    const size_t m_frameValueCount;
+    std::unique_ptr<float[], AlignedDeleter> m_values;
+    std::vector<FrameRingSlot> m_slots;
+
+    // monotonic counters, the slot of a counter is counter % slot count
+    alignas(Alignment) std::atomic<size_t> m_writeIndex = 0; // written by the producer only
+    alignas(Alignment) std::atomic<size_t> m_readIndex = 0;  // written by the consumer only
+};
+}
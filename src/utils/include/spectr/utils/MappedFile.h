@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+
+namespace spectr::utils
+{
+/**
+ * @brief Read-only memory mapping of a whole file.
+ * @details The pages are loaded by the OS on the first access, so opening a big file is instant
+ * and only the touched parts of it are ever read.
+ */
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::filesystem::path& path);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Returns the first byte of the file, null if the file is empty.
+     */
+    const std::byte* getData() const;
+
+    size_t getSize() const;
+
+private:
+    const std::byte* m_data = nullptr;
+    size_t m_size = 0;
+};
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+namespace spectr::utils
+{
+/**
+ * @brief Format of the RTSA heatmap cell: intensity and age of the magnitude cell.
+ */
+enum class RtsaStorageFormat
+{
+    Float2,    // two 32-bit floats, 8 bytes per cell
+    Unorm16x2, // two 16-bit normalized values packed in uint, 4 bytes per cell
+};
+}
@@ -0,0 +1,128 @@
+#include <spectr/utils/DecibelQuantizer.h>
+
+#include <spectr/utils/Exception.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace spectr::utils
+{
+namespace
+{
+template<typename T>
+void encodeDecibels(const float* magnitudes,
+                    size_t count,
+                    float minDecibels,
+                    float maxDecibels,
+                    T* codes)
+{
+    constexpr auto MaxCode = static_cast<float>(std::numeric_limits<T>::max());
+    constexpr auto MinMagnitude = 1e-20f; // zero magnitudes are stored as the min decibels
+
+    const auto scale = MaxCode / (maxDecibels - minDecibels);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const auto decibels = 20.0f * std::log10(std::max(magnitudes[i], MinMagnitude));
+        const auto code = std::round((decibels - minDecibels) * scale);
+        codes[i] = static_cast<T>(std::clamp(code, 0.0f, MaxCode));
+    }
+}
+
+template<typename T>
+void decodeDecibels(const T* codes,
+                    size_t count,
+                    const std::vector<float>& table,
+                    float* magnitudes)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        magnitudes[i] = table[codes[i]];
+    }
+}
+}
+
+size_t getValueSize(ValueFormat format)
+{
+    switch (format)
+    {
+        case ValueFormat::Decibel8:
+            return sizeof(uint8_t);
+        case ValueFormat::Decibel16:
+            return sizeof(uint16_t);
+        case ValueFormat::Float32:
+            return sizeof(float);
+    }
+    return sizeof(float);
+}
+
+DecibelQuantizer::DecibelQuantizer(ValueFormat format, float minDecibels, float maxDecibels)
+  : m_format{ format }
+  , m_minDecibels{ minDecibels }
+  , m_maxDecibels{ maxDecibels }
+{
+    if (m_format == ValueFormat::Float32)
+    {
+        return;
+    }
+
+    if (!(m_maxDecibels > m_minDecibels))
+    {
+        throw utils::Exception("Invalid decibel range: [{}, {}].", m_minDecibels, m_maxDecibels);
+    }
+
+    const size_t maxCode = m_format == ValueFormat::Decibel8
+                             ? std::numeric_limits<uint8_t>::max()
+                             : std::numeric_limits<uint16_t>::max();
+    const auto decibelsPerCode = (m_maxDecibels - m_minDecibels) / maxCode;
+
+    m_magnitudeTable.resize(maxCode + 1);
+    for (size_t i = 0; i < m_magnitudeTable.size(); ++i)
+    {
+        const auto decibels = m_minDecibels + i * decibelsPerCode;
+        m_magnitudeTable[i] = std::pow(10.0f, decibels / 20.0f);
+    }
+}
+
+void DecibelQuantizer::encode(const float* magnitudes, size_t count, std::byte* out) const
+{
+    switch (m_format)
+    {
+        case ValueFormat::Float32:
+            std::memcpy(out, magnitudes, count * sizeof(float));
+            break;
+        case ValueFormat::Decibel8:
+            encodeDecibels(
+              magnitudes, count, m_minDecibels, m_maxDecibels, reinterpret_cast<uint8_t*>(out));
+            break;
+        case ValueFormat::Decibel16:
+            encodeDecibels(
+              magnitudes, count, m_minDecibels, m_maxDecibels, reinterpret_cast<uint16_t*>(out));
+            break;
+    }
+}
+
+void DecibelQuantizer::decode(const std::byte* values, size_t count, float* magnitudes) const
+{
+    switch (m_format)
+    {
+        case ValueFormat::Float32:
+            std::memcpy(magnitudes, values, count * sizeof(float));
+            break;
+        case ValueFormat::Decibel8:
+            decodeDecibels(
+              reinterpret_cast<const uint8_t*>(values), count, m_magnitudeTable, magnitudes);
+            break;
+        case ValueFormat::Decibel16:
+            decodeDecibels(
+              reinterpret_cast<const uint16_t*>(values), count, m_magnitudeTable, magnitudes);
+            break;
+    }
+}
+
+ValueFormat DecibelQuantizer::getFormat() const
+{
+    return m_format;
+}
+}
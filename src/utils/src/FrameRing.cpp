@@ -0,0 +1,100 @@
+#include <spectr/utils/FrameRing.h>
+
+#include <spectr/utils/Assert.h>
+
+namespace spectr::utils
+{
+namespace
+{
+size_t alignUp(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+}
+
+FrameRing::FrameRing(size_t slotCount, size_t frameValueCount)
+  : m_slotCount{ slotCount }
+  , m_frameValueCount{ frameValueCount }
+  , m_slots(slotCount)
+{
+    ASSERT(m_slotCount > 0);
+    if (m_frameValueCount == 0)
+    {
+        return;
+    }
+
+    // every frame starts at an aligned address
+    const auto frameStride = alignUp(m_frameValueCount * sizeof(float), Alignment) / sizeof(float);
+    m_values.reset(static_cast<float*>(::operator new(
+      frameStride * m_slotCount * sizeof(float), std::align_val_t{ Alignment })));
+
+    for (size_t i = 0; i < m_slotCount; ++i)
+    {
+        m_slots[i].values = m_values.get() + i * frameStride;
+    }
+}
+
+FrameRingSlot* FrameRing::tryClaim()
+{
+    const auto writeIndex = m_writeIndex.load(std::memory_order_relaxed);
+    if (writeIndex - m_readIndex.load(std::memory_order_acquire) == m_slotCount)
+    {
+        return nullptr;
+    }
+
+    return &m_slots[writeIndex % m_slotCount];
+}
+
+void FrameRing::publish()
+{
+    const auto writeIndex = m_writeIndex.load(std::memory_order_relaxed);
+    ASSERT(writeIndex - m_readIndex.load(std::memory_order_acquire) < m_slotCount);
+    m_writeIndex.store(writeIndex + 1, std::memory_order_release);
+}
+
+size_t FrameRing::getFreeSlotCount() const
+{
+    const auto writeIndex = m_writeIndex.load(std::memory_order_relaxed);
+    return m_slotCount - (writeIndex - m_readIndex.load(std::memory_order_acquire));
+}
+
+const FrameRingSlot* FrameRing::front(size_t offset)
+{
+    const auto readIndex = m_readIndex.load(std::memory_order_relaxed);
+    if (m_writeIndex.load(std::memory_order_acquire) - readIndex <= offset)
+    {
+        return nullptr;
+    }
+
+    return &m_slots[(readIndex + offset) % m_slotCount];
+}
+
+void FrameRing::release(size_t count)
+{
+    const auto readIndex = m_readIndex.load(std::memory_order_relaxed);
+    ASSERT(m_writeIndex.load(std::memory_order_acquire) - readIndex >= count);
+    m_readIndex.store(readIndex + count, std::memory_order_release);
+}
+
+size_t FrameRing::getQueuedSlotCount() const
+{
+    // the read index never passes the write index loaded after it
+    const auto readIndex = m_readIndex.load(std::memory_order_acquire);
+    return m_writeIndex.load(std::memory_order_acquire) - readIndex;
+}
+
+size_t FrameRing::getSlotCount() const
+{
+    return m_slotCount;
+}
+
+size_t FrameRing::getFrameValueCount() const
+{
+    return m_frameValueCount;
+}
+
+void FrameRing::AlignedDeleter::operator()(float* values) const
+{
+    ::operator delete(values, std::align_val_t{ Alignment });
+}
+}
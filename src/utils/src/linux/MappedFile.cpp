@@ -0,0 +1,63 @@
+#if OS_LINUX
+
+#include <spectr/utils/MappedFile.h>
+
+#include <spectr/utils/Exception.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace spectr::utils
+{
+MappedFile::MappedFile(const std::filesystem::path& path)
+{
+    const int file = open(path.c_str(), O_RDONLY);
+    if (file < 0)
+    {
+        throw Exception("Failed to open file: {}", path.string());
+    }
+
+    struct stat status = {};
+    if (fstat(file, &status) != 0)
+    {
+        close(file);
+        throw Exception("Failed to get size of file: {}", path.string());
+    }
+
+    m_size = static_cast<size_t>(status.st_size);
+    if (m_size > 0)
+    {
+        void* data = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, file, 0);
+        if (data == MAP_FAILED)
+        {
+            close(file);
+            throw Exception("Failed to map file to memory: {}", path.string());
+        }
+        m_data = static_cast<const std::byte*>(data);
+    }
+
+    // the mapping stays valid after the file is closed
+    close(file);
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_data)
+    {
+        munmap(const_cast<std::byte*>(m_data), m_size);
+    }
+}
+
+const std::byte* MappedFile::getData() const
+{
+    return m_data;
+}
+
+size_t MappedFile::getSize() const
+{
+    return m_size;
+}
+}
+#endif
@@ -0,0 +1,75 @@
+#ifdef _WIN32
+
+#include <spectr/utils/MappedFile.h>
+
+#include <spectr/utils/Exception.h>
+
+#define WIN32_LEAN_AND_MEAN 1
+#define NOMINMAX 1
+#include <Windows.h>
+
+namespace spectr::utils
+{
+MappedFile::MappedFile(const std::filesystem::path& path)
+{
+    const HANDLE file = CreateFileW(path.c_str(),
+                                    GENERIC_READ,
+                                    FILE_SHARE_READ | FILE_SHARE_WRITE,
+                                    nullptr,
+                                    OPEN_EXISTING,
+                                    FILE_ATTRIBUTE_NORMAL,
+                                    nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        throw Exception("Failed to open file: {}", path.string());
+    }
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size))
+    {
+        CloseHandle(file);
+        throw Exception("Failed to get size of file: {}", path.string());
+    }
+
+    m_size = static_cast<size_t>(size.QuadPart);
+    if (m_size > 0)
+    {
+        const HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping)
+        {
+            CloseHandle(file);
+            throw Exception("Failed to map file to memory: {}", path.string());
+        }
+
+        // the view keeps the mapping alive after the handles are closed
+        m_data = static_cast<const std::byte*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        CloseHandle(mapping);
+        if (!m_data)
+        {
+            CloseHandle(file);
+            throw Exception("Failed to map file to memory: {}", path.string());
+        }
+    }
+
+    CloseHandle(file);
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_data)
+    {
+        UnmapViewOfFile(m_data);
+    }
+}
+
+const std::byte* MappedFile::getData() const
+{
+    return m_data;
+}
+
+size_t MappedFile::getSize() const
+{
+    return m_size;
+}
+}
+#endif
@@ -0,0 +1,75 @@
+#include <spectr/utils/DecibelQuantizer.h>
+
+#include <spectr/utils/Exception.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace spectr::utils::test
+{
+namespace
+{
+constexpr float MinDecibels = -40.0f;
+constexpr float MaxDecibels = 80.0f;
+
+std::vector<float> roundTrip(const DecibelQuantizer& quantizer, const std::vector<float>& values)
+{
+    std::vector<std::byte> encoded(values.size() * getValueSize(quantizer.getFormat()));
+    quantizer.encode(values.data(), values.size(), encoded.data());
+
+    std::vector<float> decoded(values.size());
+    quantizer.decode(encoded.data(), values.size(), decoded.data());
+    return decoded;
+}
+}
+
+TEST(DecibelQuantizer, KeepsFloatValues)
+{
+    const std::vector<float> values{ 0.0f, 1e-30f, 0.5f, 1e9f };
+    EXPECT_EQ(roundTrip(DecibelQuantizer{}, values), values);
+}
+
+TEST(DecibelQuantizer, RoundTripsWithinHalfCode)
+{
+    for (const auto format : { ValueFormat::Decibel8, ValueFormat::Decibel16 })
+    {
+        const auto maxCode = format == ValueFormat::Decibel8 ? UINT8_MAX : UINT16_MAX;
+        const auto decibelsPerCode = (MaxDecibels - MinDecibels) / maxCode;
+        const DecibelQuantizer quantizer{ format, MinDecibels, MaxDecibels };
+
+        std::vector<float> values;
+        for (auto decibels = MinDecibels; decibels <= MaxDecibels; decibels += 3.7f)
+        {
+            values.push_back(std::pow(10.0f, decibels / 20.0f));
+        }
+
+        const auto decoded = roundTrip(quantizer, values);
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            const auto error = std::abs(20.0f * std::log10(decoded[i] / values[i]));
+            EXPECT_LE(error, decibelsPerCode / 2.0f + 1e-3f) << "value " << values[i];
+        }
+    }
+}
+
+TEST(DecibelQuantizer, ClampsToRange)
+{
+    const DecibelQuantizer quantizer{ ValueFormat::Decibel16, MinDecibels, MaxDecibels };
+
+    const auto minMagnitude = std::pow(10.0f, MinDecibels / 20.0f);
+    const auto maxMagnitude = std::pow(10.0f, MaxDecibels / 20.0f);
+    const auto decoded = roundTrip(quantizer, { 0.0f, minMagnitude / 10.0f, maxMagnitude * 10.0f });
+    EXPECT_FLOAT_EQ(decoded[0], minMagnitude);
+    EXPECT_FLOAT_EQ(decoded[1], minMagnitude);
+    EXPECT_NEAR(decoded[2], maxMagnitude, maxMagnitude * 1e-4f);
+}
+
+TEST(DecibelQuantizer, RejectsEmptyRange)
+{
+    EXPECT_THROW(DecibelQuantizer(ValueFormat::Decibel8, 10.0f, 10.0f), Exception);
+    EXPECT_NO_THROW(DecibelQuantizer(ValueFormat::Float32, 10.0f, 10.0f));
+}
+}
@@ -0,0 +1,106 @@
+#include <spectr/utils/FrameRing.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <thread>
+
+namespace spectr::utils::test
+{
+TEST(FrameRing, ReusesSlotsInOrder)
+{
+    FrameRing ring{ 2, 3 };
+    EXPECT_EQ(ring.front(), nullptr);
+
+    auto first = ring.tryClaim();
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(first->values) % FrameRing::Alignment, 0);
+    EXPECT_EQ(ring.tryClaim(), first); // not published yet
+    first->frameIndex = 10;
+    ring.publish();
+
+    auto second = ring.tryClaim();
+    ASSERT_NE(second, nullptr);
+    EXPECT_NE(second->values, first->values);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(second->values) % FrameRing::Alignment, 0);
+    second->frameIndex = 11;
+    ring.publish();
+
+    EXPECT_EQ(ring.tryClaim(), nullptr); // full
+
+    ASSERT_NE(ring.front(1), nullptr);
+    EXPECT_EQ(ring.front(0)->frameIndex, 10);
+    EXPECT_EQ(ring.front(1)->frameIndex, 11);
+    EXPECT_EQ(ring.front(2), nullptr);
+
+    ring.release();
+    EXPECT_EQ(ring.tryClaim(), first); // the released slot is reused
+    EXPECT_EQ(ring.front()->frameIndex, 11);
+    ring.release();
+    EXPECT_EQ(ring.front(), nullptr);
+}
+
+TEST(FrameRing, PassesSharedValues)
+{
+    const float values[] = { 1.0f, 2.0f, 3.0f };
+    FrameRing ring{ 2, 0 };
+
+    auto slot = ring.tryClaim();
+    ASSERT_NE(slot, nullptr);
+    EXPECT_EQ(slot->values, nullptr);
+    slot->sharedValues = values + 1;
+    ring.publish();
+
+    ASSERT_NE(ring.front(), nullptr);
+    EXPECT_EQ(ring.front()->sharedValues[0], 2.0f);
+    ring.release();
+}
+
+TEST(FrameRing, PassesFramesBetweenThreads)
+{
+    constexpr size_t FrameCount = 10000;
+    constexpr size_t FrameValueCount = 5;
+    FrameRing ring{ 4, FrameValueCount };
+
+    // a failed check stops the consumer, the destructor then stops and joins the producer
+    std::jthread producer{ [&ring](std::stop_token stopToken)
+                           {
+                               for (size_t frameIndex = 0;
+                                    frameIndex < FrameCount && !stopToken.stop_requested();)
+                               {
+                                   auto slot = ring.tryClaim();
+                                   if (!slot)
+                                   {
+                                       std::this_thread::yield();
+                                       continue;
+                                   }
+
+                                   slot->frameIndex = frameIndex;
+                                   for (size_t i = 0; i < FrameValueCount; ++i)
+                                   {
+                                       slot->values[i] = static_cast<float>(frameIndex + i);
+                                   }
+                                   ring.publish();
+                                   ++frameIndex;
+                               }
+                           } };
+
+    for (size_t frameIndex = 0; frameIndex < FrameCount && !HasFailure();)
+    {
+        auto slot = ring.front();
+        if (!slot)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        EXPECT_EQ(slot->frameIndex, frameIndex);
+        for (size_t i = 0; i < FrameValueCount; ++i)
+        {
+            EXPECT_EQ(slot->values[i], static_cast<float>(frameIndex + i));
+        }
+        ring.release();
+        ++frameIndex;
+    }
+}
+}